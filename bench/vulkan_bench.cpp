@@ -0,0 +1,525 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "app_options.hpp"
+#include "application.hpp"
+#include "build_config.hpp"
+
+// Cenários fixos de medição do renderizador, exportados em JSON (ver README)
+//
+// Cada cenário executa a aplicação inteira (inicialização, laço e encerramento) com opções e roteiro fixos: sem validação,
+// apresentação IMMEDIATE, câmera com passo fixo por quadro e nenhuma opção lida do ambiente além das repassadas na linha
+// de comando. Os primeiros quadros de cada execução são descartados das estatísticas.
+
+const char *DEFAULT_OUTPUT = "vulkan_bench.json";
+const uint32_t SCHEMA_VERSION = 1;
+
+const float FIXED_TIMESTEP = 1.0f / 60.0f;
+const uint32_t WARMUP_FRAMES = 60;
+const uint32_t MEASURED_FRAMES = 300;
+
+const uint32_t STARTUP_RUNS = 5;
+const uint32_t FILL_RATE_WIDTH = 3840;
+const uint32_t FILL_RATE_HEIGHT = 2160;
+const uint32_t FILL_RATE_LAYERS = 8; // Camadas de tela cheia desenhadas por quadro
+const std::vector<uint32_t> DRAW_CALL_INSTANCE_COUNTS = {1, 10, 100, 1000, 10000, 100000};
+const uint64_t UPLOAD_BYTES_PER_FRAME = 16ull * 1024 * 1024;
+const uint32_t SWAP_CHAIN_RECREATE_FRAMES = 100;
+
+const std::vector<std::string> ALL_SCENARIOS = {"startup", "fill-rate", "draw-calls", "upload", "swapchain-recreate"};
+
+struct BenchOptions
+{
+    std::string outputPath = DEFAULT_OUTPUT;
+    bool windowed = false;
+    std::vector<std::string> scenarios = ALL_SCENARIOS;
+    // Demais argumentos, lidos por parseAppOptions (por exemplo --device-uuid e --render-pass)
+    std::vector<std::string> appArguments;
+    bool showHelp = false;
+};
+
+// Resultado de uma variante de um cenário
+struct BenchResult
+{
+    std::string scenario;
+    std::string variant;
+    std::string status = "ok"; // ok, skipped ou failed
+    std::string error;
+    std::vector<std::pair<std::string, double>> parameters;
+    std::vector<std::pair<std::string, double>> metrics;
+};
+
+static std::vector<std::string> splitList(const std::string &text)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+static BenchOptions parseBenchOptions(int argc, char **argv)
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0)
+        {
+            options.showHelp = true;
+        }
+        else if (std::strcmp(argv[i], "--windowed") == 0)
+        {
+            options.windowed = true;
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 || std::strcmp(argv[i], "--scenarios") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error(std::string("missing value for ") + argv[i]);
+            }
+            if (std::strcmp(argv[i], "--output") == 0)
+            {
+                options.outputPath = argv[++i];
+                continue;
+            }
+            options.scenarios = splitList(argv[++i]);
+            for (const auto &scenario : options.scenarios)
+            {
+                if (std::find(ALL_SCENARIOS.begin(), ALL_SCENARIOS.end(), scenario) == ALL_SCENARIOS.end())
+                {
+                    throw std::runtime_error("unknown scenario: " + scenario);
+                }
+            }
+        }
+        else
+        {
+            options.appArguments.push_back(argv[i]);
+        }
+    }
+    return options;
+}
+
+static void printBenchUsage(const char *programName)
+{
+    std::cout << "usage: " << programName << " [options] [renderer options]\n"
+              << "  --output <file>        JSON results file (default: " << DEFAULT_OUTPUT << ")\n"
+              << "  --windowed             run in a window (default: headless); required by swapchain-recreate\n"
+              << "  --scenarios <list>     comma separated, default all: startup, fill-rate, draw-calls, upload,\n"
+              << "                         swapchain-recreate\n"
+              << "  -h, --help             show this message\n"
+              << "Renderer options such as --device-uuid and --render-pass are passed through.\n";
+}
+
+// Percentil p (0-100) pelo posto mais próximo; 0 se vazio
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t rank = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(rank, values.size() - 1)];
+}
+
+static std::vector<double> measuredFrames(const RunReport &report)
+{
+    if (report.frameMilliseconds.size() <= WARMUP_FRAMES)
+    {
+        return {};
+    }
+    return std::vector<double>(report.frameMilliseconds.begin() + WARMUP_FRAMES, report.frameMilliseconds.end());
+}
+
+// Devolve os quadros por segundo
+static double addFrameMetrics(BenchResult &result, const RunReport &report)
+{
+    std::vector<double> frames = measuredFrames(report);
+    double total = 0.0;
+    for (double frame : frames)
+    {
+        total += frame;
+    }
+    double framesPerSecond = total > 0.0 ? frames.size() * 1000.0 / total : 0.0;
+    result.metrics.push_back({"frames", static_cast<double>(frames.size())});
+    result.metrics.push_back({"frames_per_second", framesPerSecond});
+    result.metrics.push_back({"frame_ms_p50", percentile(frames, 50.0)});
+    result.metrics.push_back({"frame_ms_p95", percentile(frames, 95.0)});
+    result.metrics.push_back({"frame_ms_p99", percentile(frames, 99.0)});
+    return framesPerSecond;
+}
+
+class Bench
+{
+public:
+    explicit Bench(const BenchOptions &options) : options(options)
+    {
+        std::vector<char *> argv = {const_cast<char *>("vulkan_bench")};
+        for (const auto &argument : options.appArguments)
+        {
+            argv.push_back(const_cast<char *>(argument.c_str()));
+        }
+        // Sem as variáveis VKT_*: só os argumentos repassados mudam os padrões
+        baseOptions = parseAppOptions(static_cast<int>(argv.size()), argv.data(), false);
+
+        // O que muda o trabalho ou o ritmo dos quadros é fixado pelo cenário
+        baseOptions.headless = HeadlessPolicy::use(!options.windowed);
+        baseOptions.validation = ValidationOptions{};
+        baseOptions.presentPolicy = PresentPolicy::Immediate;
+        baseOptions.windowCount = 1;
+        baseOptions.shaderHotReload = false;
+        baseOptions.assetPackPath.clear();
+        baseOptions.tracePath.clear();
+        baseOptions.cpuDraws = false;
+        baseOptions.instanceCount = 1;
+        baseOptions.frameCount = WARMUP_FRAMES + MEASURED_FRAMES;
+    }
+
+    void run()
+    {
+        for (const auto &scenario : options.scenarios)
+        {
+            if (scenario == "startup")
+            {
+                runStartup();
+            }
+            else if (scenario == "fill-rate")
+            {
+                runFillRate();
+            }
+            else if (scenario == "draw-calls")
+            {
+                runDrawCalls();
+            }
+            else if (scenario == "upload")
+            {
+                runUpload();
+            }
+            else if (scenario == "swapchain-recreate")
+            {
+                runSwapChainRecreate();
+            }
+        }
+    }
+
+    bool write() const;
+    bool anyFailed() const
+    {
+        return std::any_of(results.begin(), results.end(), [](const BenchResult &result) { return result.status == "failed"; });
+    }
+
+private:
+    BenchOptions options;
+    AppOptions baseOptions;
+    std::vector<BenchResult> results;
+    // Do primeiro cenário executado com sucesso
+    bool hasDevice = false;
+    DeviceIdentity device;
+    std::string rendererPaths;
+
+    static RunScript baseScript()
+    {
+        RunScript script;
+        script.fixedTimestep = FIXED_TIMESTEP;
+        return script;
+    }
+
+    // Executa uma variante; uma falha é registrada e não interrompe os demais cenários
+    bool execute(BenchResult &result, const AppOptions &appOptions, const RunScript &script, RunReport &report)
+    {
+        std::cout << "bench: " << result.scenario << (result.variant.empty() ? "" : " " + result.variant) << std::endl;
+        try
+        {
+            report = runApplication(appOptions, script);
+        }
+        catch (const std::exception &e)
+        {
+            result.status = "failed";
+            result.error = e.what();
+            std::cerr << "bench: " << result.scenario << " failed: " << e.what() << std::endl;
+            return false;
+        }
+        if (!hasDevice)
+        {
+            device = report.device;
+            rendererPaths = report.rendererPaths;
+            hasDevice = true;
+        }
+        return true;
+    }
+
+    // Várias inicializações seguidas; a primeira pode encontrar o cache de pipelines frio
+    void runStartup()
+    {
+        BenchResult result;
+        result.scenario = "startup";
+        result.parameters.push_back({"runs", STARTUP_RUNS});
+
+        AppOptions appOptions = baseOptions;
+        appOptions.frameCount = 1;
+        std::vector<RunReport> reports(STARTUP_RUNS);
+        std::vector<double> totals;
+        for (auto &report : reports)
+        {
+            if (!execute(result, appOptions, baseScript(), report))
+            {
+                results.push_back(result);
+                return;
+            }
+            totals.push_back(report.startupMilliseconds);
+        }
+        result.metrics.push_back({"startup_ms_first", totals.front()});
+        result.metrics.push_back({"startup_ms_min", percentile(totals, 0.0)});
+        result.metrics.push_back({"startup_ms_p50", percentile(totals, 50.0)});
+        result.metrics.push_back({"startup_ms_max", percentile(totals, 100.0)});
+        // As etapas da execução mediana
+        const RunReport &median = *std::find_if(reports.begin(), reports.end(), [&](const RunReport &report)
+                                                { return report.startupMilliseconds == percentile(totals, 50.0); });
+        for (const auto &stage : median.startupStages)
+        {
+            result.metrics.push_back({"stage_ms." + stage.name, stage.durationMilliseconds});
+        }
+        results.push_back(result);
+    }
+
+    // Camadas do triângulo que cobrem o alvo 4K inteiro, sobrepostas: os pixels sombreados por segundo
+    void runFillRate()
+    {
+        BenchResult result;
+        result.scenario = "fill-rate";
+        result.parameters.push_back({"width", FILL_RATE_WIDTH});
+        result.parameters.push_back({"height", FILL_RATE_HEIGHT});
+        result.parameters.push_back({"layers", FILL_RATE_LAYERS});
+
+        AppOptions appOptions = baseOptions;
+        appOptions.instanceCount = FILL_RATE_LAYERS;
+        RunScript script = baseScript();
+        script.width = FILL_RATE_WIDTH;
+        script.height = FILL_RATE_HEIGHT;
+        script.fullScreenInstances = true;
+        RunReport report;
+        if (execute(result, appOptions, script, report))
+        {
+            double framesPerSecond = addFrameMetrics(result, report);
+            result.metrics.push_back({"megapixels_per_second",
+                                      framesPerSecond * FILL_RATE_LAYERS * FILL_RATE_WIDTH * FILL_RATE_HEIGHT / 1.0e6});
+        }
+        results.push_back(result);
+    }
+
+    // Número de instâncias (um desenho cada) de 1 a 100k, nos caminhos de desenho compilados
+    void runDrawCalls()
+    {
+        std::vector<std::pair<std::string, bool>> paths;
+        if (BuildConfig::gpuDrivenDraws)
+        {
+            paths.push_back({"gpu-driven", false});
+        }
+        if (BuildConfig::cpuDraws)
+        {
+            paths.push_back({"cpu", true});
+        }
+
+        for (const auto &[path, cpuDraws] : paths)
+        {
+            for (uint32_t instances : DRAW_CALL_INSTANCE_COUNTS)
+            {
+                BenchResult result;
+                result.scenario = "draw-calls";
+                result.variant = path + "/" + std::to_string(instances);
+                result.parameters.push_back({"instances", instances});
+
+                AppOptions appOptions = baseOptions;
+                appOptions.instanceCount = instances;
+                appOptions.cpuDraws = cpuDraws;
+                RunReport report;
+                if (execute(result, appOptions, baseScript(), report))
+                {
+                    addFrameMetrics(result, report);
+                    // Sem a seleção na GPU (dispositivo sem suporte) o caminho gpu-driven também desenha pela CPU
+                    result.metrics.push_back({"gpu_driven", report.gpuDrivenDraws ? 1.0 : 0.0});
+                }
+                results.push_back(result);
+            }
+        }
+    }
+
+    // Cópias para a memória local ao dispositivo pelo anel de staging, que a submissão de cada quadro espera
+    void runUpload()
+    {
+        BenchResult result;
+        result.scenario = "upload";
+        result.parameters.push_back({"bytes_per_frame", static_cast<double>(UPLOAD_BYTES_PER_FRAME)});
+
+        RunScript script = baseScript();
+        script.uploadBytesPerFrame = UPLOAD_BYTES_PER_FRAME;
+        RunReport report;
+        if (execute(result, baseOptions, script, report))
+        {
+            addFrameMetrics(result, report);
+            result.metrics.push_back({"uploaded_bytes", static_cast<double>(report.uploadedBytes)});
+            result.metrics.push_back({"upload_gib_per_second",
+                                      report.loopSeconds > 0.0
+                                          ? report.uploadedBytes / report.loopSeconds / (1024.0 * 1024.0 * 1024.0)
+                                          : 0.0});
+        }
+        results.push_back(result);
+    }
+
+    // Recriação da cadeia de troca depois de cada apresentação (só com janela)
+    void runSwapChainRecreate()
+    {
+        BenchResult result;
+        result.scenario = "swapchain-recreate";
+        result.parameters.push_back({"frames", SWAP_CHAIN_RECREATE_FRAMES});
+        if (!options.windowed)
+        {
+            result.status = "skipped";
+            result.error = "needs --windowed";
+            results.push_back(result);
+            return;
+        }
+
+        AppOptions appOptions = baseOptions;
+        appOptions.frameCount = SWAP_CHAIN_RECREATE_FRAMES;
+        RunScript script = baseScript();
+        script.recreateSwapChainEveryFrame = true;
+        RunReport report;
+        if (execute(result, appOptions, script, report))
+        {
+            const auto &recreates = report.swapChainRecreateMilliseconds;
+            result.metrics.push_back({"recreates", static_cast<double>(recreates.size())});
+            result.metrics.push_back({"recreate_ms_p50", percentile(recreates, 50.0)});
+            result.metrics.push_back({"recreate_ms_p95", percentile(recreates, 95.0)});
+            result.metrics.push_back({"recreate_ms_max", percentile(recreates, 100.0)});
+        }
+        results.push_back(result);
+    }
+};
+
+static std::string jsonString(const std::string &text)
+{
+    std::string escaped = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+    return escaped + "\"";
+}
+
+static void writeNumbers(std::ostream &out, const std::vector<std::pair<std::string, double>> &values)
+{
+    out << "{";
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        out << (i == 0 ? "" : ", ") << jsonString(values[i].first) << ": " << values[i].second;
+    }
+    out << "}";
+}
+
+bool Bench::write() const
+{
+    std::ofstream file(options.outputPath, std::ios::trunc);
+    if (!file)
+    {
+        std::cerr << "bench: failed to write " << options.outputPath << std::endl;
+        return false;
+    }
+
+    file << std::setprecision(6);
+    file << "{\n  \"schema\": " << SCHEMA_VERSION << ",\n";
+    file << "  \"mode\": " << jsonString(options.windowed ? "windowed" : "headless") << ",\n";
+    file << "  \"build\": {\"feature_tier\": " << static_cast<uint32_t>(BuildConfig::featureTier)
+         << ", \"cull_workgroup_size\": " << BuildConfig::cullWorkgroupSize << ", \"debug\": "
+#ifdef NDEBUG
+         << "false"
+#else
+         << "true"
+#endif
+         << "},\n";
+    file << "  \"device\": {\"name\": " << jsonString(device.name) << ", \"uuid\": " << jsonString(device.uuid)
+         << ", \"type\": " << jsonString(device.type) << ", \"vendor_id\": " << device.vendorId
+         << ", \"device_id\": " << device.deviceId << ", \"driver_version\": " << device.driverVersion
+         << ", \"api_version\": " << jsonString(std::to_string((device.apiVersion >> 22) & 0x7f) + "." +
+                                               std::to_string((device.apiVersion >> 12) & 0x3ff) + "." +
+                                               std::to_string(device.apiVersion & 0xfff))
+         << ", \"renderer_paths\": " << jsonString(rendererPaths) << "},\n";
+    file << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult &result = results[i];
+        file << (i == 0 ? "\n" : ",\n") << "    {\"scenario\": " << jsonString(result.scenario)
+             << ", \"variant\": " << jsonString(result.variant) << ", \"status\": " << jsonString(result.status);
+        if (!result.error.empty())
+        {
+            file << ", \"error\": " << jsonString(result.error);
+        }
+        file << ",\n     \"parameters\": ";
+        writeNumbers(file, result.parameters);
+        file << ",\n     \"metrics\": ";
+        writeNumbers(file, result.metrics);
+        file << "}";
+    }
+    file << "\n  ]\n}\n";
+
+    std::cout << "bench: wrote " << results.size() << " results to " << options.outputPath << std::endl;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        BenchOptions options = parseBenchOptions(argc, argv);
+        if (options.showHelp)
+        {
+            printBenchUsage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+
+        Bench bench(options);
+        bench.run();
+        if (!bench.write() || bench.anyFailed())
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
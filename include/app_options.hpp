@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+
+#include "present_policy.hpp"
+#include "surface_format.hpp"
+
+// Camadas de validação, ativáveis em qualquer build
+// Lista separada por vírgulas: off, on, gpu (validação assistida pela GPU), best (boas práticas),
+// sync (sincronização), verbose (inclui mensagens informativas); gpu, best, sync e verbose implicam on
+struct ValidationOptions
+{
+    bool enabled = false; // Padrão: ligado em builds de debug (sem NDEBUG)
+    bool gpuAssisted = false;
+    bool bestPractices = false;
+    bool synchronization = false;
+    bool verbose = false;
+
+    // Alguma das features de VK_EXT_validation_features foi pedida
+    bool needsValidationFeatures() const { return gpuAssisted || bestPractices || synchronization; }
+};
+
+// Opções da aplicação lidas da linha de comando e de variáveis de ambiente
+// A linha de comando tem prioridade sobre o ambiente
+struct AppOptions
+{
+    // UUID do dispositivo físico a ser usado (32 dígitos hexadecimais, minúsculos, sem separadores)
+    // Vazio escolhe o dispositivo automaticamente pela pontuação
+    // Ambiente: VKT_DEVICE_UUID | Linha de comando: --device-uuid <uuid>
+    std::string deviceUuid;
+
+    // Arquivo onde os escopos de CPU e GPU são gravados no formato Chrome trace (vazio não grava)
+    // Ambiente: VKT_TRACE | Linha de comando: --trace <arquivo>
+    std::string tracePath;
+
+    // Política de apresentação inicial; pode ser alternada em tempo de execução com a tecla P
+    // Ambiente: VKT_PRESENT_MODE | Linha de comando: --present-mode <immediate|mailbox|fifo|fifo-relaxed>
+    PresentPolicy presentPolicy = PresentPolicy::Mailbox;
+
+    // Ordem de preferência dos formatos da superfície (ver SurfaceFormatPolicy); sdr8 é o modo de menor banda
+    // Ambiente: VKT_SURFACE_FORMAT | Linha de comando: --surface-format <auto|sdr8|sdr10|hdr10|scrgb>
+    SurfaceFormatPolicy surfaceFormatPolicy = SurfaceFormatPolicy::Auto;
+
+    // Renderiza em imagens fora da tela, sem janela nem cadeia de troca (servidores sem monitor e medições de vazão)
+    // Ambiente: VKT_HEADLESS=1 | Linha de comando: --headless
+    bool headless = false;
+
+    // Número de quadros a renderizar antes de encerrar; 0 é ilimitado na janela e HEADLESS_DEFAULT_FRAMES sem janela
+    // Linha de comando: --frames <n>
+    uint32_t frameCount = 0;
+
+    // Ambiente: VKT_VALIDATION | Linha de comando: --validation <lista>
+    ValidationOptions validation;
+
+    // Número de instâncias da cena, dispostas em grade
+    // Linha de comando: --instances <n>
+    uint32_t instanceCount = 1024;
+
+    // Número de janelas, todas desenhadas pelo mesmo dispositivo e apresentadas juntas; ignorado sem janela
+    // Linha de comando: --windows <n>
+    uint32_t windowCount = 1;
+
+    // Grava um desenho por instância na CPU mesmo quando o dispositivo suporta a seleção na GPU (comparação)
+    // Linha de comando: --cpu-draws
+    bool cpuDraws = false;
+
+    // Usa VkRenderPass e VkFramebuffer mesmo quando o dispositivo suporta renderização dinâmica (comparação)
+    // Linha de comando: --render-pass
+    bool renderPassObjects = false;
+
+    // Desenha a cena em ponto flutuante e a leva à cadeia de troca por um compute shader (mapeamento de tons, FXAA e
+    // ampliação) que escreve direto nas imagens; sem suporte, desenha direto nelas como sem a opção
+    // Linha de comando: --compute-post
+    bool computePost = false;
+
+    // Quadros por segundo que a resolução dinâmica tenta manter: a cena é desenhada com a escala que deixa o tempo de GPU
+    // dentro do orçamento e ampliada pelo pós-processamento (implica --compute-post); 0 desliga
+    // Linha de comando: --dynamic-resolution <fps>
+    uint32_t dynamicResolutionFps = 0;
+
+    // Menor escala da resolução dinâmica, em porcentagem de cada lado da imagem final
+    // Linha de comando: --min-render-scale <porcentagem>
+    uint32_t minRenderScalePercent = 50;
+
+    // Observa os fontes dos shaders, recompila os alterados e troca os pipelines sem reiniciar a aplicação
+    // Linha de comando: --shader-hot-reload
+    bool shaderHotReload = false;
+
+    // Contêiner de assets (.vkpack) cujas malhas e texturas são adicionadas à cena
+    // Linha de comando: --assets <arquivo>
+    std::string assetPackPath;
+
+    // Limite de memória de dispositivo, em MiB, para os mips das texturas do contêiner; 0 usa o orçamento do heap
+    // Linha de comando: --streaming-budget <MiB>
+    uint32_t streamingBudgetMiB = 0;
+
+    // Limite, em MiB, da memória do host que o driver pode alocar pelo HostAllocator; 0 não limita
+    // Linha de comando: --host-memory-limit <MiB>
+    uint32_t hostMemoryLimitMiB = 0;
+
+    // Não instala os VkAllocationCallbacks: o driver usa o próprio alocador (comparação)
+    // Linha de comando: --driver-allocator
+    bool driverAllocator = false;
+
+    // Threads de trabalho do JobSystem (gravação paralela, streaming de texturas, inicialização); 0 usa uma por núcleo
+    // livre
+    // Linha de comando: --job-threads <n>
+    uint32_t jobThreads = 0;
+
+    // --help: imprime o uso e encerra
+    bool showHelp = false;
+};
+
+// Lê as opções; lança std::runtime_error para argumentos inválidos
+// Sem readEnvironment as variáveis VKT_* são ignoradas e só a linha de comando muda os padrões
+AppOptions parseAppOptions(int argc, char **argv, bool readEnvironment = true);
+
+// Imprime a lista de opções suportadas
+void printAppUsage(const char *programName);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "app_options.hpp"
+#include "startup_timer.hpp"
+
+// Trabalho extra roteirizado por quem executa a aplicação (vulkan_bench); os padrões não mudam nada
+struct RunScript
+{
+    // Tamanho da janela ou das imagens fora da tela; 0 usa o padrão
+    uint32_t width = 0;
+    uint32_t height = 0;
+    // Avanço da câmera por quadro, em segundos; 0 segue o relógio. Com um passo fixo, cada quadro de uma execução
+    // desenha a mesma cena em qualquer máquina
+    float fixedTimestep = 0.0f;
+    // Bytes enviados por quadro pelo anel de staging para um buffer local ao dispositivo
+    uint64_t uploadBytesPerFrame = 0;
+    // Recria as cadeias de troca depois de cada apresentação
+    bool recreateSwapChainEveryFrame = false;
+    // Empilha todas as instâncias (--instances) no centro, ampliadas para cobrir o alvo inteiro diante de uma câmera fixa:
+    // cada uma é uma camada que preenche a tela (o cenário fill-rate)
+    bool fullScreenInstances = false;
+};
+
+// Identidade do dispositivo físico escolhido (VkPhysicalDeviceProperties)
+struct DeviceIdentity
+{
+    std::string name;
+    std::string uuid;
+    std::string type; // discrete, integrated, virtual, cpu ou other
+    uint32_t vendorId = 0;
+    uint32_t deviceId = 0;
+    uint32_t driverVersion = 0; // Codificação do fabricante
+    uint32_t apiVersion = 0;
+};
+
+// Medidas de uma execução, da inicialização ao encerramento
+struct RunReport
+{
+    DeviceIdentity device;
+    std::string rendererPaths;
+    bool gpuDrivenDraws = false; // Seleção na GPU e desenhos indiretos de fato usados
+
+    double startupMilliseconds = 0.0; // Da criação da aplicação até o fim de initVulkan
+    std::vector<StartupTimer::Record> startupStages;
+
+    // Intervalo entre os fins de quadros consecutivos na CPU (o primeiro é medido a partir do início do laço)
+    std::vector<double> frameMilliseconds;
+    // Duração do laço inteiro, incluindo a espera pelo último quadro na GPU
+    double loopSeconds = 0.0;
+
+    uint64_t uploadedBytes = 0;
+    std::vector<double> swapChainRecreateMilliseconds;
+};
+
+// Executa a aplicação com as opções e o roteiro até o fim dos quadros (ou o fechamento da janela)
+// Lança std::runtime_error se algo falhar
+RunReport runApplication(const AppOptions &options, const RunScript &script = {});
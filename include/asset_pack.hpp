@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Contêiner binário de assets (.vkpack) com os dados já no formato consumido pela GPU
+//
+// Layout (little-endian; toda seção e todo bloco de dados alinhados a ASSET_PACK_ALIGNMENT):
+//   AssetPackHeader
+//   AssetMeshRecord[meshCount]
+//   AssetTextureRecord[textureCount]
+//   AssetMipRecord[soma de mipLevels]
+//   dados: vértices intercalados e quantizados, índices, mips de texturas comprimidas em blocos (BC7/ASTC)
+//
+// Nada é convertido na carga: os registros descrevem os formatos Vulkan dos dados, e cada faixa é copiada da memória
+// mapeada direto para o anel de staging. A conversão (quantização, geração de mips, compressão) é feita offline por quem
+// escreve o contêiner, com AssetPackWriter.
+const uint32_t ASSET_PACK_MAGIC = 0x4B504B56; // "VKPK"
+const uint32_t ASSET_PACK_VERSION = 1;
+// Blocos BC/ASTC têm 16 bytes; também satisfaz o alinhamento de 4 bytes de bufferOffset nas cópias
+const uint64_t ASSET_PACK_ALIGNMENT = 16;
+const uint32_t ASSET_PACK_MAX_ATTRIBUTES = 4;
+
+struct AssetPackHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t meshCount;
+    uint32_t textureCount;
+    uint64_t meshTableOffset;
+    uint64_t textureTableOffset;
+    uint64_t mipTableOffset;
+    uint64_t fileSize; // Detecta arquivos truncados
+};
+
+struct AssetVertexAttribute
+{
+    uint32_t location;
+    uint32_t format; // VkFormat, por exemplo VK_FORMAT_R16G16_SNORM para posições quantizadas
+    uint32_t offset;
+};
+
+// Malha com um único binding de vértices intercalados
+struct AssetMeshRecord
+{
+    uint32_t vertexStride;
+    uint32_t attributeCount;
+    AssetVertexAttribute attributes[ASSET_PACK_MAX_ATTRIBUTES];
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t indexType;   // VkIndexType
+    float boundingRadius; // Esfera envolvente em torno da origem do modelo
+    uint64_t vertexDataOffset;
+    uint64_t vertexDataSize;
+    uint64_t indexDataOffset;
+    uint64_t indexDataSize;
+};
+
+struct AssetTextureRecord
+{
+    uint32_t format; // VkFormat, normalmente comprimido em blocos
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipLevels;
+    uint32_t firstMip; // Índice do primeiro AssetMipRecord desta textura
+    uint32_t padding;
+};
+
+// Um nível de mip; os dados estão no layout esperado por vkCmdCopyBufferToImage (linhas de blocos compactas)
+struct AssetMipRecord
+{
+    uint32_t width;
+    uint32_t height;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+
+// O layout dos registros faz parte do formato: qualquer mudança exige um novo ASSET_PACK_VERSION
+static_assert(sizeof(AssetPackHeader) == 48, "AssetPackHeader layout changed");
+static_assert(sizeof(AssetMeshRecord) == 104, "AssetMeshRecord layout changed");
+static_assert(sizeof(AssetTextureRecord) == 24, "AssetTextureRecord layout changed");
+static_assert(sizeof(AssetMipRecord) == 24, "AssetMipRecord layout changed");
+
+// Contêiner aberto por mapeamento de memória
+//
+// open só valida o cabeçalho e verifica que todas as faixas estão dentro do arquivo; os dados são lidos pelo sistema de
+// arquivos sob demanda, quando as faixas são copiadas. Os ponteiros devolvidos valem até close.
+class AssetPack
+{
+public:
+    AssetPack() = default;
+    ~AssetPack(); // Chama close
+
+    AssetPack(const AssetPack &) = delete;
+    AssetPack &operator=(const AssetPack &) = delete;
+
+    // Lança std::runtime_error se o arquivo não existir ou não for um contêiner válido desta versão
+    void open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return mapping != nullptr; }
+
+    uint32_t meshCount() const { return header().meshCount; }
+    uint32_t textureCount() const { return header().textureCount; }
+    const AssetMeshRecord &mesh(uint32_t index) const;
+    const AssetTextureRecord &texture(uint32_t index) const;
+    const AssetMipRecord &mip(uint32_t textureIndex, uint32_t level) const;
+
+    // Ponteiro para os dados de uma faixa do arquivo
+    const void *data(uint64_t offset) const { return static_cast<const char *>(mapping) + offset; }
+
+    // Pede ao sistema que comece a ler uma faixa em segundo plano, para que a cópia posterior não espere pelo disco
+    void prefetch(uint64_t offset, uint64_t size) const;
+
+private:
+    void *mapping = nullptr;
+    uint64_t mappedSize = 0;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+
+    const AssetPackHeader &header() const { return *static_cast<const AssetPackHeader *>(mapping); }
+    void validate(const std::string &path) const;
+};
+
+// Escreve contêineres a partir de dados já no formato final (usado pelas ferramentas de conversão offline)
+class AssetPackWriter
+{
+public:
+    // vertexData e indexData são copiados como estão; mesh.*Offset e mesh.*Size são preenchidos pelo escritor
+    void addMesh(const AssetMeshRecord &mesh, const void *vertexData, const void *indexData);
+    // Um bloco de dados por nível de mip, do maior para o menor
+    void addTexture(VkFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<char>> &mips);
+
+    // Lança std::runtime_error se o arquivo não puder ser escrito
+    void write(const std::string &path) const;
+
+private:
+    std::vector<AssetMeshRecord> meshes;
+    std::vector<AssetTextureRecord> textures;
+    std::vector<AssetMipRecord> mips;
+    std::vector<char> payload; // Dados, com offsets relativos ao início desta seção até write
+
+    uint64_t appendPayload(const void *data, uint64_t size);
+};
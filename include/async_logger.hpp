@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+enum class LogLevel
+{
+    Info,
+    Warning,
+    Error,
+};
+
+// Registro assíncrono para mensagens emitidas em caminhos quentes (callbacks das camadas de validação)
+//
+// log() nunca faz E/S: copia a mensagem para uma fila limitada e retorna. Uma thread própria escreve as mensagens em
+// lote, com um único flush por lote. Mensagens idênticas são registradas uma vez e depois resumidas com a contagem de
+// repetições; acima de messagesPerSecond (ou com a fila cheia) as mensagens são descartadas e o total descartado é
+// informado. Seguro entre threads.
+class AsyncLogger
+{
+public:
+    struct Limits
+    {
+        uint32_t messagesPerSecond = 50;
+        size_t queueCapacity = 1024;
+        size_t maxTrackedMessages = 4096; // Mensagens distintas lembradas para a deduplicação
+    };
+
+    AsyncLogger() = default;
+    ~AsyncLogger(); // Chama stop
+
+    AsyncLogger(const AsyncLogger &) = delete;
+    AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+    void start(std::ostream &output, const Limits &limits);
+    // Escreve as mensagens restantes, os resumos de repetições e encerra a thread
+    void stop();
+
+    void log(LogLevel level, const char *category, const char *message);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        LogLevel level;
+        std::string category;
+        std::string message;
+    };
+
+    // Mensagem já registrada, com as repetições ainda não informadas
+    struct Seen
+    {
+        std::string summary; // Início da mensagem, usado no resumo de repetições
+        uint64_t repeats = 0;
+    };
+
+    std::ostream *output = nullptr;
+    Limits limits;
+    std::thread writer;
+    bool running = false;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Entry> queue;
+    std::unordered_map<size_t, Seen> seen;
+    uint64_t dropped = 0;
+    Clock::time_point windowStart;
+    uint32_t windowCount = 0;
+
+    void writerLoop();
+    void writeEntry(const Entry &entry);
+    void writeSummaries(std::unordered_map<size_t, Seen> &summaries, uint64_t droppedCount);
+};
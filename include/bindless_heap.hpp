@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Índice que o heap nunca devolve; serve como valor inicial de handles ainda não registrados
+const uint32_t INVALID_BINDLESS_INDEX = UINT32_MAX;
+
+// Heap global de descritores (bindless) com VK_EXT_descriptor_indexing (núcleo no Vulkan 1.2)
+//
+// Um único conjunto UPDATE_AFTER_BIND guarda todos os storage buffers (binding 0) e texturas (binding 1) do renderizador.
+// Cada recurso registrado recebe um índice estável nos arrays do shader, que chega ao shader por push constants; o
+// conjunto é vinculado uma vez por buffer de comando e nunca é realocado. Entradas não preenchidas são permitidas
+// (PARTIALLY_BOUND) e entradas livres podem ser escritas enquanto quadros em voo usam as demais.
+//
+// Os registros acumulam as escritas; flushUpdates as aplica com um único vkUpdateDescriptorSets. Um índice removido só
+// pode ser reutilizado depois que a GPU deixar de lê-lo, então remove* deve ser chamado pela DeletionQueue.
+// Seguro entre threads.
+class BindlessHeap
+{
+public:
+    static constexpr uint32_t STORAGE_BUFFER_BINDING = 0;
+    static constexpr uint32_t TEXTURE_BINDING = 1;
+
+    // As capacidades são limitadas pelos limites UPDATE_AFTER_BIND do dispositivo
+    void init(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t maxStorageBuffers, uint32_t maxTextures);
+    void destroy();
+
+    uint32_t addStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+    uint32_t addTexture(VkImageView imageView, VkSampler sampler,
+                        VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    void removeStorageBuffer(uint32_t index);
+    void removeTexture(uint32_t index);
+
+    // Aplica as escritas pendentes; deve ser chamado antes de submeter comandos que usem os índices novos
+    void flushUpdates();
+
+    // Vincula o conjunto como set 0 de layout
+    void bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout layout) const;
+
+    VkDescriptorSetLayout setLayout() const { return descriptorSetLayout; }
+    uint32_t storageBufferCapacity() const { return storageBuffers.capacity; }
+    uint32_t textureCapacity() const { return textures.capacity; }
+
+private:
+    // Índices livres de um binding: nunca usados a partir de next, devolvidos na lista
+    struct Slots
+    {
+        uint32_t capacity = 0;
+        uint32_t next = 0;
+        std::vector<uint32_t> freed;
+
+        uint32_t allocate();
+        void release(uint32_t index);
+    };
+
+    struct PendingBuffer
+    {
+        uint32_t index;
+        VkDescriptorBufferInfo info;
+    };
+
+    struct PendingTexture
+    {
+        uint32_t index;
+        VkDescriptorImageInfo info;
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+    std::mutex mutex;
+    Slots storageBuffers;
+    Slots textures;
+    std::vector<PendingBuffer> pendingBuffers;
+    std::vector<PendingTexture> pendingTextures;
+    std::vector<VkWriteDescriptorSet> writes; // Reaproveitado entre flushes
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+// Configuração do renderizador fixada na compilação (opções do CMake, ver cmakelists.txt)
+//
+// Cada caminho com alternativa (janela ou sem janela, validação, renderização dinâmica ou VkRenderPass, desenhos da GPU
+// ou da CPU) é decidido por uma PathPolicy. Com as duas alternativas compiladas a decisão continua sendo a de execução
+// (opções e recursos do dispositivo); com só uma, ela vira uma constante e o compilador elimina o ramo da outra,
+// inclusive nas funções do laço de quadros. Os padrões compilam tudo.
+
+// 0: só o modo sem janela (--headless fica implícito); a superfície e a cadeia de troca nunca são criadas
+#ifndef VKT_WINDOW_SUPPORT
+#define VKT_WINDOW_SUPPORT 1
+#endif
+// 0: as camadas de validação e o mensageiro de debug nunca são habilitados (--validation é ignorado)
+#ifndef VKT_VALIDATION_SUPPORT
+#define VKT_VALIDATION_SUPPORT 1
+#endif
+// Caminhos do renderizador compilados (FeatureTier)
+#ifndef VKT_FEATURE_TIER
+#define VKT_FEATURE_TIER 0
+#endif
+// local_size_x de cull.comp, passado ao shader como constante de especialização
+#ifndef VKT_CULL_WORKGROUP_SIZE
+#define VKT_CULL_WORKGROUP_SIZE 64
+#endif
+
+enum class FeatureTier : uint32_t
+{
+    Auto = 0,     // Todos os caminhos; escolhidos pelos recursos do dispositivo
+    Baseline = 1, // Só VkRenderPass e um desenho por instância gravado na CPU
+    Modern = 2,   // Só renderização dinâmica e desenhos gerados pela GPU; dispositivos sem eles não são adequados
+};
+
+struct BuildConfig
+{
+    static constexpr bool windowSupport = VKT_WINDOW_SUPPORT != 0;
+    static constexpr bool validationSupport = VKT_VALIDATION_SUPPORT != 0;
+    static constexpr FeatureTier featureTier = static_cast<FeatureTier>(VKT_FEATURE_TIER);
+
+    // Caminhos compilados em cada nível
+    static constexpr bool dynamicRendering = featureTier != FeatureTier::Baseline;
+    static constexpr bool renderPassObjects = featureTier != FeatureTier::Modern;
+    static constexpr bool gpuDrivenDraws = featureTier != FeatureTier::Baseline;
+    static constexpr bool cpuDraws = featureTier != FeatureTier::Modern;
+
+    static constexpr uint32_t cullWorkgroupSize = VKT_CULL_WORKGROUP_SIZE;
+};
+
+static_assert(VKT_FEATURE_TIER >= 0 && VKT_FEATURE_TIER <= 2, "VKT_FEATURE_TIER must be 0 (auto), 1 (baseline) or 2 (modern)");
+static_assert(BuildConfig::cullWorkgroupSize > 0 && BuildConfig::cullWorkgroupSize <= 1024,
+              "VKT_CULL_WORKGROUP_SIZE must be between 1 and 1024");
+
+// Escolha entre um caminho (Path) e a sua alternativa (Fallback), conforme o que foi compilado
+template <bool Path, bool Fallback>
+struct PathPolicy
+{
+    static_assert(Path || Fallback, "at least one of the alternatives must be compiled");
+
+    // Verdadeiro se o caminho deve ser usado; runtime só é consultado quando as duas alternativas existem
+    static constexpr bool use(bool runtime)
+    {
+        if constexpr (!Path)
+        {
+            return false;
+        }
+        else if constexpr (!Fallback)
+        {
+            return true;
+        }
+        else
+        {
+            return runtime;
+        }
+    }
+};
+
+// Sem janela, com a janela como alternativa
+using HeadlessPolicy = PathPolicy<true, BuildConfig::windowSupport>;
+// Validação, sem alternativa a compilar (desligada é sempre possível)
+using ValidationPolicy = PathPolicy<BuildConfig::validationSupport, true>;
+// vkCmdBeginRendering, com VkRenderPass e VkFramebuffer como alternativa
+using DynamicRenderingPolicy = PathPolicy<BuildConfig::dynamicRendering, BuildConfig::renderPassObjects>;
+// Seleção na GPU e desenhos indiretos, com um desenho por instância gravado na CPU como alternativa
+using GpuDrivenPolicy = PathPolicy<BuildConfig::gpuDrivenDraws, BuildConfig::cpuDraws>;
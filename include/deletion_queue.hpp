@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "queue_timeline.hpp"
+
+// Destruição adiada de objetos que ainda podem estar em uso pela GPU
+//
+// Cada destruição fica associada a um ponto de uma linha do tempo (normalmente timeline.lastSubmitted() no momento em que
+// o objeto deixou de ser usado) e só é executada depois que o contador daquela fila alcançá-lo. Não é seguro entre threads.
+class DeletionQueue
+{
+public:
+    void defer(QueueTimeline &timeline, uint64_t value, std::function<void()> destroy);
+
+    // Executa as destruições cujos pontos já foram alcançados; não bloqueia
+    void collect();
+    // Executa todas as destruições restantes (o chamador deve garantir que o dispositivo está ocioso)
+    void flush();
+
+private:
+    struct Entry
+    {
+        QueueTimeline *timeline;
+        uint64_t value;
+        std::function<void()> destroy;
+    };
+
+    std::vector<Entry> entries;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+
+// Recursos opcionais do dispositivo que o renderizador sabe aproveitar
+//
+// Consultados pelas estruturas de features do núcleo (VkPhysicalDeviceVulkan11/12/13Features), sempre limitados à versão
+// negociada: a menor entre a versão da instância e a do dispositivo. Estruturas de uma versão acima da negociada não são
+// consultadas nem habilitadas, então os recursos correspondentes ficam desligados.
+struct DeviceCapabilities
+{
+    uint32_t apiVersion = VK_API_VERSION_1_0; // Versão negociada
+
+    // Vulkan 1.0
+    bool multiDrawIndirect = false;
+    bool drawIndirectFirstInstance = false;
+    bool samplerAnisotropy = false;
+    bool textureCompressionBC = false;
+    bool textureCompressionASTC_LDR = false;
+    bool shaderStorageImageWriteWithoutFormat = false;
+
+    // Vulkan 1.1
+    bool shaderDrawParameters = false;
+
+    // Vulkan 1.2
+    bool timelineSemaphore = false;
+    bool bufferDeviceAddress = false;
+    bool hostQueryReset = false;
+    bool drawIndirectCount = false;
+    bool descriptorIndexing = false;
+    bool runtimeDescriptorArray = false;
+    bool descriptorBindingPartiallyBound = false;
+    bool descriptorBindingVariableDescriptorCount = false;
+    bool descriptorBindingSampledImageUpdateAfterBind = false;
+    bool descriptorBindingStorageBufferUpdateAfterBind = false;
+    bool descriptorBindingUpdateUnusedWhilePending = false;
+    bool shaderSampledImageArrayNonUniformIndexing = false;
+
+    // Vulkan 1.3
+    bool dynamicRendering = false;
+    bool synchronization2 = false;
+
+    static DeviceCapabilities query(VkPhysicalDevice physicalDevice, uint32_t instanceApiVersion);
+
+    // Recursos de indexação de descritores exigidos pelo heap bindless (BindlessHeap)
+    bool supportsBindless() const;
+
+    // Lista curta dos recursos suportados, para o registro de inicialização
+    std::string describe() const;
+};
+
+// Cadeia VkPhysicalDeviceFeatures2 -> Vulkan11 -> Vulkan12 -> Vulkan13 com os recursos de DeviceCapabilities habilitados
+//
+// Usada em VkDeviceCreateInfo::pNext (com pEnabledFeatures nulo). A cadeia aponta para os próprios membros, então o objeto
+// não pode ser copiado nem movido e deve viver até vkCreateDevice.
+class DeviceFeatureChain
+{
+public:
+    explicit DeviceFeatureChain(const DeviceCapabilities &capabilities);
+
+    DeviceFeatureChain(const DeviceFeatureChain &) = delete;
+    DeviceFeatureChain &operator=(const DeviceFeatureChain &) = delete;
+
+    // Acrescenta ao fim da cadeia uma estrutura (ou uma cadeia já montada) de features de extensão
+    void append(void *structure);
+
+    const void *head() const { return &features2; }
+
+private:
+    VkPhysicalDeviceFeatures2 features2{};
+    VkPhysicalDeviceVulkan11Features vulkan11{};
+    VkPhysicalDeviceVulkan12Features vulkan12{};
+    VkPhysicalDeviceVulkan13Features vulkan13{};
+    void **tail; // pNext da última estrutura da cadeia
+};
+
+// Caminhos do renderizador escolhidos a partir dos recursos do dispositivo
+struct RendererPaths
+{
+    bool dynamicRendering = false;   // vkCmdBeginRendering, sem VkRenderPass nem VkFramebuffer
+    bool synchronization2 = false;   // vkCmdPipelineBarrier2 e vkQueueSubmit2
+    bool gpuDriven = false;          // Desenho indireto com contagem gerada pela GPU
+
+    // Só escolhe caminhos compilados (BuildConfig)
+    static RendererPaths select(const DeviceCapabilities &capabilities);
+
+    // Falso se faltar ao dispositivo um caminho que a compilação não tem como substituir (VKT_FEATURE_TIER=2)
+    bool coversBuild() const;
+
+    std::string describe() const;
+};
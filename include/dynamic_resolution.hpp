@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+
+// Escala de renderização ajustada pelo tempo de GPU dos quadros (--dynamic-resolution)
+//
+// A cena é desenhada em um retângulo, no canto da imagem transitória do tamanho da saída, com lados multiplicados pela
+// escala, e o pós-processamento o amplia para a imagem final. A imagem não muda de tamanho, então nem ela nem a cadeia
+// de troca são recriadas quando a escala muda.
+//
+// Os tempos de GPU do quadro e dos passes da cena são suavizados (média móvel exponencial). Só o da cena é suposto
+// proporcional ao número de pixels, ou seja, ao quadrado da escala; o restante (pós-processamento na resolução da saída,
+// cópias, barreiras) é um custo fixo que a escala não reduz. A cada amostra a escala vai em direção à que deixaria o
+// quadro em HEADROOM do tempo alvo, com um passo máximo por quadro e uma zona morta que evita oscilações.
+class DynamicResolution
+{
+public:
+    static constexpr double HEADROOM = 0.9;         // Fração do tempo alvo usada como meta
+    static constexpr double SMOOTHING = 0.15;       // Peso de cada amostra na média
+    static constexpr float MAX_STEP = 0.05f;        // Variação máxima da escala por amostra
+    static constexpr float DEAD_ZONE = 0.02f;       // Variações menores são ignoradas
+    static constexpr uint32_t EXTENT_ALIGNMENT = 8; // Lados múltiplos do grupo de trabalho do pós-processamento
+
+    void init(double targetMilliseconds, float minScale, float maxScale);
+
+    // Tempos de GPU de um quadro concluído, inteiro e só dos passes da cena; amostras não positivas (sem timestamps) são
+    // ignoradas
+    void addGpuTime(double frameMilliseconds, double sceneMilliseconds);
+
+    float scale() const { return currentScale; }
+    // Tamanho do retângulo da cena para uma saída de tamanho full (nunca maior que ela)
+    VkExtent2D scaledExtent(VkExtent2D full) const;
+
+    // Tempo alvo, escala mínima, média e final, e número de mudanças
+    std::string describe() const;
+
+private:
+    double targetMilliseconds = 0.0;
+    float minScale = 1.0f;
+    float maxScale = 1.0f;
+    float currentScale = 1.0f;
+    double smoothedMilliseconds = 0.0;
+    double smoothedSceneMilliseconds = 0.0;
+    bool hasSample = false;
+
+    uint64_t samples = 0;
+    uint64_t changes = 0;
+    double scaleSum = 0.0;
+    float lowestScale = 1.0f;
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Janela deslizante de amostras de tempo (em milissegundos) com percentis
+class RollingTimings
+{
+public:
+    static constexpr size_t CAPACITY = 240; // ~4 s a 60 quadros/s
+
+    void add(double milliseconds);
+    // Percentil p (0-100) das amostras na janela; 0 se vazia
+    double percentile(double p) const;
+    size_t count() const { return size; }
+
+private:
+    std::array<double, CAPACITY> samples{};
+    size_t next = 0;
+    size_t size = 0;
+};
+
+// Instrumentação do laço de quadros: escopos de CPU, timestamps de GPU e exportação no formato Chrome trace
+//
+// Os tempos de GPU vêm de um VkQueryPool por quadro em voo, lido somente depois que a cerca do quadro é esperada (não
+// bloqueia) e convertido para nanossegundos com timestampPeriod. Os percentis p50/p95/p99 cobrem os últimos
+// RollingTimings::CAPACITY quadros. Com um caminho de trace, todos os escopos são gravados no encerramento em JSON
+// (chrome://tracing ou Perfetto). Os escopos de CPU podem ser usados por qualquer thread.
+class FrameProfiler
+{
+public:
+    static constexpr uint32_t MAX_GPU_SCOPES = 16; // Por quadro
+
+    // timestampValidBits da família de gráficos; 0 desativa os tempos de GPU
+    void init(VkDevice device, const VkPhysicalDeviceProperties &properties, uint32_t timestampValidBits,
+              uint32_t frameCount, const std::string &tracePath);
+    // Grava o trace (se habilitado) e destrói os pools de consulta
+    void destroy();
+
+    // Chamado depois de esperar a cerca do quadro frameIndex: coleta os timestamps de GPU gravados por ele
+    void beginFrame(uint32_t frameIndex);
+    // Tempo de GPU do quadro coletado pelo último beginFrame; 0 se ele não tinha timestamps
+    double lastGpuFrameMilliseconds() const { return lastGpuFrameTime; }
+    // Soma dos escopos de GPU chamados name no quadro coletado pelo último beginFrame; 0 se não houver nenhum
+    double lastGpuScopeMilliseconds(const char *name) const;
+    // Marca o fim do quadro na CPU (o intervalo entre chamadas é o tempo de quadro)
+    void endFrame();
+
+    // Reseta as consultas do quadro; deve ser gravado fora de um passe de renderização, antes de qualquer escopo de GPU
+    void resetGpuScopes(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+    // Delimita um intervalo de GPU no buffer de comando do quadro; name deve ser uma string estática
+    void beginGpuScope(VkCommandBuffer commandBuffer, uint32_t frameIndex, const char *name);
+    void endGpuScope(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    // Mede a duração do bloco em que foi declarado; name deve ser uma string estática
+    class CpuScope
+    {
+    public:
+        CpuScope(FrameProfiler &profiler, const char *name);
+        ~CpuScope();
+
+        CpuScope(const CpuScope &) = delete;
+        CpuScope &operator=(const CpuScope &) = delete;
+
+    private:
+        FrameProfiler &profiler;
+        const char *name;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // Resumo curto dos percentis, adequado para o título da janela
+    std::string summary() const;
+    // Relatório com os percentis de cada escopo e o histograma dos tempos de quadro
+    void printReport() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct GpuScope
+    {
+        const char *name;
+        uint32_t beginQuery;
+        uint32_t endQuery;
+    };
+
+    struct GpuFrame
+    {
+        VkQueryPool queryPool = VK_NULL_HANDLE;
+        std::vector<GpuScope> scopes;
+        std::vector<uint32_t> openScopes; // Pilha de escopos abertos (índices em scopes)
+        uint32_t queryCount = 0;
+        Clock::time_point recordTime; // Início da gravação: a GPU não pode ter começado antes disso
+        bool pending = false;
+    };
+
+    struct TraceEvent
+    {
+        const char *name;
+        uint32_t thread; // 0 é a GPU
+        double startMicroseconds;
+        double durationMicroseconds;
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    double timestampPeriod = 1.0; // Nanossegundos por tique
+    uint64_t timestampMask = 0;
+    bool gpuEnabled = false;
+    std::vector<GpuFrame> gpuFrames;
+
+    Clock::time_point epoch;
+    Clock::time_point lastFrameEnd;
+    bool hasLastFrame = false;
+    bool tracing = false;
+    std::string tracePath;
+    // Deslocamento entre o relógio da GPU e o da CPU (sem VK_EXT_calibrated_timestamps, é uma estimativa: o menor valor
+    // que não coloca nenhum quadro da GPU antes do início da sua gravação)
+    double gpuToCpuOffsetMicroseconds = 0.0;
+    bool hasGpuOffset = false;
+
+    mutable std::mutex mutex;
+    RollingTimings frameTimes;
+    RollingTimings gpuFrameTimes;
+    double lastGpuFrameTime = 0.0; // Só acessado pela thread do laço de quadros
+    // Nome e duração (ms) dos escopos do mesmo quadro; também só da thread do laço de quadros
+    std::vector<std::pair<const char *, double>> lastGpuScopes;
+    std::map<std::string, RollingTimings> scopeTimes;
+    std::vector<TraceEvent> traceEvents;
+    std::map<std::thread::id, uint32_t> threadIds;
+    std::array<uint32_t, 10> histogram{}; // Tempos de quadro em faixas de 4 ms (a última acumula o restante)
+
+    void addCpuScope(const char *name, Clock::time_point start, Clock::time_point end);
+    uint32_t traceThreadId();
+    void writeTrace() const;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Como a memória será acessada; define o tipo de memória escolhido
+enum class MemoryUsage
+{
+    GpuOnly,  // Somente a GPU acessa (DEVICE_LOCAL)
+    CpuToGpu, // Escrita pela CPU e lida pela GPU: staging e dados dinâmicos (HOST_VISIBLE | HOST_COHERENT)
+    GpuToCpu, // Escrita pela GPU e lida pela CPU: leitura de resultados (HOST_VISIBLE | HOST_CACHED)
+};
+
+// Tipo de recurso que ocupará a memória
+// Recursos lineares (buffers e imagens VK_IMAGE_TILING_LINEAR) e ótimos (imagens VK_IMAGE_TILING_OPTIMAL) usam pools
+// separados, então vizinhos de tipos diferentes nunca dividem uma página de bufferImageGranularity
+enum class ResourceKind
+{
+    Linear,
+    Optimal,
+};
+
+struct GpuMemoryBlock;
+
+// Região de memória de dispositivo entregue pelo alocador
+struct GpuAllocation
+{
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    // Ponteiro mapeado já deslocado para offset (nullptr se a memória não for visível pela CPU)
+    void *mapped = nullptr;
+    uint32_t memoryType = 0;
+
+    GpuMemoryBlock *block = nullptr; // Interno: bloco de onde a região foi sub-alocada
+};
+
+// Movimento proposto pela desfragmentação
+// O chamador copia o conteúdo de source para destination, religa o recurso a destination e, quando a GPU não usar mais
+// source, chama GpuAllocator::completeMove
+struct GpuDefragmentationMove
+{
+    GpuAllocation source;
+    GpuAllocation destination;
+    void *userData; // Valor informado em allocate, identifica o recurso que usa a região
+};
+
+struct GpuAllocatorStats
+{
+    uint32_t blockCount = 0;        // Chamadas vkAllocateMemory ativas (blocos + alocações dedicadas)
+    uint32_t allocationCount = 0;   // Sub-alocações ativas
+    VkDeviceSize reservedBytes = 0; // Memória obtida do driver
+    VkDeviceSize usedBytes = 0;     // Memória entregue aos recursos
+};
+
+// Orçamento de um heap de memória para este processo
+struct GpuMemoryBudget
+{
+    VkDeviceSize budget = 0; // Quanto o processo pode usar antes de o driver começar a falhar ou a paginar
+    VkDeviceSize usage = 0;  // Quanto o processo já usa
+};
+
+// Alocador de memória de dispositivo: a única rota do projeto para VkDeviceMemory
+//
+// Reserva blocos grandes por tipo de memória (vkAllocateMemory é caro e limitado a maxMemoryAllocationCount, tipicamente
+// 4096) e sub-aloca regiões alinhadas dentro deles. Recursos muito grandes recebem uma alocação dedicada.
+// Blocos visíveis pela CPU ficam mapeados permanentemente. Todos os métodos são seguros entre threads.
+class GpuAllocator
+{
+public:
+    GpuAllocator();
+    ~GpuAllocator(); // Não libera memória; destroy deve ser chamado antes de destruir o dispositivo
+
+    // memoryBudgetEnabled: VK_EXT_memory_budget foi habilitada no dispositivo
+    void init(VkPhysicalDevice physicalDevice, VkDevice device, bool memoryBudgetEnabled = false);
+    void destroy();
+
+    // Aloca memória para os requisitos informados; lança std::runtime_error se não houver memória
+    GpuAllocation allocate(const VkMemoryRequirements &requirements, MemoryUsage usage, ResourceKind kind, void *userData = nullptr);
+    void free(GpuAllocation &allocation);
+
+    // Cria um buffer e liga-o a memória sub-alocada
+    void createBuffer(const VkBufferCreateInfo &createInfo, MemoryUsage usage, VkBuffer &buffer, GpuAllocation &allocation, void *userData = nullptr);
+    void destroyBuffer(VkBuffer buffer, GpuAllocation &allocation);
+
+    // Cria uma imagem e liga-a a memória sub-alocada (o pool depende de createInfo.tiling)
+    void createImage(const VkImageCreateInfo &createInfo, MemoryUsage usage, VkImage &image, GpuAllocation &allocation, void *userData = nullptr);
+    void destroyImage(VkImage image, GpuAllocation &allocation);
+
+    // Planeja movimentos que esvaziam os blocos menos ocupados, movendo no máximo maxBytes
+    // As regiões de destino já ficam reservadas; os blocos esvaziados são liberados por releaseEmptyBlocks
+    std::vector<GpuDefragmentationMove> planDefragmentation(VkDeviceSize maxBytes);
+    void completeMove(const GpuDefragmentationMove &move);
+
+    // Devolve ao driver os blocos sem nenhuma sub-alocação (mantém um bloco vazio por pool para evitar oscilação)
+    void releaseEmptyBlocks();
+
+    GpuAllocatorStats stats() const;
+
+    // Orçamento do maior heap local ao dispositivo (a VRAM em GPUs dedicadas)
+    // Com VK_EXT_memory_budget vem do driver e considera os outros processos; sem ela é uma fração fixa do heap, e o uso
+    // é só o deste alocador
+    GpuMemoryBudget deviceLocalBudget() const;
+
+    const VkPhysicalDeviceMemoryProperties &memoryProperties() const { return memProperties; }
+
+private:
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties memProperties{};
+    uint32_t maxMemoryAllocationCount = 0;
+    bool memoryBudgetEnabled = false;
+    uint32_t deviceLocalHeap = 0;
+
+    // Pools indexados por tipo de memória e ResourceKind
+    std::array<std::vector<std::unique_ptr<GpuMemoryBlock>>, VK_MAX_MEMORY_TYPES * 2> pools;
+    std::vector<std::unique_ptr<GpuMemoryBlock>> dedicatedBlocks;
+    uint32_t deviceAllocationCount = 0;
+
+    mutable std::mutex mutex;
+
+    uint32_t findMemoryType(uint32_t typeBits, MemoryUsage usage) const;
+    VkDeviceSize preferredBlockSize(uint32_t memoryType) const;
+    GpuMemoryBlock *allocateBlock(uint32_t memoryType, ResourceKind kind, VkDeviceSize size, bool dedicated);
+    void freeBlock(GpuMemoryBlock *block);
+    // exclude: bloco de origem da desfragmentação, que não pode receber as regiões movidas
+    bool allocateFromPool(uint32_t memoryType, ResourceKind kind, VkDeviceSize size, VkDeviceSize alignment,
+                          void *userData, GpuMemoryBlock *exclude, GpuAllocation &allocation);
+    void freeLocked(GpuAllocation &allocation);
+};
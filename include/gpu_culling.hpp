@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "bindless_heap.hpp"
+#include "build_config.hpp"
+#include "gpu_allocator.hpp"
+#include "queue_timeline.hpp"
+
+// Instância da cena; mesmo layout (std430) de SceneInstance em shader.vert e cull.comp
+struct SceneInstance
+{
+    glm::vec4 positionScale; // xyz: posição no mundo, w: escala
+    uint32_t meshIndex;
+    uint32_t materialIndex;
+    uint32_t textureIndex; // Índice no heap bindless
+    float boundingRadius;  // Raio da esfera envolvente, já escalado
+};
+
+// Faixa do buffer de índices desenhada por uma malha; mesmo layout de SceneMesh em cull.comp
+struct SceneMesh
+{
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t padding;
+};
+
+// Planos do volume de visão, voltados para dentro (ax + by + cz + d >= 0 no interior)
+struct Frustum
+{
+    std::array<glm::vec4, 6> planes;
+
+    // Extrai os planos de uma matriz de projeção e visão com profundidade em [0, 1]
+    static Frustum fromViewProjection(const glm::mat4 &viewProjection);
+
+    bool intersectsSphere(const glm::vec3 &center, float radius) const;
+};
+
+// Seleção por volume de visão na GPU gerando desenhos indiretos
+//
+// Um compute shader testa a esfera envolvente de cada instância contra o volume de visão e, para as visíveis, escreve um
+// VkDrawIndexedIndirectCommand na faixa do seu material e incrementa a contagem dele. A fila de gráficos desenha tudo com
+// um vkCmdDrawIndexedIndirectCount por material, então o custo de CPU não cresce com o número de instâncias.
+//
+// A seleção é submetida na linha do tempo de computação (a fila assíncrona quando houver família dedicada); a submissão
+// de gráficos espera o valor devolvido por cull. Os buffers de comandos e contagens existem por quadro em voo e usam
+// VK_SHARING_MODE_CONCURRENT quando as famílias são diferentes, sem transferências de posse.
+class GpuCulling
+{
+public:
+    static constexpr uint32_t WORKGROUP_SIZE = BuildConfig::cullWorkgroupSize; // local_size_x de cull.comp (especializado)
+
+    void init(VkDevice device, GpuAllocator &allocator, BindlessHeap &heap, QueueTimeline &computeTimeline,
+              uint32_t computeFamily, uint32_t graphicsFamily, uint32_t frameCount,
+              uint32_t maxInstances, uint32_t materialCount,
+              const std::vector<char> &shaderCode, VkPipelineCache pipelineCache);
+    void destroy();
+
+    // Submete a seleção do quadro frameIndex e devolve o valor da linha do tempo de computação que a conclui
+    // O quadro anterior com o mesmo índice deve ter terminado na GPU. waitTimeline (opcional) protege dados recém-enviados
+    uint64_t cull(uint32_t frameIndex, const Frustum &frustum, uint32_t instanceBufferIndex, uint32_t meshBufferIndex,
+                  uint32_t instanceCount, const QueueTimeline *waitTimeline, uint64_t waitValue);
+
+    // Cria um pipeline de seleção com o mesmo layout; seguro em outra thread (usado pela recarga de shaders)
+    VkPipeline createPipeline(const std::vector<char> &shaderCode) const;
+    // Passa a usar newPipeline nas próximas seleções e devolve o anterior, que pode estar em uso na fila de computação
+    VkPipeline swapPipeline(VkPipeline newPipeline);
+
+    // Grava o desenho indireto de um material no passe de renderização; pipeline e buffers já devem estar vinculados
+    void recordDraws(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t material) const;
+
+private:
+    struct FrameData
+    {
+        VkBuffer commandBuffer = VK_NULL_HANDLE; // materialCount * maxInstances comandos
+        GpuAllocation commandAllocation;
+        VkBuffer countBuffer = VK_NULL_HANDLE; // Uma contagem por material
+        GpuAllocation countAllocation;
+        uint32_t commandBufferIndex = INVALID_BINDLESS_INDEX;
+        uint32_t countBufferIndex = INVALID_BINDLESS_INDEX;
+
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer computeCommands = VK_NULL_HANDLE;
+        uint64_t value = 0; // Valor da linha do tempo de computação da última seleção deste quadro
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    GpuAllocator *allocator = nullptr;
+    BindlessHeap *heap = nullptr;
+    QueueTimeline *computeTimeline = nullptr;
+    uint32_t maxInstances = 0;
+    uint32_t materialCount = 0;
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    std::vector<FrameData> frames;
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Memória do host pedida pelo driver e pelo loader (VkAllocationCallbacks)
+//
+// Todas as chamadas vkCreate*/vkDestroy*/vkAllocateMemory/vkFreeMemory passam hostAllocationCallbacks(). Os callbacks
+// são instalados antes da criação da instância e removidos depois da sua destruição, pois cada objeto precisa ser
+// destruído com callbacks compatíveis com os da criação:
+//   - VK_SYSTEM_ALLOCATION_SCOPE_COMMAND: arena do quadro. Essas alocações só duram a chamada que as fez, então liberar
+//     é só descontar, e beginFrame volta ao início da arena quando nenhuma estiver viva. Sem espaço, vão para o heap;
+//   - demais escopos: blocos de classes de tamanho fixas, com uma lista livre (e um mutex) por classe. Os blocos não
+//     voltam ao sistema antes de uninstall. Acima da maior classe, ou com alinhamento maior, vão para o heap;
+//   - contadores por escopo: alocações, liberações, bytes vivos e pico, alocações por quadro no laço e as alocações
+//     internas notificadas pelo driver.
+// Com um limite, as alocações que o ultrapassariam falham e o driver devolve VK_ERROR_OUT_OF_HOST_MEMORY.
+class HostAllocator
+{
+public:
+    static constexpr size_t ARENA_SIZE = 1024 * 1024;
+    static constexpr uint32_t POOL_CLASS_COUNT = 8; // 32, 64, ..., 4096 bytes, incluindo o cabeçalho
+    static constexpr uint32_t SCOPE_COUNT = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+
+    HostAllocator() = default;
+    HostAllocator(const HostAllocator &) = delete;
+    HostAllocator &operator=(const HostAllocator &) = delete;
+    ~HostAllocator();
+
+    // Passa a fornecer os callbacks de hostAllocationCallbacks(); limitBytes 0 não limita
+    void install(uint64_t limitBytes);
+    // Remove os callbacks e devolve a arena e os pools; nenhum objeto criado com eles pode continuar vivo
+    void uninstall();
+
+    // Início de um quadro do laço: fecha as contagens do quadro anterior e reinicia a arena
+    void beginFrame();
+
+    // Memória reservada, arena, falhas e contadores por escopo
+    std::string describe() const;
+
+private:
+    struct ScopeCounters
+    {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> frees{0};
+        std::atomic<uint64_t> reallocations{0};
+        std::atomic<uint64_t> liveBytes{0};
+        std::atomic<uint64_t> peakBytes{0};
+        std::atomic<uint64_t> internalBytes{0};   // Alocações internas do driver (pfnInternalAllocation)
+        std::atomic<uint64_t> frameAllocations{0}; // Desde o último beginFrame
+
+        // Só acessados por beginFrame e describe
+        uint64_t loopAllocations = 0; // Dos quadros do laço, sem o primeiro (que inclui a inicialização)
+        uint64_t maxFrameAllocations = 0;
+    };
+
+    struct Pool
+    {
+        std::mutex mutex;
+        void *freeList = nullptr; // Cada bloco livre guarda o próximo no seu início
+        std::vector<void *> chunks;
+    };
+
+    struct Arena
+    {
+        std::mutex mutex;
+        char *memory = nullptr;
+        size_t offset = 0;
+        uint32_t live = 0;
+        size_t peakOffset = 0;
+        uint64_t overflows = 0;
+        uint64_t skippedResets = 0; // beginFrame com alocações ainda vivas (de outra thread)
+    };
+
+    bool installed = false;
+    uint64_t limitBytes = 0;
+    VkAllocationCallbacks vkCallbacks{};
+
+    Arena arena;
+    std::array<Pool, POOL_CLASS_COUNT> pools;
+    std::array<ScopeCounters, SCOPE_COUNT> scopes;
+    std::atomic<uint64_t> reservedBytes{0}; // Arena, blocos dos pools e blocos do heap
+    std::atomic<uint64_t> peakReservedBytes{0};
+    std::atomic<uint64_t> failedAllocations{0};
+    uint64_t framesBegun = 0;
+
+    bool reserve(uint64_t bytes);
+    void release(uint64_t bytes);
+
+    void *allocate(size_t size, size_t alignment, VkSystemAllocationScope scope);
+    void *reallocate(void *original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    void free(void *memory);
+    void *allocateFromArena(size_t size, size_t alignment);
+    void *allocateFromPool(uint32_t sizeClass);
+    void *allocateFromHeap(size_t size, size_t alignment, VkSystemAllocationScope scope);
+
+    static void *VKAPI_CALL allocationCallback(void *userData, size_t size, size_t alignment,
+                                               VkSystemAllocationScope scope);
+    static void *VKAPI_CALL reallocationCallback(void *userData, void *original, size_t size, size_t alignment,
+                                                 VkSystemAllocationScope scope);
+    static void VKAPI_CALL freeCallback(void *userData, void *memory);
+    static void VKAPI_CALL internalAllocationCallback(void *userData, size_t size, VkInternalAllocationType type,
+                                                      VkSystemAllocationScope scope);
+    static void VKAPI_CALL internalFreeCallback(void *userData, size_t size, VkInternalAllocationType type,
+                                                VkSystemAllocationScope scope);
+};
+
+// Callbacks do HostAllocator instalado, ou nullptr (alocador do próprio driver) quando não há nenhum
+const VkAllocationCallbacks *hostAllocationCallbacks();
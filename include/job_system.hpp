@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Prioridade de um trabalho
+enum class JobPriority
+{
+    Frame,      // Trabalho do quadro atual: a barreira do quadro espera por ele e wait o executa enquanto espera
+    Background, // Pode atravessar quadros (E/S, cargas do streaming); só as threads de trabalho o executam
+};
+
+// Contador de trabalhos pendentes, usado para esperar um grupo de trabalhos e como dependência de outros
+//
+// Cada trabalho lançado com o contador o incrementa e o decrementa ao terminar. Os trabalhos registrados com runAfter
+// ficam guardados no contador e são enfileirados quando ele chega a zero, sem que nenhuma thread fique bloqueada; é o
+// gancho para retomar uma corrotina ou fibra suspensa. A primeira exceção de um trabalho é guardada e relançada por
+// JobSystem::wait.
+//
+// O destrutor espera os trabalhos pendentes, como o de std::future devolvido por std::async: um contador local nunca é
+// destruído com um trabalho que ainda o referencia.
+class JobCounter
+{
+public:
+    JobCounter() = default;
+    ~JobCounter();
+
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    bool done() const;
+
+private:
+    friend class JobSystem;
+
+    struct Continuation
+    {
+        std::function<void()> function;
+        JobCounter *counter;
+        JobPriority priority;
+    };
+
+    mutable std::mutex mutex;
+    std::condition_variable finished;
+    uint32_t pending = 0;
+    std::vector<Continuation> continuations;
+    std::exception_ptr error;
+};
+
+// Sistema de trabalhos com roubo de tarefas para o trabalho de CPU do motor (--job-threads)
+//
+// Um conjunto fixo de threads de trabalho, uma por núcleo livre, executa tudo o que antes tinha threads próprias (a
+// gravação paralela, as cargas do streaming de texturas e as etapas paralelas da inicialização); um subsistema novo
+// lança trabalhos aqui em vez de criar threads, e a máquina não fica com mais threads prontas que núcleos.
+//
+// Cada thread de trabalho, e a thread que chamou init (a principal), tem a sua fila de trabalhos do quadro: os
+// trabalhos lançados por uma delas entram no fim da própria fila, que ela consome pelo fim (o trabalho mais recente,
+// ainda no cache), enquanto as threads sem trabalho roubam pelo começo das filas das outras. Os trabalhos de segundo
+// plano ficam em uma fila comum, atendida só quando não há trabalho de quadro; wait na thread principal nunca os
+// executa, então ela não fica presa atrás de uma carga demorada.
+//
+// Um trabalho não deve bloquear em primitivas do sistema esperando outros trabalhos: wait executa trabalhos do quadro
+// enquanto espera, e runAfter encadeia uma continuação sem ocupar nenhuma thread. O registro assíncrono e a recarga de
+// shaders, que passam quase todo o tempo dormindo ou bloqueados em E/S, continuam com threads próprias.
+//
+// frameBarrier é a barreira de fase do laço de quadros: espera todos os trabalhos de quadro lançados até ali e relança
+// a exceção de um trabalho sem contador. Nenhum trabalho de um quadro continua rodando quando o próximo começa.
+class JobSystem
+{
+public:
+    // Índice de threadIndex para threads que não pertencem ao sistema
+    static constexpr uint32_t EXTERNAL_THREAD = UINT32_MAX;
+
+    JobSystem() = default;
+    ~JobSystem(); // Chama destroy
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // workerCount = 0 usa um trabalhador por núcleo livre (a thread que chama init é a principal)
+    void init(uint32_t workerCount = 0);
+    // Executa os trabalhos restantes e encerra as threads
+    void destroy();
+
+    // Threads que executam trabalhos: os trabalhadores mais a principal, que tem o índice 0
+    uint32_t threadCount() const { return static_cast<uint32_t>(queues.size()); }
+    // Índice da thread atual em [0, threadCount), ou EXTERNAL_THREAD; estável durante um trabalho, então serve para
+    // indexar recursos por thread (como pools de comandos)
+    uint32_t threadIndex() const;
+
+    // Lança um trabalho; counter, quando não nulo, é incrementado agora e decrementado quando o trabalho termina
+    void run(std::function<void()> function, JobCounter *counter = nullptr, JobPriority priority = JobPriority::Frame);
+    // Lança o trabalho quando dependency chegar a zero (imediatamente se já estiver em zero)
+    void runAfter(JobCounter &dependency, std::function<void()> function, JobCounter *counter = nullptr,
+                  JobPriority priority = JobPriority::Frame);
+
+    // Espera counter chegar a zero, executando trabalhos do quadro enquanto isso; relança a exceção de um dos trabalhos
+    void wait(JobCounter &counter);
+
+    // Barreira de fase: chamada uma vez por quadro pelo laço de quadros, depois de drawFrame
+    void frameBarrier();
+
+    // Trabalhos executados, roubos e o tempo gasto esperando na barreira
+    std::string describe() const;
+
+private:
+    struct Job
+    {
+        std::function<void()> function;
+        JobCounter *counter = nullptr;
+        JobPriority priority = JobPriority::Frame;
+    };
+
+    // Fila de trabalhos do quadro de uma thread
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; // [threadIndex]
+    std::vector<std::thread> workers;           // O trabalhador i tem o índice i + 1
+
+    std::mutex backgroundMutex;
+    std::deque<Job> backgroundJobs;
+
+    // Contador de eventos: muda a cada trabalho lançado ou contador zerado, sob sleepMutex, e acorda quem dorme
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    uint64_t epoch = 0;
+    bool stopping = false;
+
+    std::atomic<uint32_t> nextExternalQueue{0};
+    JobCounter frameJobs; // Trabalhos de quadro lançados e ainda não concluídos
+    std::mutex errorMutex;
+    std::exception_ptr error; // De um trabalho sem contador, relançada por frameBarrier
+
+    std::atomic<uint64_t> executed{0};
+    std::atomic<uint64_t> steals{0};
+    uint64_t barriers = 0;
+    std::chrono::duration<double, std::milli> barrierWait{0};
+
+    void push(Job job);
+    // Retira um trabalho: o da própria fila, um roubado ou, com allowBackground, um de segundo plano
+    bool take(uint32_t index, bool allowBackground, Job &job);
+    void execute(Job &job);
+    // Decrementa o contador e enfileira as continuações quando ele zera
+    void finish(JobCounter &counter, std::exception_ptr jobError);
+    void signal();
+    uint64_t currentEpoch();
+    void workerLoop(uint32_t index);
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <functional>
+#include <vector>
+
+#include "job_system.hpp"
+
+// Grava buffers de comando secundários em paralelo, como trabalhos do JobSystem
+//
+// Cada thread do sistema de trabalhos (threadIndex) tem um VkCommandPool por quadro em voo (pools não podem ser usados
+// por duas threads ao mesmo tempo).
+// Em beginFrame os pools daquele quadro são resetados e seus buffers reaproveitados, em vez de liberados e alocados de
+// novo. O intervalo de desenhos é dividido em blocos; cada bloco é um trabalho que grava um buffer secundário,
+// executado pelo buffer primário com vkCmdExecuteCommands na ordem dos blocos. A thread que chama record grava blocos
+// enquanto espera.
+class ParallelRecorder
+{
+public:
+    // Grava os desenhos [first, last) no buffer secundário informado (já iniciado com o estado herdado)
+    using RecordFunction = std::function<void(VkCommandBuffer commandBuffer, uint32_t first, uint32_t last)>;
+
+    // jobs deve sobreviver ao gravador
+    void init(VkDevice device, uint32_t queueFamily, uint32_t frameCount, JobSystem &jobs);
+    void destroy();
+
+    // Reseta os pools do quadro frameIndex; chamado uma vez por quadro, antes do primeiro record, depois que o trabalho
+    // daquele quadro terminou na GPU
+    void beginFrame(uint32_t frameIndex);
+
+    // Grava drawCount desenhos em buffers secundários do quadro frameIndex e retorna-os em ordem
+    // Pode ser chamado mais de uma vez por quadro (um passe por janela); retorna quando todos os blocos terminam
+    std::vector<VkCommandBuffer> record(uint32_t frameIndex, const VkCommandBufferInheritanceInfo &inheritance,
+                                        uint32_t drawCount, const RecordFunction &recordRange);
+
+private:
+    // Pool de uma thread para um quadro em voo
+    struct ThreadPool
+    {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> commandBuffers; // Alocados sob demanda e reaproveitados entre quadros
+        uint32_t used = 0;
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    uint32_t frameCount = 0;
+    JobSystem *jobs = nullptr;
+    std::vector<std::vector<ThreadPool>> pools; // [threadIndex][quadro]
+
+    void recordChunk(ThreadPool &pool, const VkCommandBufferInheritanceInfo &inheritance,
+                     const RecordFunction &recordRange, uint32_t first, uint32_t last, VkCommandBuffer &result);
+    VkCommandBuffer acquireCommandBuffer(ThreadPool &pool);
+};
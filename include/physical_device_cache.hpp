@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <vector>
+
+#include "device_capabilities.hpp"
+
+// Tudo o que a escolha do dispositivo e a criação do dispositivo lógico e da cadeia de troca consultam de um dispositivo
+// físico, lido uma única vez
+struct PhysicalDeviceInfo
+{
+    VkPhysicalDevice device = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties properties{};
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    DeviceCapabilities capabilities;
+    std::string uuid; // 32 dígitos hexadecimais; vazio abaixo do Vulkan 1.1
+
+    std::vector<VkQueueFamilyProperties> queueFamilies;
+    std::vector<VkBool32> presentSupport; // Por família, para a superfície da cache (tudo falso sem superfície)
+    std::vector<VkExtensionProperties> extensions;
+
+    // Formatos e modos de apresentação não mudam com a janela; VkSurfaceCapabilitiesKHR (a extensão atual) muda e
+    // continua sendo consultada a cada criação da cadeia de troca
+    std::vector<VkSurfaceFormatKHR> surfaceFormats;
+    std::vector<VkPresentModeKHR> presentModes;
+
+    bool hasExtension(const char *name) const;
+};
+
+// Consulta todos os dispositivos físicos da instância de uma vez
+class PhysicalDeviceCache
+{
+public:
+    // surface pode ser VK_NULL_HANDLE (sem janela); instanceApiVersion limita as features consultadas
+    void init(VkInstance instance, VkSurfaceKHR surface, uint32_t instanceApiVersion);
+
+    const std::vector<PhysicalDeviceInfo> &devices() const { return infos; }
+    // Lança std::runtime_error se o dispositivo não for desta instância
+    const PhysicalDeviceInfo &get(VkPhysicalDevice device) const;
+
+private:
+    std::vector<PhysicalDeviceInfo> infos;
+};
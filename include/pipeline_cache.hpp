@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <vector>
+
+// Cache de pipelines persistido em disco entre execuções
+// O conteúdo salvo só é reaproveitado se o cabeçalho pertencer ao mesmo dispositivo físico e driver
+class PipelineCache
+{
+public:
+    // Cria o VkPipelineCache, carregando os dados de path quando forem compatíveis com o dispositivo
+    void create(VkDevice device, const VkPhysicalDeviceProperties &properties, const std::string &path);
+    // Como create, com os dados já lidos por load (a leitura pode acontecer antes de o dispositivo existir)
+    void create(VkDevice device, const VkPhysicalDeviceProperties &properties, const std::string &path,
+                std::vector<char> data);
+
+    // Lê o arquivo do cache; vazio se ele não existir
+    static std::vector<char> load(const std::string &path);
+
+    // Grava o conteúdo atual do cache em disco
+    void save() const;
+
+    // Destrói o VkPipelineCache (não grava os dados)
+    void destroy();
+
+    VkPipelineCache handle() const { return cache; }
+
+    // Verifica se os dados de um cache foram gerados pelo dispositivo informado
+    static bool isCompatible(const std::vector<char> &data, const VkPhysicalDeviceProperties &properties);
+
+private:
+    VkDevice device = VK_NULL_HANDLE;
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    std::string path;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "surface_format.hpp"
+
+// Parâmetros do pós-processamento de um quadro
+struct PostSettings
+{
+    float exposure = 1.0f; // Multiplica a cor da cena antes do mapeamento de tons
+    // Codificação da imagem final; imagens de armazenamento não podem ter formato _SRGB, então o sRGB é feito no shader
+    OutputEncoding encoding = OutputEncoding::None;
+    float paperWhiteNits = 200.0f; // Branco nas saídas HDR
+};
+
+// Pós-processamento em compute que escreve direto na imagem final (--compute-post)
+//
+// A cena é desenhada em uma imagem de ponto flutuante (SCENE_COLOR_FORMAT) e um único dispatch de post.comp faz o
+// mapeamento de tons (ACES), o FXAA e a ampliação bilinear, amostrando a cena na coordenada de cada pixel da saída e
+// gravando o resultado com imageStore na imagem da cadeia de troca (criada com VK_IMAGE_USAGE_STORAGE_BIT). Não há
+// passe de tela cheia nem cópia entre a cena e a apresentação.
+//
+// A saída é declarada sem qualificador de formato (shaderStorageImageWriteWithoutFormat), pois o formato da cadeia de
+// troca (B8G8R8A8 em geral) não tem qualificador no GLSL. Há um conjunto de descritores por quadro em voo e saída,
+// atualizado ao gravar: o uso anterior do mesmo conjunto já terminou quando o quadro volta a ser gravado.
+class PostProcess
+{
+public:
+    static constexpr VkFormat SCENE_COLOR_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+    static constexpr uint32_t WORKGROUP_SIZE = 8; // local_size_x e local_size_y de post.comp
+
+    // Verdadeiro se imagens do formato podem ser escritas pelo compute shader (tiling ótimo)
+    static bool supportsStorageOutput(VkPhysicalDevice physicalDevice, VkFormat format);
+
+    // outputCount: imagens finais gravadas por quadro (uma por janela)
+    void init(VkDevice device, uint32_t frameCount, uint32_t outputCount, const std::vector<char> &shaderCode,
+              VkPipelineCache pipelineCache);
+    void destroy();
+
+    // Cria um pipeline com o mesmo layout; seguro em outra thread (usado pela recarga de shaders)
+    VkPipeline createPipeline(const std::vector<char> &shaderCode) const;
+    // Passa a usar newPipeline nas próximas gravações e devolve o anterior, que pode estar em uso nos quadros em voo
+    VkPipeline swapPipeline(VkPipeline newPipeline);
+
+    // Grava o dispatch que lê sceneView (SHADER_READ_ONLY_OPTIMAL) e escreve outputView (GENERAL)
+    // A cena ocupa o retângulo sceneExtent no canto da imagem sceneImageExtent (menor com resolução dinâmica)
+    void record(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t outputIndex,
+                VkImageView sceneView, VkExtent2D sceneExtent, VkExtent2D sceneImageExtent,
+                VkImageView outputView, VkExtent2D outputExtent, const PostSettings &settings);
+
+private:
+    VkDevice device = VK_NULL_HANDLE;
+    uint32_t outputCount = 0;
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+    VkSampler sampler = VK_NULL_HANDLE; // Linear, coordenadas presas à borda
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> descriptorSets; // frameIndex * outputCount + outputIndex
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+};
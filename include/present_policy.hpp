@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <vector>
+
+// Política de apresentação escolhida pelo usuário
+enum class PresentPolicy
+{
+    Immediate,   // Menor latência, com tearing (benchmarks)
+    Mailbox,     // Baixa latência sem tearing; descarta quadros que não chegarem a ser exibidos
+    Fifo,        // Sincronizado com o vblank, sem descartes (menor consumo; sempre suportado)
+    FifoRelaxed, // Como FIFO, mas apresenta imediatamente um quadro atrasado (tearing só quando atrasa)
+};
+
+// Nome usado na linha de comando ("immediate", "mailbox", "fifo", "fifo-relaxed")
+const char *presentPolicyName(PresentPolicy policy);
+
+// Converte o nome da linha de comando; retorna false se não for conhecido
+bool parsePresentPolicy(const std::string &name, PresentPolicy &policy);
+
+// Próxima política na ordem de alternância em tempo de execução
+PresentPolicy nextPresentPolicy(PresentPolicy policy);
+
+// Escolhe o modo suportado mais próximo da política, preservando a característica principal dela:
+// Immediate aceita qualquer modo em ordem de latência; os demais nunca caem para um modo com mais tearing
+VkPresentModeKHR choosePresentMode(PresentPolicy policy, const std::vector<VkPresentModeKHR> &availableModes);
+
+const char *presentModeName(VkPresentModeKHR mode);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+// Barreiras de transferência de posse entre famílias de fila
+//
+// Recursos com VK_SHARING_MODE_EXCLUSIVE pertencem a uma única família. Para usá-los em outra família, a fila de origem
+// grava uma barreira de liberação (release) e a fila de destino grava a barreira de aquisição (acquire) correspondente,
+// com a submissão de destino esperando por um semáforo sinalizado pela submissão de origem.
+// Quando as famílias são iguais, a liberação não grava nada e a aquisição vira uma barreira comum entre
+// (srcStage, srcAccess) e (dstStage, dstAccess); com famílias diferentes a aquisição ignora srcStage/srcAccess.
+
+// Grava, na fila de origem, a liberação de um intervalo de buffer para a família dstFamily
+void releaseBufferOwnership(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+                            uint32_t srcFamily, uint32_t dstFamily,
+                            VkPipelineStageFlags srcStage, VkAccessFlags srcAccess);
+
+// Grava, na fila de destino, a aquisição de um intervalo de buffer liberado por srcFamily
+void acquireBufferOwnership(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+                            uint32_t srcFamily, uint32_t dstFamily,
+                            VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                            VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+// Grava, na fila de origem, a liberação de uma imagem; oldLayout/newLayout devem ser iguais aos da aquisição
+void releaseImageOwnership(VkCommandBuffer commandBuffer, VkImage image, const VkImageSubresourceRange &range,
+                           VkImageLayout oldLayout, VkImageLayout newLayout,
+                           uint32_t srcFamily, uint32_t dstFamily,
+                           VkPipelineStageFlags srcStage, VkAccessFlags srcAccess);
+
+// Grava, na fila de destino, a aquisição de uma imagem liberada por srcFamily (executa a transição de layout)
+void acquireImageOwnership(VkCommandBuffer commandBuffer, VkImage image, const VkImageSubresourceRange &range,
+                           VkImageLayout oldLayout, VkImageLayout newLayout,
+                           uint32_t srcFamily, uint32_t dstFamily,
+                           VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                           VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class QueueTimeline;
+
+// Esperas, sinais e buffers de comando de uma submissão, sem alocações
+//
+// Semáforos binários (aquisição e apresentação da cadeia de troca) e de linha do tempo podem ser misturados; o valor de
+// um semáforo binário é ignorado.
+class SubmitBatch
+{
+public:
+    static constexpr uint32_t MAX_SEMAPHORES = 4;
+    static constexpr uint32_t MAX_COMMAND_BUFFERS = 4;
+
+    void addCommandBuffer(VkCommandBuffer commandBuffer);
+    void wait(VkSemaphore semaphore, VkPipelineStageFlags stage, uint64_t value = 0);
+    // Espera a linha do tempo de outra fila alcançar value
+    void wait(const QueueTimeline &timeline, uint64_t value, VkPipelineStageFlags stage);
+    void signal(VkSemaphore semaphore, uint64_t value = 0);
+
+private:
+    friend class QueueTimeline;
+
+    std::array<VkCommandBuffer, MAX_COMMAND_BUFFERS> commandBuffers{};
+    uint32_t commandBufferCount = 0;
+    std::array<VkSemaphore, MAX_SEMAPHORES> waitSemaphores{};
+    std::array<uint64_t, MAX_SEMAPHORES> waitValues{};
+    std::array<VkPipelineStageFlags, MAX_SEMAPHORES> waitStages{};
+    uint32_t waitCount = 0;
+    // Uma posição a mais para o sinal da própria linha do tempo, acrescentado em QueueTimeline::submit
+    std::array<VkSemaphore, MAX_SEMAPHORES + 1> signalSemaphores{};
+    std::array<uint64_t, MAX_SEMAPHORES + 1> signalValues{};
+    uint32_t signalCount = 0;
+};
+
+// Um mutex por VkQueue distinta
+//
+// vkQueueSubmit, vkQueueSubmit2 e vkQueuePresentKHR exigem acesso exclusivo à fila, e várias linhas do tempo (ou a
+// apresentação) podem apontar para a mesma VkQueue quando não há família dedicada: todas devem usar o mutex devolvido
+// aqui. get não é seguro entre threads; os mutexes são obtidos na inicialização e permanecem válidos até o destrutor.
+class QueueLocks
+{
+public:
+    std::mutex &get(VkQueue queue);
+
+private:
+    std::vector<std::pair<VkQueue, std::unique_ptr<std::mutex>>> locks;
+};
+
+// Semáforo de linha do tempo (VK_KHR_timeline_semaphore, núcleo no Vulkan 1.2) associado a uma fila
+//
+// Cada submissão feita por submit sinaliza o próximo valor do contador, então "o trabalho da submissão N terminou" vira
+// "o contador chegou a N": serve tanto para a CPU esperar (wait, isComplete) quanto para outras filas (SubmitBatch::wait),
+// no lugar de cercas e semáforos binários por quadro. O valor 0 está sempre concluído. Seguro entre threads, desde que todo
+// outro acesso à fila (outras linhas do tempo, apresentação) use o mesmo mutex de QueueLocks.
+class QueueTimeline
+{
+public:
+    // queueMutex é o mutex da fila em QueueLocks, compartilhado com tudo o que submete ou apresenta nela
+    void init(VkDevice device, VkQueue queue, std::mutex &queueMutex);
+    void destroy();
+
+    // Submete o lote sinalizando o próximo valor, devolvido em signalValue (só alterado se a submissão der certo)
+    // Usa vkQueueSubmit2 quando synchronization2 estiver ativo (synchronization.hpp)
+    VkResult submit(SubmitBatch &batch, uint64_t &signalValue);
+
+    // Bloqueia até o contador alcançar value
+    void wait(uint64_t value);
+    // Não bloqueia; consulta o dispositivo só quando o último valor lido ainda não basta
+    bool isComplete(uint64_t value);
+
+    // Maior valor já submetido (concluído ou não)
+    uint64_t lastSubmitted() const { return submitted.load(); }
+
+    VkSemaphore semaphore() const { return timelineSemaphore; }
+    VkQueue queue() const { return submitQueue; }
+
+private:
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue submitQueue = VK_NULL_HANDLE;
+    VkSemaphore timelineSemaphore = VK_NULL_HANDLE;
+
+    std::mutex *queueMutex = nullptr; // Serializa as submissões; também mantém os valores sinalizados em ordem
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> completed{0}; // Último valor lido do dispositivo
+
+    // submit com vkQueueSubmit2 (synchronization2Enabled); chamado com o mutex, com o sinal da linha do tempo já no lote
+    VkResult submit2(SubmitBatch &batch, uint64_t value, uint64_t &signalValue);
+};
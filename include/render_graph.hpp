@@ -0,0 +1,205 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "deletion_queue.hpp"
+#include "gpu_allocator.hpp"
+#include "queue_timeline.hpp"
+
+// Grafo de quadro: os passes declaram os recursos que leem e escrevem, e o grafo grava as barreiras
+//
+// A cada quadro a descrição é refeita (reset, import*/createImage, addPass) e compile decide o que executar:
+//   - passes cujos resultados não chegam a nenhum recurso importado (nem têm efeito colateral) são descartados;
+//   - antes de cada passe, todas as transições de layout e dependências de memória que ele precisa vão em um único
+//     cmdPipelineBarrier (synchronization.hpp), e nenhuma barreira é gravada entre leituras no mesmo layout já visíveis;
+//   - imagens transitórias (criadas pelo grafo, só existem dentro do quadro) com tempos de vida disjuntos dividem a
+//     mesma memória. O primeiro uso de cada uma descarta o conteúdo (layout UNDEFINED) e espera o último uso da
+//     anterior na mesma memória.
+// Os recursos físicos das transitórias são mantidos entre quadros enquanto a descrição delas não mudar.
+//
+// Todos os passes gravam no mesmo buffer de comando da fila de gráficos; o trabalho de outras filas continua sendo
+// sincronizado pelas linhas do tempo.
+class RenderGraph
+{
+public:
+    using Resource = uint32_t;
+    static constexpr Resource INVALID_RESOURCE = UINT32_MAX;
+
+    // Como um passe usa um recurso; define estágio, acesso e layout
+    enum class Access
+    {
+        ColorAttachment,     // Escrita como anexo de cor
+        DepthAttachment,     // Leitura e escrita como anexo de profundidade
+        FragmentSampled,     // Amostrada no fragment shader
+        ComputeSampled,      // Amostrada no compute shader
+        ComputeStorageRead,  // Imagem ou buffer de armazenamento lido no compute shader
+        ComputeStorageWrite, // Imagem ou buffer de armazenamento escrito no compute shader (leitura e escrita)
+        GraphicsStorageRead, // Buffer de armazenamento lido nos shaders de vértices e fragmentos
+        IndirectRead,        // Buffer de comandos ou contagens de desenhos indiretos
+        TransferSrc,
+        TransferDst,
+    };
+
+    // Estado de sincronização de um recurso importado na entrada ou na saída do grafo
+    struct ImageState
+    {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        VkAccessFlags access = 0;
+    };
+
+    struct ImageDesc
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent{};
+        VkImageUsageFlags usage = 0; // Somado às usagens implicadas pelos acessos declarados
+    };
+
+    using ExecuteCallback = std::function<void(VkCommandBuffer)>;
+
+    // Declara os acessos de um passe recém-adicionado
+    class PassBuilder
+    {
+    public:
+        PassBuilder &use(Resource resource, Access access);
+        // O passe é executado mesmo sem escrever recursos usados adiante (leituras de volta, consultas)
+        PassBuilder &sideEffect();
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph &graph, uint32_t pass) : graph(graph), pass(pass) {}
+        RenderGraph &graph;
+        uint32_t pass;
+    };
+
+    RenderGraph() = default;
+    RenderGraph(const RenderGraph &) = delete;
+    RenderGraph &operator=(const RenderGraph &) = delete;
+
+    // Os recursos transitórios substituídos são liberados pela deletionQueue quando timeline os liberar
+    void init(VkDevice device, GpuAllocator &allocator, DeletionQueue &deletionQueue, QueueTimeline &timeline);
+    // Destrói os recursos transitórios (o dispositivo deve estar ocioso)
+    void destroy();
+
+    // Começa a descrição do quadro; os identificadores anteriores deixam de valer
+    void reset();
+
+    // Imagem externa (por exemplo da cadeia de troca): o grafo parte de initial e a deixa em final depois do último passe
+    Resource importImage(const std::string &name, VkImage image, VkImageView view, VkImageAspectFlags aspect,
+                         const ImageState &initial, const ImageState &final);
+    // Buffer externo; as dependências anteriores ao grafo são responsabilidade de quem o importa
+    Resource importBuffer(const std::string &name, VkBuffer buffer);
+    // Imagem transitória com uma única camada e um único mip
+    Resource createImage(const std::string &name, const ImageDesc &desc);
+
+    PassBuilder addPass(const std::string &name, ExecuteCallback execute);
+
+    // Descarta passes mortos, calcula os tempos de vida e cria (ou reaproveita) a memória das transitórias
+    void compile();
+    // Grava os passes vivos com as barreiras deduzidas; chamado depois de compile
+    void execute(VkCommandBuffer commandBuffer);
+
+    // Válidos a partir de compile, para os callbacks dos passes
+    VkImage image(Resource resource) const;
+    VkImageView imageView(Resource resource) const;
+    VkBuffer buffer(Resource resource) const;
+
+    // Passes, passes descartados e memória das transitórias do último compile
+    std::string describe() const;
+
+private:
+    struct Use
+    {
+        Resource resource;
+        Access access;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        ExecuteCallback execute;
+        std::vector<Use> uses;
+        bool sideEffect = false;
+        bool live = false;
+    };
+
+    // Estado de sincronização acompanhado durante execute
+    struct SyncState
+    {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags writeStages = 0; // Estágios da última escrita (ou transição)
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags readStages = 0; // Leituras desde a última escrita, esperadas pela próxima escrita
+        VkPipelineStageFlags visibleStages = 0; // Para onde a última escrita já foi tornada visível
+        VkAccessFlags visibleAccess = 0;
+    };
+
+    struct ResourceEntry
+    {
+        std::string name;
+        bool isImage = true;
+        bool imported = false;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        ImageState initial;
+        ImageState final;
+        bool hasFinal = false;
+
+        // Transitórias
+        ImageDesc desc;
+        uint32_t firstPass = UINT32_MAX;
+        uint32_t lastPass = 0;
+        uint32_t physical = UINT32_MAX; // Índice em physicalImages
+
+        SyncState state;
+    };
+
+    // Imagem transitória com memória, mantida entre quadros
+    struct PhysicalImage
+    {
+        ImageDesc desc;
+        uint32_t firstPass;
+        uint32_t lastPass;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkMemoryRequirements requirements{};
+        uint32_t slot = 0;
+        uint32_t previousInSlot = UINT32_MAX; // Ocupante anterior da mesma memória no quadro (ou o último, no primeiro)
+        ImageState lastUse;                 // Estado depois do último uso, esperado pelo próximo ocupante
+    };
+
+    // Faixa de memória dividida por transitórias com tempos de vida disjuntos
+    struct MemorySlot
+    {
+        GpuAllocation allocation;
+        VkDeviceSize size = 0;
+        VkDeviceSize alignment = 1;
+        uint32_t typeBits = ~0u;
+        std::vector<uint32_t> images; // Em ordem de primeiro uso
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    GpuAllocator *allocator = nullptr;
+    DeletionQueue *deletionQueue = nullptr;
+    QueueTimeline *timeline = nullptr;
+
+    std::vector<ResourceEntry> resources;
+    std::vector<Pass> passes;
+    std::vector<PhysicalImage> physicalImages;
+    std::vector<MemorySlot> slots;
+    VkDeviceSize unaliasedBytes = 0;
+
+    void allocateTransients(const std::vector<uint32_t> &transients);
+    void releaseTransients();
+    // Acrescenta ao lote a barreira que o acesso precisa a partir do estado atual do recurso
+    void transition(ResourceEntry &resource, VkImageLayout layout, VkPipelineStageFlags stage, VkAccessFlags access,
+                    bool write, std::vector<VkImageMemoryBarrier> &imageBarriers, VkMemoryBarrier &memoryBarrier,
+                    VkPipelineStageFlags &srcStages, VkPipelineStageFlags &dstStages);
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Um estágio de shader observado: o SPIR-V carregado pelo pipeline e, opcionalmente, o fonte que o gera
+struct ShaderFile
+{
+    std::string spirvPath;
+    std::string sourcePath; // GLSL ou HLSL (.hlsl); vazio quando o SPIR-V é gerado por outra ferramenta
+    VkShaderStageFlagBits stage;
+};
+
+// Recarga de shaders durante a execução, sem travar a thread de renderização
+//
+// Uma thread própria verifica periodicamente a data de modificação dos arquivos observados. Quando um fonte muda, ela o
+// compila para SPIR-V com o glslc; quando o SPIR-V muda, ela lê o código e constrói o pipeline novo com o PipelineBuilder
+// (que deve usar o cache de pipelines persistido). Nada disso acontece na thread de renderização: ela só chama
+// applyPending na fronteira entre quadros, que entrega os pipelines prontos ao PipelineSwap de cada registro.
+//
+// Um erro de compilação ou de criação do pipeline é informado e o pipeline atual continua em uso até a próxima alteração.
+class ShaderHotReload
+{
+public:
+    // Cria o pipeline a partir do SPIR-V de cada arquivo, na ordem do registro; chamado na thread de recarga
+    // Lança std::runtime_error em caso de falha
+    using PipelineBuilder = std::function<VkPipeline(const std::vector<std::vector<char>> &spirv)>;
+    // Recebe o pipeline novo na thread de renderização; o chamador passa a ser dono dele e destrói o antigo quando a GPU
+    // deixar de usá-lo. Devolve false quando descartou o pipeline novo (construído para um estado que já mudou)
+    using PipelineSwap = std::function<bool(VkPipeline pipeline)>;
+
+    ShaderHotReload() = default;
+    ~ShaderHotReload(); // Chama stop
+
+    ShaderHotReload(const ShaderHotReload &) = delete;
+    ShaderHotReload &operator=(const ShaderHotReload &) = delete;
+
+    // compilerPath vazio desativa a compilação: só mudanças no SPIR-V são recarregadas
+    void start(VkDevice device, const std::string &compilerPath, std::chrono::milliseconds pollInterval);
+    // Encerra a thread e destrói os pipelines que ainda não foram aplicados
+    void stop();
+
+    // Observa os arquivos de um pipeline; as datas atuais são a referência, então o registro não recarrega nada
+    void watch(const std::string &name, std::vector<ShaderFile> files, PipelineBuilder build, PipelineSwap swap);
+
+    // Entrega os pipelines reconstruídos desde a última chamada e devolve quantos foram aplicados
+    uint32_t applyPending();
+
+private:
+    using FileTime = std::filesystem::file_time_type;
+
+    struct Watch
+    {
+        std::string name;
+        std::vector<ShaderFile> files;
+        std::vector<FileTime> sourceTimes;
+        std::vector<FileTime> spirvTimes;
+        PipelineBuilder build;
+        PipelineSwap swap;
+    };
+
+    // Pipeline construído aguardando a fronteira de quadro
+    struct Ready
+    {
+        const Watch *watch;
+        VkPipeline pipeline;
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    std::string compilerPath;
+    std::chrono::milliseconds pollInterval{250};
+    std::thread worker;
+    bool running = false;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    // Os registros têm endereço estável: a thread de recarga os percorre sem o mutex e só ela altera as datas
+    std::vector<std::unique_ptr<Watch>> watches;
+    std::vector<Ready> ready;
+
+    void workerLoop();
+    // Verifica um registro e, se algo mudou, compila e reconstrói; chamado sem o mutex
+    void poll(Watch &watch);
+    bool compile(const ShaderFile &file) const;
+};
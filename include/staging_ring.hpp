@@ -0,0 +1,165 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include "gpu_allocator.hpp"
+#include "queue_timeline.hpp"
+
+// Região do anel reservada para um upload
+struct StagingRegion
+{
+    void *data = nullptr;    // Memória mapeada onde o chamador escreve os dados
+    VkDeviceSize offset = 0; // Deslocamento da região dentro do buffer do anel
+    VkDeviceSize size = 0;
+    uint64_t position = 0; // Início da região na posição monotônica do anel
+};
+
+// Cópia de uma região para um subrecurso de imagem (StagingRing::commitImage)
+struct StagingImageCopy
+{
+    VkBufferImageCopy copy; // bufferOffset relativo à região
+    VkImageSubresourceRange range;
+};
+
+// Resultado de StagingRing::flush: o que a submissão de gráficos do quadro precisa esperar
+struct StagingFlush
+{
+    uint64_t value = 0;                 // Valor da linha do tempo de transferência; 0 se nenhuma cópia foi submetida
+    VkPipelineStageFlags waitStage = 0; // Estágios que consomem os recursos enviados
+};
+
+// Anel de staging persistentemente mapeado para uploads em memória local ao dispositivo
+//
+// O chamador reserva uma região, escreve os dados diretamente na memória mapeada e enfileira a cópia para o recurso de
+// destino. Uma vez por quadro, flush grava todas as cópias pendentes em um único buffer de comando da fila de
+// transferência, com vkCmdCopyBuffer/vkCmdCopyBufferToImage agrupados por destino, e o submete na linha do tempo da fila
+// de transferência. A submissão de gráficos do mesmo quadro espera o valor devolvido e grava as barreiras de aquisição
+// (recordAcquireBarriers).
+//
+// O espaço é recuperado pela linha do tempo: beginFrame devolve ao anel tudo o que foi submetido por flushes cujas cópias
+// já terminaram. Não há buffers de staging temporários nem esperas por upload.
+// Todos os métodos são seguros entre threads. Uma thread que escreve a região enquanto a de renderização faz flush usa
+// tryReserve: até commitImage ou cancel, nenhum flush devolve ao anel o espaço a partir da reserva.
+class StagingRing
+{
+public:
+    static constexpr uint32_t MAX_FRAMES = 3;
+
+    // A fila de transferTimeline pertence a transferFamily; os recursos enviados passam a pertencer a graphicsFamily
+    void init(VkDevice device, GpuAllocator &allocator, VkDeviceSize capacity, uint32_t frameCount,
+              QueueTimeline &transferTimeline, uint32_t transferFamily, uint32_t graphicsFamily);
+    void destroy();
+
+    // Reserva size bytes alinhados a alignment; retorna false se o anel estiver cheio (tente depois do próximo quadro)
+    bool tryAllocate(VkDeviceSize size, VkDeviceSize alignment, StagingRegion &region);
+    // Como tryAllocate, mas lança std::runtime_error se não houver espaço
+    StagingRegion allocate(VkDeviceSize size, VkDeviceSize alignment = 16);
+
+    // Como tryAllocate, mas a região fica aberta até commitImage ou cancel (escrita fora da thread de renderização)
+    bool tryReserve(VkDeviceSize size, VkDeviceSize alignment, StagingRegion &region);
+    // Enfileira todas as cópias de uma reserva para uma imagem recém-criada, de uma vez, e fecha a reserva
+    void commitImage(const StagingRegion &region, VkImage image, const std::vector<StagingImageCopy> &copies,
+                     VkImageLayout finalLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+    // Fecha uma reserva sem cópias; o espaço volta ao anel com os flushes seguintes
+    void cancel(const StagingRegion &region);
+
+    // Enfileira a cópia de uma região para um buffer; dstStage/dstAccess descrevem o primeiro uso na fila de gráficos
+    // Buffers VK_SHARING_MODE_CONCURRENT (concurrent = true) não mudam de dono: basta esperar o valor do flush
+    void copyToBuffer(const StagingRegion &region, VkBuffer buffer, VkDeviceSize dstOffset,
+                      VkPipelineStageFlags dstStage, VkAccessFlags dstAccess, bool concurrent = false);
+
+    // Enfileira a cópia de uma região para uma imagem recém-criada (o conteúdo anterior é descartado)
+    // copy.bufferOffset é relativo à região; a imagem termina em finalLayout
+    void copyToImage(const StagingRegion &region, VkImage image, const VkBufferImageCopy &copy,
+                     const VkImageSubresourceRange &range, VkImageLayout finalLayout,
+                     VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+    // Recupera o espaço usado pelos flushes já concluídos na fila de transferência
+    void beginFrame();
+
+    // Submete as cópias pendentes na fila de transferência
+    // Inclui o que drain enviou desde o último flush: as aquisições e o valor a esperar vão para este quadro
+    StagingFlush flush(uint32_t frameIndex);
+
+    // Submete as cópias pendentes e bloqueia até terminarem, devolvendo o espaço ao anel; para uploads maiores que o
+    // anel fora do laço de quadros (na inicialização). Usa o buffer de comando de frameIndex
+    void drain(uint32_t frameIndex);
+
+    // Grava, no buffer de comando de gráficos do quadro, as aquisições correspondentes ao último flush
+    void recordAcquireBarriers(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    VkDeviceSize capacity() const { return ringSize; }
+
+private:
+    struct PendingBufferCopy
+    {
+        VkBuffer buffer;
+        VkBufferCopy copy;
+        VkPipelineStageFlags dstStage;
+        VkAccessFlags dstAccess;
+        bool concurrent;
+    };
+
+    struct PendingImageCopy
+    {
+        VkImage image;
+        VkBufferImageCopy copy;
+        VkImageSubresourceRange range;
+        VkImageLayout finalLayout;
+        VkPipelineStageFlags dstStage;
+        VkAccessFlags dstAccess;
+    };
+
+    struct FrameData
+    {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        uint64_t value = 0; // Valor da linha do tempo de transferência sinalizado pelo último flush deste quadro
+        uint64_t head = 0;  // Posição do anel no último flush deste quadro
+        std::vector<PendingBufferCopy> bufferAcquires;
+        std::vector<PendingImageCopy> imageAcquires;
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    GpuAllocator *allocator = nullptr;
+    QueueTimeline *transferTimeline = nullptr;
+    uint32_t transferFamily = 0;
+    uint32_t graphicsFamily = 0;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    GpuAllocation allocation;
+    VkDeviceSize ringSize = 0;
+
+    // Posições monotônicas em bytes: [tail, head) está em uso; a posição no buffer é o valor módulo ringSize
+    uint64_t head = 0;
+    uint64_t tail = 0;
+
+    std::vector<uint64_t> openReservations; // Posições das reservas de tryReserve ainda não fechadas
+
+    std::vector<PendingBufferCopy> pendingBuffers;
+    std::vector<PendingImageCopy> pendingImages;
+
+    // Enviado por drain e ainda não entregue a um quadro por flush
+    std::vector<PendingBufferCopy> drainedBuffers;
+    std::vector<PendingImageCopy> drainedImages;
+    uint64_t drainedValue = 0;
+    VkPipelineStageFlags drainedStage = 0;
+    std::array<FrameData, MAX_FRAMES> frames;
+    uint32_t frameCount = 0;
+
+    std::mutex mutex;
+
+    bool allocateLocked(VkDeviceSize size, VkDeviceSize alignment, StagingRegion &region);
+    void queueImageCopy(const StagingRegion &region, VkImage image, const VkBufferImageCopy &copy,
+                        const VkImageSubresourceRange &range, VkImageLayout finalLayout,
+                        VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+    void closeReservation(const StagingRegion &region);
+    // Grava e submete as cópias pendentes com o buffer de comando do quadro; as liberações de posse feitas vão para
+    // bufferAcquires/imageAcquires. Devolve os estágios que consomem os recursos
+    VkPipelineStageFlags submitPendingLocked(FrameData &frame, std::vector<PendingBufferCopy> &bufferAcquires,
+                                             std::vector<PendingImageCopy> &imageAcquires);
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Tempos das etapas da inicialização, medidos a partir da criação do objeto
+//
+// measure pode ser chamado de qualquer thread; o relatório mostra, para cada etapa, quando ela começou, quanto durou e
+// se rodou fora da thread principal, o que deixa visível o que de fato se sobrepôs.
+class StartupTimer
+{
+public:
+    // Uma etapa, com os tempos em relação à criação do objeto
+    struct Record
+    {
+        std::string name;
+        double startMilliseconds;
+        double durationMilliseconds;
+        bool worker;
+    };
+
+    StartupTimer() : start(Clock::now()), mainThread(std::this_thread::get_id()) {}
+
+    // Executa fn como a etapa name e devolve o seu resultado
+    template <typename Fn>
+    auto measure(const std::string &name, Fn &&fn)
+    {
+        Stage stage(*this, name);
+        return std::forward<Fn>(fn)();
+    }
+
+    // Imprime as etapas em ordem de início e o tempo total desde a criação
+    void report(std::ostream &out) const;
+
+    // Etapas em ordem de início
+    std::vector<Record> stages() const;
+    // Tempo desde a criação
+    double elapsedMilliseconds() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Registra a etapa no destrutor, inclusive quando fn lança uma exceção
+    class Stage
+    {
+    public:
+        Stage(StartupTimer &timer, std::string name) : timer(timer), name(std::move(name)), begin(Clock::now()) {}
+        ~Stage();
+
+    private:
+        StartupTimer &timer;
+        std::string name;
+        Clock::time_point begin;
+    };
+
+    Clock::time_point start;
+    std::thread::id mainThread;
+    mutable std::mutex mutex;
+    std::vector<Record> records;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Política de escolha do formato da superfície (formato e espaço de cores da cadeia de troca)
+enum class SurfaceFormatPolicy
+{
+    Auto,  // sRGB de 8 bits; HDR só com hdr10 ou scrgb
+    Sdr8,  // Só sRGB de 8 bits: a menor banda, comprimida por qualquer GPU de tiles
+    Sdr10, // sRGB com 10 bits por canal (menos bandas nos gradientes), com os mesmos 32 bits por pixel
+    Hdr10, // HDR10: PQ (ST 2084) com primárias BT.2020 em 10 bits por canal
+    ScRgb, // scRGB: sRGB linear estendido em ponto flutuante de 16 bits (64 bits por pixel)
+};
+
+// Codificação que o shader aplica à cor linear da cena antes de escrevê-la na imagem final
+// Os valores são os de OUTPUT_ENCODING em shader.frag e de PostPushConstants::outputEncoding em post.comp
+enum class OutputEncoding : uint32_t
+{
+    None = 0,  // Escrita linear: o formato _SRGB codifica no hardware, ou a imagem é lida de volta (sem janela)
+    Srgb = 1,  // sRGB não linear codificado no shader (formatos _UNORM)
+    Pq = 2,    // BT.709 -> BT.2020 e PQ, com o branco de referência em paperWhiteNits
+    ScRgb = 3, // Linear com 1.0 = 80 nits, com o branco de referência em paperWhiteNits
+};
+
+// Nome usado na linha de comando ("auto", "sdr8", "sdr10", "hdr10", "scrgb")
+const char *surfaceFormatPolicyName(SurfaceFormatPolicy policy);
+
+// Converte o nome da linha de comando; retorna false se não for conhecido
+bool parseSurfaceFormatPolicy(const std::string &name, SurfaceFormatPolicy &policy);
+
+// Verdadeiro se a política pode escolher espaços de cores de VK_EXT_swapchain_colorspace
+bool surfaceFormatPolicyWantsExtendedColorSpaces(SurfaceFormatPolicy policy);
+
+// Primeiro formato disponível na ordem de preferência da política, aceito por accept (por exemplo, imagens de
+// armazenamento). Cada política cai para as mais baratas: scrgb -> hdr10 -> sdr10 -> sdr8. Vazio se nenhum dos formatos
+// conhecidos estiver disponível
+std::optional<VkSurfaceFormatKHR> chooseSurfaceFormat(SurfaceFormatPolicy policy,
+                                                      const std::vector<VkSurfaceFormatKHR> &availableFormats,
+                                                      const std::function<bool(VkFormat)> &accept);
+
+// Codificação que o shader precisa aplicar para escrever no formato
+OutputEncoding outputEncodingFor(const VkSurfaceFormatKHR &surfaceFormat);
+
+// Descrição curta para o registro ("A2B10G10R10_UNORM / HDR10 ST2084")
+std::string surfaceFormatName(const VkSurfaceFormatKHR &surfaceFormat);
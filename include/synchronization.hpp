@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+// Caminho de sincronização escolhido por RendererPaths::synchronization2
+//
+// Os módulos descrevem as dependências com as estruturas originais (VkPipelineStageFlags, Vk*MemoryBarrier) e as gravam
+// por cmdPipelineBarrier, que usa vkCmdPipelineBarrier2 com VkDependencyInfo quando synchronization2 está ativo. Os bits
+// de estágio e de acesso originais têm o mesmo valor nos tipos *Flags2, então a conversão não muda o significado; o que
+// muda é que cada barreira leva os próprios estágios, e o driver recebe o caminho de barreiras do Vulkan 1.3.
+// QueueTimeline::submit consulta o mesmo estado para escolher entre vkQueueSubmit2 e vkQueueSubmit.
+
+// Ativado depois da criação do dispositivo, antes de qualquer gravação ou submissão
+void setSynchronization2Enabled(bool enabled);
+bool synchronization2Enabled();
+
+// Equivalente a vkCmdPipelineBarrier; srcStage e dstStage valem para todas as barreiras
+void cmdPipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage,
+                        VkDependencyFlags dependencyFlags,
+                        uint32_t memoryBarrierCount, const VkMemoryBarrier *memoryBarriers,
+                        uint32_t bufferBarrierCount, const VkBufferMemoryBarrier *bufferBarriers,
+                        uint32_t imageBarrierCount, const VkImageMemoryBarrier *imageBarriers);
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "asset_pack.hpp"
+#include "bindless_heap.hpp"
+#include "deletion_queue.hpp"
+#include "gpu_allocator.hpp"
+#include "job_system.hpp"
+#include "queue_timeline.hpp"
+#include "staging_ring.hpp"
+
+// Streaming de texturas de um contêiner de assets com orçamento de residência
+//
+// Os shaders não usam índices do heap bindless diretamente para texturas: usam um id lógico, traduzido pela tabela do
+// quadro (um storage buffer visível pela CPU por quadro em voo, cujo índice no heap é tableIndex). Assim o streamer troca
+// a imagem de uma textura por outra com mais ou menos mips sem tocar nos dados da cena.
+//
+// A cada quadro, request informa o tamanho na tela de cada textura visível; update converte isso no primeiro mip
+// desejado, distribui o orçamento por prioridade (maior tamanho na tela primeiro) e enfileira as mudanças de residência.
+// Quando o uso passa do orçamento, os mips maiores das texturas menos prioritárias são descartados primeiro; a cauda de
+// mips pequenos (até MIN_RESIDENT_SIZE) fica sempre residente.
+//
+// Trabalhos de segundo plano do JobSystem atendem a fila por prioridade: leem os mips da memória mapeada (a E/S
+// acontece aqui), criam a imagem nova e enfileiram as cópias no anel de staging. A troca na tabela é feita por update na
+// thread de renderização, e a imagem antiga vai para a DeletionQueue. Com o anel cheio, os trabalhos terminam e update
+// lança outros no quadro seguinte, em vez de ocuparem uma thread esperando.
+class TextureStreamer
+{
+public:
+    static constexpr uint32_t MIN_RESIDENT_SIZE = 64; // Maior lado dos mips que nunca são descartados
+
+    struct Settings
+    {
+        uint32_t loadJobs = 2; // Cargas simultâneas, cada uma em um trabalho de segundo plano
+        VkDeviceSize budgetBytes = 0; // 0: derivado do orçamento do heap local ao dispositivo
+        float budgetFraction = 0.9f;  // Parte do orçamento livre do heap que o streaming pode ocupar
+    };
+
+    struct Stats
+    {
+        VkDeviceSize residentBytes = 0;
+        VkDeviceSize budgetBytes = 0;
+        uint64_t loads = 0;     // Trocas que aumentaram a resolução
+        uint64_t evictions = 0; // Trocas que reduziram a resolução
+        uint64_t failures = 0;  // Cargas abandonadas por falta de memória de dispositivo
+        uint32_t pending = 0;
+    };
+
+    TextureStreamer() = default;
+    ~TextureStreamer(); // Não libera recursos Vulkan; destroy deve ser chamado antes
+
+    TextureStreamer(const TextureStreamer &) = delete;
+    TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+    // fallbackTexture: índice no heap usado por texturas que ainda não têm nenhum mip residente
+    // maxTextures limita os ids lógicos (tamanho das tabelas); jobs deve sobreviver ao streamer
+    void init(VkDevice device, GpuAllocator &allocator, StagingRing &stagingRing, BindlessHeap &heap,
+              const AssetPack &pack, VkSampler sampler, uint32_t fallbackTexture, uint32_t frameCount,
+              uint32_t maxTextures, const Settings &settings, JobSystem &jobs);
+    // Espera as cargas em andamento e destrói todas as texturas (o dispositivo deve estar ocioso)
+    void destroy();
+
+    // Registra uma textura que fica sempre carregada (não é do contêiner) e devolve o seu id lógico
+    uint32_t addResidentTexture(uint32_t heapIndex);
+    // Registra uma textura do contêiner para streaming e devolve o seu id lógico; nada é carregado até o próximo update
+    uint32_t addStreamedTexture(uint32_t packTexture);
+
+    // Maior lado, em pixels, que a textura ocupa na tela neste quadro (o maior dos pedidos do quadro vale)
+    void request(uint32_t texture, float screenSize);
+
+    // Chamado pela thread de renderização antes do flush do anel de staging: aplica as cargas concluídas (as cópias
+    // delas entram neste flush), recalcula as metas, lança os trabalhos de carga e escreve a tabela do quadro
+    // Relança a exceção de uma carga que falhou
+    void update(uint32_t frameIndex, QueueTimeline &graphicsTimeline, DeletionQueue &deletionQueue);
+
+    uint32_t tableIndex(uint32_t frameIndex) const { return tables[frameIndex].heapIndex; }
+    Stats stats() const;
+    std::string describe() const;
+
+private:
+    struct Texture
+    {
+        bool streamed = false;
+        uint32_t packTexture = 0;
+        AssetTextureRecord record{};
+        uint32_t minResidentBase = 0; // Primeiro mip da cauda sempre residente
+        uint32_t finestBase = 0;      // Maior mip que cabe no anel e que não falhou na alocação; os maiores não são pedidos
+
+        float screenSize = 0.0f; // Pedido do quadro atual
+        float priority = 0.0f;   // Pedido do último update
+        uint32_t targetBase = 0;
+        uint32_t residentBase = 0; // record.mipLevels: nada residente
+        bool queued = false;
+        bool loading = false;
+
+        VkImage image = VK_NULL_HANDLE;
+        GpuAllocation allocation;
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t heapIndex = INVALID_BINDLESS_INDEX;
+    };
+
+    // Carga concluída por um trabalho, aguardando a troca em update
+    struct Completed
+    {
+        uint32_t texture;
+        uint32_t base;
+        VkImage image;
+        GpuAllocation allocation;
+        VkImageView view;
+        uint32_t heapIndex;
+    };
+
+    struct Table
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        GpuAllocation allocation;
+        uint32_t heapIndex = INVALID_BINDLESS_INDEX;
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    GpuAllocator *allocator = nullptr;
+    StagingRing *stagingRing = nullptr;
+    BindlessHeap *heap = nullptr;
+    const AssetPack *pack = nullptr;
+    VkSampler sampler = VK_NULL_HANDLE;
+    uint32_t fallbackTexture = INVALID_BINDLESS_INDEX;
+    uint32_t maxTextures = 0;
+    Settings settings;
+    std::vector<Table> tables;
+
+    JobSystem *jobs = nullptr;
+    JobCounter loaders; // Trabalhos de carga em andamento
+
+    mutable std::mutex mutex;
+    bool running = false;
+    uint32_t activeLoaders = 0;
+    bool ringFull = false; // Uma carga não coube no anel; nenhuma outra é tentada até o próximo update
+    std::exception_ptr loadError;
+    std::vector<Texture> textures;
+    std::vector<uint32_t> queue; // Ids lógicos; os trabalhos de carga atendem o de maior prioridade
+    std::vector<Completed> completed;
+    Stats counters;
+
+    enum class LoadResult
+    {
+        Loaded,
+        RetryNextFrame, // Anel de staging cheio
+        Failed,         // Sem memória de dispositivo
+    };
+
+    // Corpo de um trabalho de carga: atende a fila até ela esvaziar, o anel encher ou o streamer ser destruído
+    void loadQueued();
+    // Carrega os mips [base, mipLevels) de uma textura; chamado sem o mutex
+    LoadResult load(const AssetTextureRecord &record, uint32_t packTexture, uint32_t base, Completed &result);
+    VkDeviceSize residentSize(const Texture &texture, uint32_t base) const;
+    // Bytes no anel para os mips [base, mipLevels), com o alinhamento entre mips
+    VkDeviceSize uploadSize(const AssetTextureRecord &record, uint32_t packTexture, uint32_t base) const;
+    void destroyImage(VkImage image, GpuAllocation &allocation, VkImageView view, uint32_t heapIndex);
+};
@@ -0,0 +1,68 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragTextureIndex;
+
+// Heap bindless (BindlessHeap): todas as texturas do renderizador, acessadas por índice
+layout(set = 0, binding = 1) uniform sampler2D textures[];
+// Tabelas do TextureStreamer no mesmo heap: id lógico da textura -> índice atual em textures
+layout(set = 0, binding = 0) readonly buffer TextureTable { uint heapIndices[]; } textureTables[];
+
+// DrawPushConstants
+layout(push_constant) uniform DrawPushConstants
+{
+    mat4 viewProjection;
+    uint instanceBufferIndex;
+    uint textureTableIndex;
+} draw;
+
+// Codificação da saída (OutputEncoding): 0 linear, 1 sRGB, 2 PQ (HDR10), 3 scRGB
+layout(constant_id = 0) const uint OUTPUT_ENCODING = 0;
+// Luminância do branco nas saídas HDR
+layout(constant_id = 1) const float PAPER_WHITE_NITS = 200.0;
+
+layout(location = 0) out vec4 outColor;
+
+vec3 encodeSrgb(vec3 color)
+{
+    return mix(color * 12.92, 1.055 * pow(color, vec3(1.0 / 2.4)) - 0.055, greaterThan(color, vec3(0.0031308)));
+}
+
+// Primárias BT.709 para BT.2020 e a curva PQ (ST 2084), com 1.0 = 10000 nits
+vec3 encodePq(vec3 color)
+{
+    const mat3 bt709ToBt2020 = mat3(0.6274, 0.0691, 0.0164,
+                                    0.3293, 0.9195, 0.0880,
+                                    0.0433, 0.0114, 0.8956);
+    vec3 y = clamp(bt709ToBt2020 * color * (PAPER_WHITE_NITS / 10000.0), 0.0, 1.0);
+    vec3 yPower = pow(y, vec3(0.1593017578125));
+    return pow((0.8359375 + 18.8515625 * yPower) / (1.0 + 18.6875 * yPower), vec3(78.84375));
+}
+
+vec3 encodeOutput(vec3 color)
+{
+    if (OUTPUT_ENCODING == 1)
+    {
+        return encodeSrgb(clamp(color, 0.0, 1.0));
+    }
+    if (OUTPUT_ENCODING == 2)
+    {
+        return encodePq(color);
+    }
+    if (OUTPUT_ENCODING == 3)
+    {
+        // scRGB: 1.0 corresponde a 80 nits
+        return color * (PAPER_WHITE_NITS / 80.0);
+    }
+    return color;
+}
+
+void main()
+{
+    // O índice varia entre instâncias, então a indexação não é uniforme
+    uint heapIndex = textureTables[draw.textureTableIndex].heapIndices[fragTextureIndex];
+    vec4 color = vec4(fragColor, 1.0) * texture(textures[nonuniformEXT(heapIndex)], fragTexCoord);
+    outColor = vec4(encodeOutput(color.rgb), color.a);
+}
@@ -0,0 +1,41 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+
+struct SceneInstance
+{
+    vec4 positionScale;
+    uint meshIndex;
+    uint materialIndex;
+    uint textureIndex;
+    float boundingRadius;
+};
+
+// Instâncias da cena no heap bindless; gl_InstanceIndex vem de firstInstance de cada desenho
+layout(set = 0, binding = 0) readonly buffer Instances { SceneInstance instances[]; } instanceBuffers[];
+
+// DrawPushConstants
+layout(push_constant) uniform DrawPushConstants
+{
+    mat4 viewProjection;
+    uint instanceBufferIndex;
+    uint textureTableIndex;
+} draw;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragTextureIndex;
+
+void main()
+{
+    SceneInstance instance = instanceBuffers[draw.instanceBufferIndex].instances[gl_InstanceIndex];
+    vec3 position = instance.positionScale.xyz + vec3(inPosition * instance.positionScale.w, 0.0);
+    gl_Position = draw.viewProjection * vec4(position, 1.0);
+    fragColor = inColor;
+    // Coordenadas de textura derivadas da posição: o triângulo cobre [-0.5, 0.5]
+    fragTexCoord = inPosition + 0.5;
+    // Id lógico; o fragment shader o traduz pela tabela do TextureStreamer
+    fragTextureIndex = instance.textureIndex;
+}
@@ -0,0 +1,326 @@
+#include "app_options.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "build_config.hpp"
+
+// Normaliza um UUID para 32 dígitos hexadecimais minúsculos, aceitando hífens como separadores
+static std::string normalizeUuid(const std::string &text)
+{
+    std::string uuid;
+    for (char c : text)
+    {
+        if (c == '-')
+        {
+            continue;
+        }
+        if (!std::isxdigit(static_cast<unsigned char>(c)))
+        {
+            throw std::runtime_error("invalid device UUID: " + text);
+        }
+        uuid.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+
+    if (uuid.size() != 32)
+    {
+        throw std::runtime_error("invalid device UUID (expected 32 hex digits): " + text);
+    }
+    return uuid;
+}
+
+// Converte o nome de uma política de apresentação
+static PresentPolicy presentPolicyFromName(const std::string &name)
+{
+    PresentPolicy policy;
+    if (!parsePresentPolicy(name, policy))
+    {
+        throw std::runtime_error("invalid present mode (expected immediate, mailbox, fifo or fifo-relaxed): " + name);
+    }
+    return policy;
+}
+
+// Converte o nome de uma política de formato da superfície
+static SurfaceFormatPolicy surfaceFormatPolicyFromName(const std::string &name)
+{
+    SurfaceFormatPolicy policy;
+    if (!parseSurfaceFormatPolicy(name, policy))
+    {
+        throw std::runtime_error("invalid surface format (expected auto, sdr8, sdr10, hdr10 or scrgb): " + name);
+    }
+    return policy;
+}
+
+// Lê a lista de modos de validação (ver ValidationOptions)
+static ValidationOptions parseValidation(const std::string &text)
+{
+    ValidationOptions validation;
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        size_t end = text.find(',', start);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+        std::string mode = text.substr(start, end - start);
+        start = end + 1;
+
+        if (mode == "off" || mode == "0")
+        {
+            validation = ValidationOptions{};
+        }
+        else if (mode == "on" || mode == "1")
+        {
+            validation.enabled = true;
+        }
+        else if (mode == "gpu")
+        {
+            validation.enabled = validation.gpuAssisted = true;
+        }
+        else if (mode == "best")
+        {
+            validation.enabled = validation.bestPractices = true;
+        }
+        else if (mode == "sync")
+        {
+            validation.enabled = validation.synchronization = true;
+        }
+        else if (mode == "verbose")
+        {
+            validation.enabled = validation.verbose = true;
+        }
+        else if (!mode.empty())
+        {
+            throw std::runtime_error("invalid validation mode (expected off, on, gpu, best, sync or verbose): " + mode);
+        }
+    }
+    return validation;
+}
+
+// Converte um inteiro sem sinal de 32 bits
+static uint32_t parseUnsigned(const char *name, const std::string &text)
+{
+    size_t end = 0;
+    unsigned long value = 0;
+    try
+    {
+        value = std::stoul(text, &end);
+    }
+    catch (const std::exception &)
+    {
+        end = 0;
+    }
+    if (end == 0 || end != text.size() || text[0] == '-' || value > UINT32_MAX)
+    {
+        throw std::runtime_error(std::string("invalid value for ") + name + ": " + text);
+    }
+    return static_cast<uint32_t>(value);
+}
+
+// Retorna o valor de uma opção no formato "--nome valor" ou "--nome=valor"
+// Retorna nullptr se arg não for a opção informada
+static const char *optionValue(const char *name, int argc, char **argv, int &i)
+{
+    size_t length = std::strlen(name);
+    const char *arg = argv[i];
+    if (std::strncmp(arg, name, length) != 0)
+    {
+        return nullptr;
+    }
+    if (arg[length] == '=')
+    {
+        return arg + length + 1;
+    }
+    if (arg[length] != '\0')
+    {
+        return nullptr;
+    }
+    if (i + 1 >= argc)
+    {
+        throw std::runtime_error(std::string("missing value for ") + name);
+    }
+    return argv[++i];
+}
+
+AppOptions parseAppOptions(int argc, char **argv, bool readEnvironment)
+{
+    AppOptions options;
+
+#ifdef NDEBUG
+    options.validation.enabled = false;
+#else
+    options.validation.enabled = true;
+#endif
+
+    // Valores padrão vindos do ambiente (não lidos por quem precisa de execuções reprodutíveis, como o vulkan_bench)
+    if (readEnvironment)
+    {
+        if (const char *env = std::getenv("VKT_DEVICE_UUID"); env != nullptr && *env != '\0')
+        {
+            options.deviceUuid = normalizeUuid(env);
+        }
+        if (const char *env = std::getenv("VKT_PRESENT_MODE"); env != nullptr && *env != '\0')
+        {
+            options.presentPolicy = presentPolicyFromName(env);
+        }
+        if (const char *env = std::getenv("VKT_SURFACE_FORMAT"); env != nullptr && *env != '\0')
+        {
+            options.surfaceFormatPolicy = surfaceFormatPolicyFromName(env);
+        }
+        if (const char *env = std::getenv("VKT_HEADLESS"); env != nullptr)
+        {
+            options.headless = std::strcmp(env, "1") == 0;
+        }
+        if (const char *env = std::getenv("VKT_VALIDATION"); env != nullptr && *env != '\0')
+        {
+            options.validation = parseValidation(env);
+        }
+        if (const char *env = std::getenv("VKT_TRACE"); env != nullptr && *env != '\0')
+        {
+            options.tracePath = env;
+        }
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *value = nullptr;
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0)
+        {
+            options.showHelp = true;
+        }
+        else if ((value = optionValue("--device-uuid", argc, argv, i)) != nullptr)
+        {
+            options.deviceUuid = normalizeUuid(value);
+        }
+        else if (std::strcmp(argv[i], "--headless") == 0)
+        {
+            options.headless = true;
+        }
+        else if ((value = optionValue("--frames", argc, argv, i)) != nullptr)
+        {
+            options.frameCount = parseUnsigned("--frames", value);
+        }
+        else if ((value = optionValue("--present-mode", argc, argv, i)) != nullptr)
+        {
+            options.presentPolicy = presentPolicyFromName(value);
+        }
+        else if ((value = optionValue("--surface-format", argc, argv, i)) != nullptr)
+        {
+            options.surfaceFormatPolicy = surfaceFormatPolicyFromName(value);
+        }
+        else if ((value = optionValue("--validation", argc, argv, i)) != nullptr)
+        {
+            options.validation = parseValidation(value);
+        }
+        else if ((value = optionValue("--trace", argc, argv, i)) != nullptr)
+        {
+            options.tracePath = value;
+        }
+        else if ((value = optionValue("--instances", argc, argv, i)) != nullptr)
+        {
+            options.instanceCount = parseUnsigned("--instances", value);
+            if (options.instanceCount == 0)
+            {
+                throw std::runtime_error("--instances must be at least 1");
+            }
+        }
+        else if ((value = optionValue("--windows", argc, argv, i)) != nullptr)
+        {
+            options.windowCount = parseUnsigned("--windows", value);
+            if (options.windowCount == 0)
+            {
+                throw std::runtime_error("--windows must be at least 1");
+            }
+        }
+        else if (std::strcmp(argv[i], "--cpu-draws") == 0)
+        {
+            options.cpuDraws = true;
+        }
+        else if (std::strcmp(argv[i], "--render-pass") == 0)
+        {
+            options.renderPassObjects = true;
+        }
+        else if (std::strcmp(argv[i], "--compute-post") == 0)
+        {
+            options.computePost = true;
+        }
+        else if ((value = optionValue("--dynamic-resolution", argc, argv, i)) != nullptr)
+        {
+            options.dynamicResolutionFps = parseUnsigned("--dynamic-resolution", value);
+        }
+        else if ((value = optionValue("--min-render-scale", argc, argv, i)) != nullptr)
+        {
+            options.minRenderScalePercent = parseUnsigned("--min-render-scale", value);
+            if (options.minRenderScalePercent < 10 || options.minRenderScalePercent > 100)
+            {
+                throw std::runtime_error("--min-render-scale must be between 10 and 100");
+            }
+        }
+        else if (std::strcmp(argv[i], "--shader-hot-reload") == 0)
+        {
+            options.shaderHotReload = true;
+        }
+        else if ((value = optionValue("--assets", argc, argv, i)) != nullptr)
+        {
+            options.assetPackPath = value;
+        }
+        else if ((value = optionValue("--streaming-budget", argc, argv, i)) != nullptr)
+        {
+            options.streamingBudgetMiB = parseUnsigned("--streaming-budget", value);
+        }
+        else if ((value = optionValue("--host-memory-limit", argc, argv, i)) != nullptr)
+        {
+            options.hostMemoryLimitMiB = parseUnsigned("--host-memory-limit", value);
+        }
+        else if ((value = optionValue("--job-threads", argc, argv, i)) != nullptr)
+        {
+            options.jobThreads = parseUnsigned("--job-threads", value);
+        }
+        else if (std::strcmp(argv[i], "--driver-allocator") == 0)
+        {
+            options.driverAllocator = true;
+        }
+        else
+        {
+            throw std::runtime_error(std::string("unknown option: ") + argv[i]);
+        }
+    }
+
+    // Sem a janela compilada (VKT_WINDOW_SUPPORT=OFF) só resta o modo sem janela
+    options.headless = HeadlessPolicy::use(options.headless);
+
+    return options;
+}
+
+void printAppUsage(const char *programName)
+{
+    std::cout << "usage: " << programName << " [options]\n"
+              << "  --device-uuid <uuid>   use the GPU with this UUID (env: VKT_DEVICE_UUID)\n"
+              << "  --present-mode <mode>  immediate, mailbox (default), fifo or fifo-relaxed; P cycles at runtime\n"
+              << "                         (env: VKT_PRESENT_MODE)\n"
+              << "  --surface-format <f>   auto (default: 8-bit sRGB), sdr8, sdr10, hdr10 or scrgb\n"
+              << "                         (env: VKT_SURFACE_FORMAT)\n"
+              << "  --headless             render offscreen without a window or swapchain (env: VKT_HEADLESS=1)\n"
+              << "  --frames <n>           exit after n frames (headless default: 1000)\n"
+              << "  --trace <file>         write a Chrome trace (chrome://tracing) on exit (env: VKT_TRACE)\n"
+              << "  --validation <list>    off, on, gpu, best, sync, verbose; comma separated (env: VKT_VALIDATION)\n"
+              << "  --instances <n>        number of scene instances (default: 1024)\n"
+              << "  --windows <n>          open n windows (one per monitor when available) on the same device\n"
+              << "  --cpu-draws            record one draw per instance on the CPU instead of GPU culling\n"
+              << "  --render-pass          use render pass and framebuffer objects instead of dynamic rendering\n"
+              << "  --compute-post         tonemap, FXAA and upscale in a compute shader writing the swapchain images\n"
+              << "  --dynamic-resolution <fps> scale the render resolution to keep the GPU frame time within 1/fps\n"
+              << "  --min-render-scale <n> smallest dynamic resolution scale, in percent of each side (default: 50)\n"
+              << "  --shader-hot-reload    recompile changed shaders and swap pipelines while running\n"
+              << "  --assets <file>        add the meshes and textures of a .vkpack asset container to the scene\n"
+              << "  --streaming-budget <n> device memory in MiB for streamed texture mips (default: heap budget)\n"
+              << "  --host-memory-limit <n> fail driver host allocations beyond n MiB (default: unlimited)\n"
+              << "  --driver-allocator     let the driver allocate host memory (no VkAllocationCallbacks)\n"
+              << "  --job-threads <n>      worker threads of the job system (default: one per free core)\n"
+              << "  -h, --help             show this message\n";
+}
@@ -0,0 +1,3739 @@
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// A projeção do Vulkan usa profundidade em [0, 1]
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <optional> // Disponível a partir do C++17
+#include <set>
+#include <map>
+#include <cstdint>   // uint32_t
+#include <limits>    // std::numeric_limits
+#include <algorithm> // std::clamp
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+
+#include "app_options.hpp"
+#include "application.hpp"
+#include "asset_pack.hpp"
+#include "async_logger.hpp"
+#include "bindless_heap.hpp"
+#include "build_config.hpp"
+#include "deletion_queue.hpp"
+#include "device_capabilities.hpp"
+#include "dynamic_resolution.hpp"
+#include "frame_profiler.hpp"
+#include "gpu_allocator.hpp"
+#include "gpu_culling.hpp"
+#include "host_allocator.hpp"
+#include "job_system.hpp"
+#include "parallel_recorder.hpp"
+#include "physical_device_cache.hpp"
+#include "pipeline_cache.hpp"
+#include "post_process.hpp"
+#include "present_policy.hpp"
+#include "queue_timeline.hpp"
+#include "render_graph.hpp"
+#include "shader_hot_reload.hpp"
+#include "staging_ring.hpp"
+#include "startup_timer.hpp"
+#include "surface_format.hpp"
+#include "synchronization.hpp"
+#include "texture_streamer.hpp"
+
+// Define a largura e altura da janela
+const uint32_t WIDTH = 800;
+const uint32_t HEIGHT = 600;
+// Distância do canto do monitor em que cada janela abre quando há mais de uma (--windows)
+const int WINDOW_MONITOR_OFFSET = 64;
+
+// Número de quadros que podem ser processados simultaneamente: a CPU grava o quadro N+1 enquanto a GPU executa o quadro N
+// Pode ser ajustado na configuração do CMake (-DMAX_FRAMES_IN_FLIGHT=3)
+#ifndef MAX_FRAMES_IN_FLIGHT_CONFIG
+#define MAX_FRAMES_IN_FLIGHT_CONFIG 2
+#endif
+const int MAX_FRAMES_IN_FLIGHT = MAX_FRAMES_IN_FLIGHT_CONFIG;
+static_assert(MAX_FRAMES_IN_FLIGHT >= 2 && MAX_FRAMES_IN_FLIGHT <= 3, "MAX_FRAMES_IN_FLIGHT must be 2 or 3");
+
+// Diretório com os shaders SPIR-V compilados (definido pelo CMake)
+#ifndef SHADER_DIR
+#define SHADER_DIR "shaders/"
+#endif
+// Fontes GLSL dos shaders e o compilador usados pela recarga de shaders (definidos pelo CMake)
+#ifndef SHADER_SOURCE_DIR
+#define SHADER_SOURCE_DIR "../shaders/"
+#endif
+#ifndef GLSLC_PATH
+#define GLSLC_PATH "glslc"
+#endif
+// Intervalo entre as verificações de alterações nos shaders
+const std::chrono::milliseconds SHADER_HOT_RELOAD_POLL_INTERVAL(250);
+
+// Arquivo onde o cache de pipelines é persistido entre execuções
+const char *PIPELINE_CACHE_FILE = "pipeline_cache.bin";
+
+// Capacidade do anel de staging usado para enviar dados à memória local ao dispositivo
+const VkDeviceSize STAGING_RING_SIZE = 32ull * 1024 * 1024;
+// Maior pedaço de um upload de inicialização; até metade do anel sempre cabe depois que ele é esvaziado por drain
+const VkDeviceSize STARTUP_UPLOAD_CHUNK_SIZE = STAGING_RING_SIZE / 4;
+// Tamanho de cada cópia dos uploads roteirizados (RunScript::uploadBytesPerFrame)
+const VkDeviceSize SCRIPTED_UPLOAD_CHUNK_SIZE = 1024 * 1024;
+
+// Com VK_KHR_present_wait, a CPU só começa um quadro quando o quadro de PRESENT_WAIT_LAG apresentações atrás já
+// estiver na tela; limita a fila de apresentação e, com ela, a latência entre a entrada e a imagem
+const uint64_t PRESENT_WAIT_LAG = 1;
+// Tempo máximo de espera por uma apresentação (evita travar se o compositor parar de exibir a janela)
+const uint64_t PRESENT_WAIT_TIMEOUT_NS = 100ull * 1000 * 1000;
+
+// Capacidade pedida para o heap bindless (limitada pelos limites do dispositivo)
+const uint32_t BINDLESS_MAX_STORAGE_BUFFERS = 4096;
+const uint32_t BINDLESS_MAX_TEXTURES = 16384;
+// Lado da textura xadrez gerada para o triângulo
+const uint32_t CHECKER_TEXTURE_SIZE = 64;
+
+// Cena: instâncias do triângulo em uma grade no plano XY, vista por uma câmera que a percorre
+const uint32_t SCENE_MATERIAL_COUNT = 1;
+const float SCENE_GRID_SPACING = 1.2f;
+const float CAMERA_DISTANCE = 6.0f;
+const float CAMERA_FOV_DEGREES = 60.0f;
+
+// Modo sem janela: formato das imagens fora da tela e quadros renderizados quando --frames não é informado
+const VkFormat OFFSCREEN_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+const uint32_t HEADLESS_DEFAULT_FRAMES = 1000;
+
+// Luminância do branco da cena nas saídas HDR (HDR10 e scRGB)
+const float HDR_PAPER_WHITE_NITS = 200.0f;
+// Escopo de GPU dos passes da cena: o único tempo que muda com a escala da resolução dinâmica
+const char *SCENE_GPU_SCOPE = "render pass";
+
+// Vetor que contém o nome da camada de validação que será usada
+// "VK_LAYER_KHRONOS_validation" é a camada padrão de validação
+const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
+// Vetor que contém o nome das extensões de dispositivo que serão usadas
+const std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+
+// Função auxiliar para criar o mensageiro de debug (Debug Utils Messenger)
+// O Vulkan não oferece diretamente esta função (é uma extensão)
+// então é necessário obter seu endereço em tempo de execução via vkGetInstanceProcAddr
+VkResult CreateDebugUtilsMessengerEXT(
+    VkInstance instance,
+    const VkDebugUtilsMessengerCreateInfoEXT *pCreateInfo,
+    const VkAllocationCallbacks *pAllocator,
+    VkDebugUtilsMessengerEXT *pDebugMessenger)
+{
+    // Obtém a função vkCreateDebugUtilsMessengerEXT usando vkGetInstanceProcAddr
+    auto func = (PFN_vkCreateDebugUtilsMessengerEXT)
+        vkGetInstanceProcAddr(instance, "vkCreateDebugUtilsMessengerEXT");
+
+    // Se essa função estiver disponível, invoca para criar o mensageiro de debug
+    if (func != nullptr)
+    {
+        return func(instance, pCreateInfo, pAllocator, pDebugMessenger);
+    }
+    else
+    {
+        // Retorna erro caso a extensão não esteja presente
+        return VK_ERROR_EXTENSION_NOT_PRESENT;
+    }
+}
+
+// Função auxiliar para destruir o mensageiro de debug (Debug Utils Messenger)
+// Também é obtida via vkGetInstanceProcAddr por ser uma extensão
+void DestroyDebugUtilsMessengerEXT(
+    VkInstance instance,
+    VkDebugUtilsMessengerEXT debugMessenger,
+    const VkAllocationCallbacks *pAllocator)
+{
+    auto func = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT");
+    // Se a função estiver disponível, invoca para destruir o mensageiro de debug
+    if (func != nullptr)
+    {
+        func(instance, debugMessenger, pAllocator);
+    }
+}
+
+// Estrutura que armazena os índices das famílias de fila de um dispositivo
+struct QueueFamilyIndices
+{
+    std::optional<uint32_t> graphicsFamily;
+    std::optional<uint32_t> presentFamily;
+    // Família dedicada a cópias (VK_QUEUE_TRANSFER_BIT sem gráficos), usada para uploads assíncronos
+    std::optional<uint32_t> transferFamily;
+    // Família de computação assíncrona (VK_QUEUE_COMPUTE_BIT sem gráficos)
+    std::optional<uint32_t> computeFamily;
+
+    // Transferência e computação são opcionais: sem famílias dedicadas o trabalho vai para a fila de gráficos
+    // Sem janela (presentRequired = false) a apresentação também é dispensada
+    bool isComplete(bool presentRequired = true)
+    {
+        return graphicsFamily.has_value() && (presentFamily.has_value() || !presentRequired);
+    }
+};
+
+// Estrutura que armazena os detalhes de suporte a cadeia de troca de um dispositivo
+struct SwapChainSupportDetails
+{
+    VkSurfaceCapabilitiesKHR capabilities;
+    std::vector<VkSurfaceFormatKHR> formats;
+    std::vector<VkPresentModeKHR> presentModes;
+};
+
+// Arquivos lidos em paralelo com a criação do dispositivo e consumidos pela criação dos pipelines
+struct StartupFiles
+{
+    std::vector<char> vertexShader;
+    std::vector<char> fragmentShader;
+    std::vector<char> cullShader;
+    std::vector<char> postShader;
+    std::vector<char> pipelineCache;
+};
+
+// Uma janela com a sua superfície e cadeia de troca. Todas as janelas usam o mesmo dispositivo, os mesmos pipelines
+// (portanto o mesmo formato de cor) e uma única chamada a vkQueuePresentKHR por quadro.
+// No modo sem janela há um único alvo sem janela, superfície nem cadeia de troca: swapChainImages são imagens fora da
+// tela, uma por quadro em voo
+struct PresentTarget
+{
+    GLFWwindow *window = nullptr;
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
+
+    VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+    std::vector<VkImage> swapChainImages;
+    std::vector<GpuAllocation> offscreenImageAllocations;
+    VkExtent2D swapChainExtent{};
+    std::vector<VkImageView> swapChainImageViews;
+    std::vector<VkFramebuffer> swapChainFramebuffers;
+
+    // Por quadro em voo: sinalizado quando a imagem adquirida deste alvo estiver disponível
+    std::vector<VkSemaphore> imageAvailableSemaphores;
+    // O semáforo de renderização concluída é indexado pela imagem da cadeia de troca, pois só pode ser reutilizado
+    // depois que a apresentação daquela imagem terminar (o que nenhuma espera pelo quadro garante)
+    std::vector<VkSemaphore> renderFinishedSemaphores;
+    // Valor da linha do tempo de gráficos do quadro que está usando cada imagem da cadeia de troca (0: nenhum)
+    std::vector<uint64_t> imagesInFlight;
+    uint64_t presentId = 0; // Última identificação usada na cadeia de troca atual
+    // Com VK_EXT_swapchain_maintenance1: cercas das apresentações da cadeia atual que ainda não terminaram
+    std::vector<VkFence> presentFences;
+
+    // A cadeia de troca precisa ser recriada (redimensionamento, cadeia desatualizada ou troca de política)
+    bool framebufferResized = false;
+    // Janela minimizada: fica fora dos quadros até voltar a ter tamanho
+    bool minimized = false;
+
+    // Câmera do quadro com a proporção deste alvo
+    glm::mat4 viewProjection{1.0f};
+};
+
+// Vértice quantizado com posição 2D (SNORM de 16 bits) e cor (RGBA8), no layout lido pelo shader de vértices
+// As malhas dos contêineres de assets com este mesmo layout são enviadas sem conversão
+struct Vertex
+{
+    int16_t pos[2];
+    uint8_t color[4];
+
+    // Um único binding com os vértices intercalados
+    static VkVertexInputBindingDescription getBindingDescription()
+    {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(Vertex);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescription;
+    }
+
+    // location 0: posição, location 1: cor
+    static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions()
+    {
+        std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R16G16_SNORM;
+        attributeDescriptions[0].offset = offsetof(Vertex, pos);
+
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = VK_FORMAT_R8G8B8A8_UNORM;
+        attributeDescriptions[1].offset = offsetof(Vertex, color);
+        return attributeDescriptions;
+    }
+};
+
+// Converte uma coordenada em [-1, 1] para SNORM de 16 bits
+constexpr int16_t toSnorm16(float value)
+{
+    return static_cast<int16_t>(value * 32767.0f + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+const std::vector<Vertex> vertices = {
+    {{toSnorm16(0.0f), toSnorm16(-0.5f)}, {255, 0, 0, 255}},
+    {{toSnorm16(0.5f), toSnorm16(0.5f)}, {0, 255, 0, 255}},
+    {{toSnorm16(-0.5f), toSnorm16(0.5f)}, {0, 0, 255, 255}}};
+// Raio da esfera envolvente do triângulo em torno da origem
+const float TRIANGLE_BOUNDING_RADIUS = 0.7072f;
+
+const std::vector<uint16_t> indices = {0, 1, 2};
+
+// Push constants dos desenhos: a câmera e os índices, no heap bindless, do buffer de instâncias e da tabela de texturas
+// do quadro (mesmo layout do bloco push_constant de shader.vert e shader.frag)
+struct DrawPushConstants
+{
+    glm::mat4 viewProjection;
+    uint32_t instanceBufferIndex;
+    uint32_t textureTableIndex;
+};
+
+class HelloTriangleApplication
+{
+public:
+    HelloTriangleApplication(const AppOptions &options, const RunScript &script)
+        : options(options), script(script), enableValidationLayers(ValidationPolicy::use(options.validation.enabled)),
+          presentPolicy(options.presentPolicy) {}
+
+    RunReport run()
+    {
+        initVulkan();
+        mainLoop();
+        cleanup();
+        return report;
+    }
+
+private:
+    // Caminhos resolvidos pelas políticas de BuildConfig: constantes quando só uma das alternativas foi compilada, e
+    // então os ramos da outra somem das funções do quadro
+    bool headless() const { return HeadlessPolicy::use(options.headless); }
+    bool useDynamicRendering() const { return DynamicRenderingPolicy::use(rendererPaths.dynamicRendering); }
+    bool useGpuDrivenDraws() const { return GpuDrivenPolicy::use(gpuDrivenDraws); }
+    // Estágio do primeiro uso da imagem adquirida, em que o semáforo de aquisição é esperado: com pós-processamento a
+    // cena é desenhada antes da aquisição terminar e só o compute shader espera
+    VkPipelineStageFlags backbufferFirstStage() const
+    {
+        return postProcessing ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    }
+
+    AppOptions options;
+    RunScript script;
+    // Medidas da execução, devolvidas por run
+    RunReport report;
+    // Threads de trabalho do motor; declarado antes dos subsistemas que lançam trabalhos, então é destruído depois deles
+    JobSystem jobs;
+
+    // Camadas de validação, escolhidas em tempo de execução (padrão: ligadas em builds de debug)
+    bool enableValidationLayers;
+    // As mensagens das camadas são escritas por uma thread própria, sem bloquear a thread que chamou o Vulkan
+    AsyncLogger validationLog;
+
+    // Memória do host pedida pelo driver (VkAllocationCallbacks), instalada antes da instância
+    HostAllocator hostAllocator;
+
+    VkInstance instance;
+    uint32_t instanceApiVersion = VK_API_VERSION_1_1; // Versão pedida em VkApplicationInfo
+    VkDebugUtilsMessengerEXT debugMessenger;
+
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    PhysicalDeviceCache physicalDeviceCache;
+    // Recursos habilitados no dispositivo lógico e os caminhos do renderizador escolhidos a partir deles
+    DeviceCapabilities deviceCapabilities;
+    RendererPaths rendererPaths;
+    VkDevice device;
+
+    VkQueue graphicsQueue;
+    VkQueue presentQueue;
+    // Filas assíncronas; sem família dedicada apontam para a fila de gráficos
+    VkQueue transferQueue;
+    VkQueue computeQueue;
+
+    // Famílias de fila do dispositivo lógico (ver transferQueueFamily/computeQueueFamily para as filas assíncronas)
+    QueueFamilyIndices queueFamilyIndices;
+    uint32_t transferQueueFamily;
+    uint32_t computeQueueFamily;
+
+    // Uma linha do tempo por fila: cada submissão sinaliza o próximo valor, e esperar pelo trabalho (na CPU ou em outra
+    // fila) é esperar por um valor. A apresentação não tem uma própria, pois só aceita semáforos binários
+    QueueTimeline graphicsTimeline;
+    QueueTimeline transferTimeline;
+    QueueTimeline computeTimeline;
+    // Mutex de cada VkQueue distinta, compartilhado pelas linhas do tempo que apontam para ela e pela apresentação
+    QueueLocks queueLocks;
+    std::mutex *presentQueueMutex = nullptr;
+    // Objetos destruídos quando a linha do tempo da fila que os usou alcançar o último uso
+    DeletionQueue deletionQueue;
+    // Passes do quadro com barreiras e memória das imagens transitórias deduzidas dos acessos declarados
+    RenderGraph renderGraph;
+
+    // Única rota para memória de dispositivo (VkDeviceMemory)
+    GpuAllocator allocator;
+    // Uploads para memória local ao dispositivo, submetidos uma vez por quadro na fila de transferência
+    StagingRing stagingRing;
+
+    VkBuffer vertexBuffer;
+    GpuAllocation vertexBufferAllocation;
+    VkBuffer indexBuffer;
+    GpuAllocation indexBufferAllocation;
+
+    // Conjunto de descritores global: todos os recursos dos shaders são acessados por índice
+    BindlessHeap bindlessHeap;
+    VkImage checkerTexture;
+    GpuAllocation checkerTextureAllocation;
+    VkImageView checkerTextureView;
+    VkSampler textureSampler;
+    uint32_t checkerTextureIndex = INVALID_BINDLESS_INDEX;
+
+    // Contêiner de assets (--assets); fica mapeado enquanto o streamer lê os mips das texturas
+    AssetPack assetPack;
+    // As instâncias usam ids lógicos de textura, traduzidos para o heap pela tabela do quadro
+    TextureStreamer textureStreamer;
+
+    // Instâncias e malhas da cena, lidas pelos shaders via heap bindless (cópia na CPU para a seleção sem GPU)
+    std::vector<SceneInstance> sceneInstances;
+    std::vector<SceneMesh> sceneMeshes;
+    std::vector<float> sceneMeshRadii;         // Esfera envolvente de cada malha, no espaço do modelo
+    std::vector<uint32_t> sceneTextureIndices; // Ids lógicos das texturas usadas pelas instâncias (a xadrez e as do contêiner)
+    VkBuffer instanceBuffer;
+    GpuAllocation instanceBufferAllocation;
+    VkBuffer meshBuffer;
+    GpuAllocation meshBufferAllocation;
+    uint32_t instanceBufferIndex = INVALID_BINDLESS_INDEX;
+    uint32_t meshBufferIndex = INVALID_BINDLESS_INDEX;
+
+    // Com gpuDrivenDraws, um compute shader seleciona as instâncias e gera os desenhos indiretos
+    GpuCulling gpuCulling;
+    bool gpuDrivenDraws = false; // Lido por useGpuDrivenDraws
+    // Com --compute-post, a cena é desenhada em uma transitória do grafo e o pós-processamento escreve a imagem final
+    PostProcess postProcess;
+    bool postProcessing = false; // Decidido na primeira cadeia de troca (ou nas imagens fora da tela)
+    // Com --dynamic-resolution, a cena ocupa só um retângulo da transitória, ampliado pelo pós-processamento
+    DynamicResolution dynamicResolution;
+    bool dynamicResolutionEnabled = false;
+    // Câmera do quadro sendo gravado (a matriz de cada janela fica em PresentTarget::viewProjection)
+    glm::vec3 cameraPosition{0.0f};
+    Frustum frustum{};
+    std::chrono::steady_clock::time_point sceneStartTime = std::chrono::steady_clock::now();
+    uint64_t sceneFrame = 0; // Quadros gravados, para o passo fixo da câmera (RunScript::fixedTimestep)
+
+    // Destino dos uploads roteirizados (RunScript::uploadBytesPerFrame)
+    VkBuffer scriptedUploadBuffer = VK_NULL_HANDLE;
+    GpuAllocation scriptedUploadAllocation;
+    VkDeviceSize scriptedUploadSize = 0; // Tamanho do buffer e teto de bytes enviados por quadro
+    VkDeviceSize scriptedUploadOffset = 0;
+    bool scriptedUploadConcurrent = false;
+
+    // Janelas (--windows) ou, no modo sem janela, o alvo fora da tela
+    std::vector<PresentTarget> presentTargets;
+    // Alvos renderizados no quadro atual (os não minimizados cuja aquisição deu certo) e a imagem adquirida de cada um
+    struct FrameImage
+    {
+        PresentTarget *target;
+        uint32_t imageIndex;
+    };
+    std::vector<FrameImage> frameImages;
+    // Formato de cor e espaço de cores de todas as cadeias de troca, escolhidos na primeira; só mudam quando uma superfície
+    // deixa de oferecê-los (recreateFormatDependentPipelines)
+    VkFormat swapChainImageFormat = VK_FORMAT_UNDEFINED;
+    VkColorSpaceKHR swapChainColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    // Codificação da cor linear para o formato escolhido; aplicada pelo fragment shader ou pelo pós-processamento
+    OutputEncoding outputEncoding = OutputEncoding::None;
+    // Formato em que a cena é desenhada (o dos pipelines): o da cadeia de troca ou, com pós-processamento,
+    // PostProcess::SCENE_COLOR_FORMAT
+    VkFormat sceneColorFormat = VK_FORMAT_UNDEFINED;
+    // Verdadeiro enquanto as outras janelas são recriadas para o formato novo; uma segunda troca não tem formato comum
+    bool recreatingForFormatChange = false;
+
+    VkRenderPass renderPass;
+    VkPipelineLayout pipelineLayout;
+    VkPipeline graphicsPipeline;
+    // O que buildGraphicsPipeline usa e que pode mudar durante a execução. A thread de recarga de shaders constrói a
+    // partir desta cópia, nunca dos membros acima (que createSwapChain altera); a geração avança a cada troca de formato
+    struct GraphicsPipelineInputs
+    {
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        VkFormat sceneColorFormat = VK_FORMAT_UNDEFINED;
+        OutputEncoding outputEncoding = OutputEncoding::None;
+        uint64_t generation = 0;
+    };
+    // Protege graphicsPipelineInputs e reloadedGraphicsGenerations. A thread de recarga o segura durante toda a
+    // construção, então o passe da cópia não é substituído nem destruído enquanto está em uso
+    std::mutex graphicsPipelineMutex;
+    GraphicsPipelineInputs graphicsPipelineInputs;
+    // Geração para a qual cada pipeline recarregado foi construído, até ser entregue à thread de renderização
+    std::map<VkPipeline, uint64_t> reloadedGraphicsGenerations;
+    PipelineCache pipelineCache;
+    StartupFiles startupFiles; // Válido apenas durante initVulkan
+    StartupTimer startupTimer;
+    // Reconstrói os pipelines em segundo plano quando os shaders mudam (--shader-hot-reload)
+    ShaderHotReload shaderHotReload;
+
+    VkCommandPool commandPool;
+    // Um buffer de comando por quadro em voo, para que a CPU possa gravar um quadro enquanto a GPU executa o anterior
+    std::vector<VkCommandBuffer> commandBuffers;
+    // Grava os desenhos em buffers secundários, em paralelo, executados pelo buffer primário do quadro
+    ParallelRecorder recorder;
+    // Número de desenhos do quadro no caminho de CPU (um por instância)
+    uint32_t sceneDrawCount = 1;
+
+    // Tempos de CPU e GPU do laço de quadros
+    FrameProfiler profiler;
+
+    // Valor da linha do tempo de gráficos sinalizado pela última submissão de cada quadro em voo (0: nenhuma)
+    // (os semáforos de aquisição e apresentação ficam em cada PresentTarget)
+    std::vector<uint64_t> frameTimelineValues;
+    uint32_t currentFrame = 0;
+
+    // Política de apresentação atual; alterá-la recria a cadeia de troca
+    PresentPolicy presentPolicy;
+    bool presentPolicyChanged = false;
+    // VK_KHR_present_id + VK_KHR_present_wait: identificam cada apresentação e permitem esperar que ela chegue à tela
+    bool presentWaitEnabled = false;
+    PFN_vkWaitForPresentKHR pfnWaitForPresentKHR = nullptr;
+    // VK_EXT_surface_maintenance1 (e VK_KHR_get_surface_capabilities2) habilitadas na instância
+    bool surfaceMaintenanceAvailable = false;
+    // VK_EXT_swapchain_maintenance1: cada apresentação sinaliza uma cerca quando termina de esperar pelos semáforos, o
+    // único jeito de saber que os semáforos e a cadeia de troca substituída podem ser destruídos
+    bool presentFencesEnabled = false;
+    std::vector<VkFence> freePresentFences; // Cercas não sinalizadas prontas para reúso
+    // Semáforos e cadeia de troca substituídos, destruídos quando as cercas das apresentações que os usaram sinalizarem
+    struct RetiredSwapChain
+    {
+        std::vector<VkFence> presentFences;
+        std::function<void()> destroy;
+    };
+    std::vector<RetiredSwapChain> retiredSwapChains;
+    // VK_EXT_memory_budget: orçamento e uso de cada heap informados pelo driver
+    bool memoryBudgetEnabled = false;
+
+    // Inicializa as janelas GLFW (--windows); glfwInit já foi chamado por initVulkan
+    // Com mais de um monitor, a janela i abre no monitor i
+    void initWindow()
+    {
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API); // Evita a criação de um contexto OpenGL
+        glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);    // Permite redimensionamento (a cadeia de troca é recriada)
+
+        int monitorCount = 0;
+        GLFWmonitor **monitors = glfwGetMonitors(&monitorCount);
+
+        presentTargets.resize(options.windowCount);
+        for (uint32_t i = 0; i < options.windowCount; i++)
+        {
+            std::string title = options.windowCount > 1 ? "Vulkan " + std::to_string(i + 1) : "Vulkan";
+            VkExtent2D extent = initialExtent();
+            GLFWwindow *window = glfwCreateWindow(static_cast<int>(extent.width), static_cast<int>(extent.height),
+                                                  title.c_str(), nullptr, nullptr);
+            if (window == nullptr)
+            {
+                throw std::runtime_error("failed to create window!");
+            }
+            presentTargets[i].window = window;
+
+            if (options.windowCount > 1 && static_cast<int>(i) < monitorCount)
+            {
+                int x = 0, y = 0;
+                glfwGetMonitorPos(monitors[i], &x, &y);
+                glfwSetWindowPos(window, x + WINDOW_MONITOR_OFFSET, y + WINDOW_MONITOR_OFFSET);
+            }
+
+            // Registra a aplicação na janela para que os callbacks possam acessá-la
+            glfwSetWindowUserPointer(window, this);
+            glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);
+            glfwSetKeyCallback(window, keyCallback);
+        }
+    }
+
+    // Callback de teclado: P alterna a política de apresentação
+    static void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods)
+    {
+        auto app = reinterpret_cast<HelloTriangleApplication *>(glfwGetWindowUserPointer(window));
+        if (key == GLFW_KEY_P && action == GLFW_PRESS)
+        {
+            app->presentPolicy = nextPresentPolicy(app->presentPolicy);
+            app->presentPolicyChanged = true;
+        }
+    }
+
+    // Callback chamado pelo GLFW quando o framebuffer de uma janela é redimensionado
+    static void framebufferResizeCallback(GLFWwindow *window, int width, int height)
+    {
+        auto app = reinterpret_cast<HelloTriangleApplication *>(glfwGetWindowUserPointer(window));
+        for (auto &target : app->presentTargets)
+        {
+            if (target.window == window)
+            {
+                target.framebufferResized = true;
+            }
+        }
+    }
+
+    // Fechar qualquer janela encerra a aplicação
+    bool anyWindowShouldClose() const
+    {
+        for (const auto &target : presentTargets)
+        {
+            if (glfwWindowShouldClose(target.window))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Inicializa a janela e o Vulkan
+    // O que não depende do dispositivo (arquivos de shaders e do cache de pipelines, o contêiner de assets e a instância)
+    // roda em trabalhos do JobSystem enquanto a thread principal abre a janela e cria o dispositivo. No fim, imprime quanto
+    // levou cada etapa
+    void initVulkan()
+    {
+        // Antes de qualquer objeto: todos são criados e destruídos com os mesmos callbacks
+        if (!options.driverAllocator)
+        {
+            hostAllocator.install(uint64_t(options.hostMemoryLimitMiB) * 1024 * 1024);
+        }
+
+        jobs.init(options.jobThreads);
+        std::cout << "jobs: " << jobs.threadCount() - 1 << " worker threads" << std::endl;
+
+        // Trabalhos de segundo plano: a thread principal não os executa enquanto espera, então segue abrindo a janela
+        JobCounter files;
+        jobs.run([this]
+                 { startupFiles = startupTimer.measure("load shaders and cache", [this] { return loadStartupFiles(); }); },
+                 &files, JobPriority::Background);
+        JobCounter assets;
+        jobs.run([this] { startupTimer.measure("open asset pack", [this] { openAssetPack(); }); }, &assets,
+                 JobPriority::Background);
+
+        if (enableValidationLayers)
+        {
+            validationLog.start(std::cerr, AsyncLogger::Limits{});
+        }
+        // glfwGetRequiredInstanceExtensions (usada por createInstance) exige glfwInit, mas pode ser chamada de outra
+        // thread; a janela precisa ser criada na thread principal
+        if (!headless())
+        {
+            glfwInit();
+        }
+        JobCounter instanceReady;
+        jobs.run([this]
+                 { startupTimer.measure("create instance", [this]
+                                        {
+                                            createInstance();
+                                            setupDebugMessenger();
+                                        }); },
+                 &instanceReady, JobPriority::Background);
+        if (!headless())
+        {
+            startupTimer.measure("create window", [this] { initWindow(); });
+        }
+        jobs.wait(instanceReady);
+
+        startupTimer.measure("select device", [this]
+                             {
+                                 if (!headless())
+                                 {
+                                     createSurfaces();
+                                 }
+                                 pickPhysicalDevice();
+                             });
+        startupTimer.measure("create device", [this]
+                             {
+                                 createLogicalDevice();
+                                 createQueueTimelines();
+                                 allocator.init(physicalDevice, device, memoryBudgetEnabled);
+                             });
+        startupTimer.measure("create swap chain", [this]
+                             {
+                                 if (headless())
+                                 {
+                                     presentTargets.resize(1);
+                                     createOffscreenTargets(presentTargets[0]);
+                                 }
+                                 for (auto &target : presentTargets)
+                                 {
+                                     if (!headless())
+                                     {
+                                         createSwapChain(target);
+                                     }
+                                     createImageViews(target);
+                                 }
+                             });
+
+        jobs.wait(files);
+        startupTimer.measure("create pipelines", [this]
+                             {
+                                 createPipelineCache();
+                                 createBindlessHeap();
+                                 createRenderPass();
+                                 createGraphicsPipeline();
+                                 createPostProcess();
+                             });
+        startupTimer.measure("create frame resources", [this]
+                             {
+                                 for (auto &target : presentTargets)
+                                 {
+                                     createFramebuffers(target);
+                                 }
+                                 createCommandPool();
+                                 createCommandBuffers();
+                                 createParallelRecorder();
+                                 createProfiler();
+                                 createRenderGraph();
+                                 createStagingRing();
+                             });
+
+        jobs.wait(assets);
+        if (assetPack.isOpen())
+        {
+            std::cout << "assets: " << options.assetPackPath << " (" << assetPack.meshCount() << " meshes, "
+                      << assetPack.textureCount() << " textures)" << std::endl;
+        }
+        startupTimer.measure("create scene", [this]
+                             {
+                                 createSceneGeometry();
+                                 createTextureSampler();
+                                 createCheckerTexture();
+                                 createTextureStreamer();
+                                 createScene();
+                                 createGpuCulling();
+                                 createScriptedUploadBuffer();
+                             });
+        startupTimer.measure("create sync objects", [this]
+                             {
+                                 createSyncObjects();
+                                 for (auto &target : presentTargets)
+                                 {
+                                     createSwapChainSemaphores(target);
+                                 }
+                                 createShaderHotReload();
+                             });
+        startupFiles = {};
+
+        report.startupMilliseconds = startupTimer.elapsedMilliseconds();
+        report.startupStages = startupTimer.stages();
+        report.rendererPaths = rendererPaths.describe();
+        report.gpuDrivenDraws = useGpuDrivenDraws();
+        startupTimer.report(std::cout);
+    }
+
+    // Loop principal da aplicação
+    void mainLoop()
+    {
+        if (headless())
+        {
+            runOffscreenFrames();
+            return;
+        }
+
+        auto loopStart = std::chrono::steady_clock::now();
+        auto lastTitleUpdate = loopStart;
+        auto lastFrameEnd = loopStart;
+        uint64_t framesDrawn = 0;
+        while (!anyWindowShouldClose() && (options.frameCount == 0 || framesDrawn < options.frameCount))
+        {
+            framesDrawn++;
+            hostAllocator.beginFrame();
+            glfwPollEvents();
+            drawFrame();
+            jobs.frameBarrier();
+            profiler.endFrame();
+
+            auto now = std::chrono::steady_clock::now();
+            report.frameMilliseconds.push_back(std::chrono::duration<double, std::milli>(now - lastFrameEnd).count());
+            lastFrameEnd = now;
+
+            // Mostra os percentis no título das janelas duas vezes por segundo
+            if (now - lastTitleUpdate >= std::chrono::milliseconds(500))
+            {
+                std::string summary = profiler.summary();
+                for (size_t i = 0; i < presentTargets.size(); i++)
+                {
+                    std::string title = presentTargets.size() > 1 ? "Vulkan " + std::to_string(i + 1) : "Vulkan";
+                    glfwSetWindowTitle(presentTargets[i].window, (title + " - " + summary).c_str());
+                }
+                lastTitleUpdate = now;
+            }
+        }
+
+        // Aguarda a GPU terminar os quadros em voo antes de liberar os recursos
+        vkDeviceWaitIdle(device);
+        report.loopSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loopStart).count();
+    }
+
+    // Laço sem janela: renderiza um número fixo de quadros o mais rápido possível e informa a vazão
+    void runOffscreenFrames()
+    {
+        uint32_t frameCount = options.frameCount != 0 ? options.frameCount : HEADLESS_DEFAULT_FRAMES;
+
+        auto start = std::chrono::steady_clock::now();
+        auto lastFrameEnd = start;
+        for (uint32_t i = 0; i < frameCount; i++)
+        {
+            hostAllocator.beginFrame();
+            drawFrame();
+            jobs.frameBarrier();
+            profiler.endFrame();
+
+            auto now = std::chrono::steady_clock::now();
+            report.frameMilliseconds.push_back(std::chrono::duration<double, std::milli>(now - lastFrameEnd).count());
+            lastFrameEnd = now;
+        }
+        // O tempo inclui a conclusão do último quadro na GPU
+        vkDeviceWaitIdle(device);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.loopSeconds = seconds;
+
+        std::cout << "headless: " << frameCount << " frames in " << std::fixed << std::setprecision(3) << seconds << " s ("
+                  << std::setprecision(1) << frameCount / seconds << " frames/s)" << std::defaultfloat << std::endl;
+    }
+
+    // Limpa os recursos alocados
+    void cleanup()
+    {
+        // Nenhum pipeline novo pode ser criado enquanto os objetos que ele usa são destruídos
+        shaderHotReload.stop();
+
+        // Limpa os objetos de sincronização
+        for (auto &target : presentTargets)
+        {
+            for (auto semaphore : target.imageAvailableSemaphores)
+            {
+                vkDestroySemaphore(device, semaphore, hostAllocationCallbacks());
+            }
+        }
+
+        profiler.printReport();
+        profiler.destroy();
+
+        // Os buffers de comando são liberados junto com os pools
+        recorder.destroy();
+        vkDestroyCommandPool(device, commandPool, hostAllocationCallbacks());
+
+        // O dispositivo já está ocioso, então tudo o que foi adiado (como as cadeias de troca antigas) pode ser destruído
+        deletionQueue.flush();
+        for (auto &retired : retiredSwapChains)
+        {
+            retired.destroy();
+            freePresentFences.insert(freePresentFences.end(), retired.presentFences.begin(), retired.presentFences.end());
+        }
+        retiredSwapChains.clear();
+        for (auto &target : presentTargets)
+        {
+            freePresentFences.insert(freePresentFences.end(), target.presentFences.begin(), target.presentFences.end());
+            target.presentFences.clear();
+        }
+        for (auto fence : freePresentFences)
+        {
+            vkDestroyFence(device, fence, hostAllocationCallbacks());
+        }
+        freePresentFences.clear();
+        std::cout << renderGraph.describe() << std::endl;
+        renderGraph.destroy();
+        for (auto &target : presentTargets)
+        {
+            cleanupSwapChain(target);
+        }
+
+        vkDestroyPipeline(device, graphicsPipeline, hostAllocationCallbacks());
+        vkDestroyPipelineLayout(device, pipelineLayout, hostAllocationCallbacks());
+        vkDestroyRenderPass(device, renderPass, hostAllocationCallbacks());
+
+        if (useGpuDrivenDraws())
+        {
+            gpuCulling.destroy();
+        }
+        if (postProcessing)
+        {
+            postProcess.destroy();
+        }
+        if (dynamicResolutionEnabled)
+        {
+            std::cout << dynamicResolution.describe() << std::endl;
+        }
+        allocator.destroyBuffer(meshBuffer, meshBufferAllocation);
+        allocator.destroyBuffer(instanceBuffer, instanceBufferAllocation);
+        if (scriptedUploadBuffer != VK_NULL_HANDLE)
+        {
+            allocator.destroyBuffer(scriptedUploadBuffer, scriptedUploadAllocation);
+        }
+
+        std::cout << textureStreamer.describe() << std::endl;
+        textureStreamer.destroy();
+        assetPack.close();
+        // Nenhum subsistema lança trabalhos depois daqui
+        std::cout << jobs.describe() << std::endl;
+        jobs.destroy();
+
+        vkDestroySampler(device, textureSampler, hostAllocationCallbacks());
+        vkDestroyImageView(device, checkerTextureView, hostAllocationCallbacks());
+        allocator.destroyImage(checkerTexture, checkerTextureAllocation);
+        bindlessHeap.destroy();
+
+        allocator.destroyBuffer(indexBuffer, indexBufferAllocation);
+        allocator.destroyBuffer(vertexBuffer, vertexBufferAllocation);
+        stagingRing.destroy();
+
+        // Persiste o cache de pipelines para acelerar a próxima inicialização
+        pipelineCache.save();
+        pipelineCache.destroy();
+
+        computeTimeline.destroy();
+        transferTimeline.destroy();
+        graphicsTimeline.destroy();
+
+        // Toda a memória de dispositivo é devolvida antes de destruir o dispositivo lógico
+        allocator.destroy();
+        vkDestroyDevice(device, hostAllocationCallbacks());
+
+        if (enableValidationLayers)
+        {
+            DestroyDebugUtilsMessengerEXT(instance, debugMessenger, hostAllocationCallbacks());
+        }
+
+        for (auto &target : presentTargets)
+        {
+            if (target.surface != VK_NULL_HANDLE)
+            {
+                vkDestroySurfaceKHR(instance, target.surface, hostAllocationCallbacks());
+            }
+        }
+        vkDestroyInstance(instance, hostAllocationCallbacks());
+        std::cout << hostAllocator.describe() << std::endl;
+        hostAllocator.uninstall();
+        // Escreve as mensagens que ainda estiverem na fila
+        validationLog.stop();
+
+        if (!headless())
+        {
+            for (auto &target : presentTargets)
+            {
+                glfwDestroyWindow(target.window);
+            }
+            glfwTerminate();
+        }
+    }
+
+    // Cria a instância Vulkan
+    void createInstance()
+    {
+        if (enableValidationLayers && !checkValidationLayerSupport())
+        {
+            throw std::runtime_error("validation layers requested, but not available!");
+        }
+
+        // Informações sobre a aplicação (opcional, mas útil para ferramentas de diagnóstico)
+        VkApplicationInfo appInfo{};
+        appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        appInfo.pApplicationName = "Hello Triangle";
+        appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
+        appInfo.pEngineName = "No Engine";
+        appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
+        // Pede a maior versão que o renderizador conhece (1.3) limitada à do carregador; o mínimo é 1.1, necessário para
+        // vkGetPhysicalDeviceProperties2 (UUID do dispositivo). Os recursos de 1.2/1.3 dependem também do dispositivo
+        uint32_t loaderVersion = VK_API_VERSION_1_0;
+        if (vkEnumerateInstanceVersion(&loaderVersion) != VK_SUCCESS)
+        {
+            loaderVersion = VK_API_VERSION_1_0;
+        }
+        instanceApiVersion = std::clamp(loaderVersion, VK_API_VERSION_1_1, VK_API_VERSION_1_3);
+        appInfo.apiVersion = instanceApiVersion;
+
+        // Estrutura usada para criar a instância do Vulkan
+        VkInstanceCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        createInfo.pApplicationInfo = &appInfo;
+
+        // Obtém as extensões necessárias pelo GLFW e outras, se necessário
+        auto extensions = getRequiredExtensions();
+        std::vector<VkValidationFeatureEnableEXT> enabledFeatures = getValidationFeatures();
+        if (!enabledFeatures.empty())
+        {
+            extensions.push_back(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME);
+        }
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+        createInfo.ppEnabledExtensionNames = extensions.data();
+
+        // Se as camadas de validação estiverem habilitadas, define-as e
+        // inclui o mensageiro de debug na cadeia de criação
+        VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
+        VkValidationFeaturesEXT validationFeatures{};
+        if (enableValidationLayers)
+        {
+            createInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
+            createInfo.ppEnabledLayerNames = validationLayers.data();
+
+            // Preenche a struct debugCreateInfo
+            populateDebugMessengerCreateInfo(debugCreateInfo);
+            // Adiciona debugCreateInfo à cadeia de criação
+            createInfo.pNext = (VkDebugUtilsMessengerCreateInfoEXT *)&debugCreateInfo;
+
+            // Validação assistida pela GPU, boas práticas e sincronização são ativadas na criação da instância
+            if (!enabledFeatures.empty())
+            {
+                validationFeatures.sType = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT;
+                validationFeatures.enabledValidationFeatureCount = static_cast<uint32_t>(enabledFeatures.size());
+                validationFeatures.pEnabledValidationFeatures = enabledFeatures.data();
+                validationFeatures.pNext = &debugCreateInfo;
+                createInfo.pNext = &validationFeatures;
+            }
+
+            std::cout << "validation: on" << (options.validation.gpuAssisted ? " +gpu" : "")
+                      << (options.validation.bestPractices ? " +best" : "")
+                      << (options.validation.synchronization ? " +sync" : "")
+                      << (options.validation.verbose ? " +verbose" : "") << std::endl;
+        }
+        else
+        {
+            // Se as camadas de validação não estiverem habilitadas, não inclui nenhuma
+            createInfo.enabledLayerCount = 0;
+            createInfo.pNext = nullptr;
+        }
+
+        // Cria a instância Vulkan propriamente dita
+        if (vkCreateInstance(&createInfo, hostAllocationCallbacks(), &instance) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create instance!");
+        }
+    }
+
+    // Features de VK_EXT_validation_features pedidas pelo usuário e suportadas pela camada
+    std::vector<VkValidationFeatureEnableEXT> getValidationFeatures()
+    {
+        std::vector<VkValidationFeatureEnableEXT> features;
+        if (!enableValidationLayers || !options.validation.needsValidationFeatures())
+        {
+            return features;
+        }
+        if (!isValidationFeaturesSupported())
+        {
+            std::cerr << "validation: " << VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME << " not available, using standard validation" << std::endl;
+            return features;
+        }
+
+        if (options.validation.gpuAssisted)
+        {
+            features.push_back(VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_EXT);
+            features.push_back(VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_RESERVE_BINDING_SLOT_EXT);
+        }
+        if (options.validation.bestPractices)
+        {
+            features.push_back(VK_VALIDATION_FEATURE_ENABLE_BEST_PRACTICES_EXT);
+        }
+        if (options.validation.synchronization)
+        {
+            features.push_back(VK_VALIDATION_FEATURE_ENABLE_SYNCHRONIZATION_VALIDATION_EXT);
+        }
+        return features;
+    }
+
+    // Verifica se o carregador (ou um driver) fornece a extensão de instância
+    bool isInstanceExtensionSupported(const char *name)
+    {
+        uint32_t extensionCount = 0;
+        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, extensions.data());
+
+        for (const auto &extension : extensions)
+        {
+            if (strcmp(extension.extensionName, name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // VK_EXT_validation_features é uma extensão de instância fornecida pela própria camada de validação
+    bool isValidationFeaturesSupported()
+    {
+        uint32_t extensionCount = 0;
+        vkEnumerateInstanceExtensionProperties(validationLayers[0], &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateInstanceExtensionProperties(validationLayers[0], &extensionCount, extensions.data());
+
+        for (const auto &extension : extensions)
+        {
+            if (strcmp(extension.extensionName, VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Preenche a estrutura de criação do mensageiro de debug com níveis de severidade e tipos de mensagem
+    // Mensagens VERBOSE e INFO só são pedidas no modo verbose: cada mensagem custa uma chamada ao callback
+    void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT &createInfo)
+    {
+        createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+        createInfo.messageSeverity =
+            VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
+            VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+        if (options.validation.verbose)
+        {
+            createInfo.messageSeverity |=
+                VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT |
+                VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
+        }
+        createInfo.messageType =
+            VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
+            VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+            VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+        createInfo.pfnUserCallback = debugCallback; // Função de callback que será invocada
+        createInfo.pUserData = &validationLog;      // Registro assíncrono usado pelo callback
+    }
+
+    // Configura o mensageiro de debug, criando-o a partir da instância se as camadas estiverem habilitadas
+    void setupDebugMessenger()
+    {
+        if (!enableValidationLayers)
+            return;
+
+        VkDebugUtilsMessengerCreateInfoEXT createInfo;
+        populateDebugMessengerCreateInfo(createInfo);
+
+        if (CreateDebugUtilsMessengerEXT(instance, &createInfo, hostAllocationCallbacks(), &debugMessenger) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to set up debug messenger!");
+        }
+    }
+
+    // Cria a superfície da janela
+    void createSurfaces()
+    {
+        for (auto &target : presentTargets)
+        {
+            if (glfwCreateWindowSurface(instance, target.window, hostAllocationCallbacks(), &target.surface) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create window surface!");
+            }
+        }
+    }
+
+    // Identidade do dispositivo escolhido para o relatório da execução
+    static DeviceIdentity describeDevice(const PhysicalDeviceInfo &info)
+    {
+        DeviceIdentity identity;
+        identity.name = info.properties.deviceName;
+        identity.uuid = info.uuid;
+        identity.vendorId = info.properties.vendorID;
+        identity.deviceId = info.properties.deviceID;
+        identity.driverVersion = info.properties.driverVersion;
+        identity.apiVersion = info.properties.apiVersion;
+        switch (info.properties.deviceType)
+        {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            identity.type = "discrete";
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            identity.type = "integrated";
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            identity.type = "virtual";
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+            identity.type = "cpu";
+            break;
+        default:
+            identity.type = "other";
+            break;
+        }
+        return identity;
+    }
+
+    // Escolhe o dispositivo físico que será usado para a aplicação
+    void pickPhysicalDevice()
+    {
+        // Propriedades, filas, extensões e suporte à superfície de cada dispositivo, consultados uma vez para todas as
+        // verificações abaixo e para a criação do dispositivo lógico e da cadeia de troca (a superfície da cache é a
+        // da primeira janela)
+        physicalDeviceCache.init(instance, headless() ? VK_NULL_HANDLE : presentTargets[0].surface, instanceApiVersion);
+        const std::vector<PhysicalDeviceInfo> &devices = physicalDeviceCache.devices();
+
+        // Se não houver dispositivos físicos disponíveis, lança uma exceção
+        if (devices.empty())
+        {
+            throw std::runtime_error("failed to find GPUs with Vulkan support!");
+        }
+
+        if (!options.deviceUuid.empty())
+        {
+            // Dispositivo fixado pelo usuário: usa exatamente o que tiver o UUID informado
+            for (const auto &device : devices)
+            {
+                if (device.uuid == options.deviceUuid)
+                {
+                    if (!isDeviceSuitable(device))
+                    {
+                        throw std::runtime_error("GPU with UUID " + options.deviceUuid + " is not suitable!");
+                    }
+                    physicalDevice = device.device;
+                    break;
+                }
+            }
+
+            if (physicalDevice == VK_NULL_HANDLE)
+            {
+                // Lista os dispositivos disponíveis para facilitar a escolha
+                for (const auto &device : devices)
+                {
+                    std::cerr << "available GPU: " << device.properties.deviceName << " uuid=" << device.uuid << std::endl;
+                }
+                throw std::runtime_error("failed to find GPU with UUID " + options.deviceUuid + "!");
+            }
+        }
+        else
+        {
+            // Escolhe o dispositivo adequado com a maior pontuação
+            uint64_t bestScore = 0;
+            for (const auto &device : devices)
+            {
+                if (!isDeviceSuitable(device))
+                {
+                    continue;
+                }
+
+                uint64_t score = rateDeviceSuitability(device);
+                if (physicalDevice == VK_NULL_HANDLE || score > bestScore)
+                {
+                    physicalDevice = device.device;
+                    bestScore = score;
+                }
+            }
+
+            // Se não houver um dispositivo físico adequado, lança uma exceção
+            if (physicalDevice == VK_NULL_HANDLE)
+            {
+                throw std::runtime_error("failed to find a suitable GPU!");
+            }
+        }
+
+        // Guarda as propriedades do dispositivo escolhido (usadas, por exemplo, para validar o cache de pipelines)
+        const PhysicalDeviceInfo &selected = physicalDeviceCache.get(physicalDevice);
+        physicalDeviceProperties = selected.properties;
+        report.device = describeDevice(selected);
+        std::cout << "selected GPU: " << physicalDeviceProperties.deviceName << " uuid=" << selected.uuid << std::endl;
+    }
+
+    // Pontua um dispositivo adequado; maior é melhor
+    // O tipo do dispositivo domina a pontuação (dedicada > integrada > virtual > CPU) e os demais critérios só desempatam
+    // dispositivos do mesmo tipo: memória local, limites de imagem e filas dedicadas de cópia/computação
+    uint64_t rateDeviceSuitability(const PhysicalDeviceInfo &device)
+    {
+        const VkPhysicalDeviceProperties &properties = device.properties;
+
+        uint64_t score = 0;
+        switch (properties.deviceType)
+        {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            score += 40000;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            score += 30000;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            score += 20000;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+            score += 10000;
+            break;
+        default:
+            break;
+        }
+
+        // Maior heap local ao dispositivo, em unidades de 64 MiB (limitado para não superar a diferença entre tipos)
+        const VkPhysicalDeviceMemoryProperties &memoryProperties = device.memoryProperties;
+        VkDeviceSize largestLocalHeap = 0;
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+        {
+            if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+            {
+                largestLocalHeap = std::max(largestLocalHeap, memoryProperties.memoryHeaps[i].size);
+            }
+        }
+        score += std::min<uint64_t>(largestLocalHeap / (64ull * 1024 * 1024), 4096);
+
+        // Tamanho máximo de textura em unidades de 1024 texels
+        score += properties.limits.maxImageDimension2D / 1024;
+
+        // Famílias de fila dedicadas permitem cópias e computação assíncronas
+        QueueFamilyIndices indices = findQueueFamilies(device);
+        score += indices.computeFamily.has_value() ? 1000 : 0;
+        score += indices.transferFamily.has_value() ? 1000 : 0;
+
+        return score;
+    }
+
+    // Cria o dispositivo lógico a partir do dispositivo físico
+    void createLogicalDevice()
+    {
+        // Busca as famílias de fila suportadas pelo dispositivo
+        const PhysicalDeviceInfo &deviceInfo = physicalDeviceCache.get(physicalDevice);
+        QueueFamilyIndices indices = findQueueFamilies(deviceInfo);
+        queueFamilyIndices = indices;
+        const std::vector<VkQueueFamilyProperties> &queueFamilies = deviceInfo.queueFamilies;
+
+        // Número de filas pedidas por família. Gráficos e apresentação compartilham a fila 0 quando estão na mesma família;
+        // transferência e computação recebem uma fila própria sempre que a família tiver filas sobrando
+        std::map<uint32_t, uint32_t> queueCounts;
+        auto requestQueue = [&](uint32_t family)
+        {
+            uint32_t &count = queueCounts[family];
+            uint32_t queueIndex = std::min(count, queueFamilies[family].queueCount - 1);
+            count = std::max(count, queueIndex + 1);
+            return queueIndex;
+        };
+
+        uint32_t graphicsQueueIndex = requestQueue(indices.graphicsFamily.value());
+        uint32_t presentQueueIndex = 0;
+        if (indices.presentFamily.has_value())
+        {
+            presentQueueIndex = indices.presentFamily == indices.graphicsFamily ? graphicsQueueIndex : requestQueue(indices.presentFamily.value());
+        }
+        uint32_t transferQueueIndex = indices.transferFamily.has_value() ? requestQueue(indices.transferFamily.value()) : 0;
+        uint32_t computeQueueIndex = indices.computeFamily.has_value() ? requestQueue(indices.computeFamily.value()) : 0;
+
+        // Informa as filas de cada família ao dispositivo
+        std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+        std::vector<float> queuePriorities(4, 1.0f);
+        for (const auto &[queueFamily, queueCount] : queueCounts)
+        {
+            VkDeviceQueueCreateInfo queueCreateInfo{};
+            queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueCreateInfo.queueFamilyIndex = queueFamily;
+            queueCreateInfo.queueCount = queueCount;
+            queueCreateInfo.pQueuePriorities = queuePriorities.data();
+            queueCreateInfos.push_back(queueCreateInfo);
+        }
+
+        // Habilita todos os recursos opcionais que o dispositivo suporta dentro da versão negociada
+        deviceCapabilities = deviceInfo.capabilities;
+        rendererPaths = RendererPaths::select(deviceCapabilities);
+        if (options.renderPassObjects && BuildConfig::renderPassObjects)
+        {
+            rendererPaths.dynamicRendering = false;
+        }
+        DeviceFeatureChain featureChain(deviceCapabilities);
+
+        // Extensões opcionais: apresentação com identificação e espera, quando o dispositivo suportar as duas
+        // Sem janela nenhuma extensão de apresentação é necessária
+        std::vector<const char *> enabledExtensions;
+        if (!headless())
+        {
+            enabledExtensions.assign(deviceExtensions.begin(), deviceExtensions.end());
+        }
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+        presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+        presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        presentWaitEnabled = false;
+        if (!headless() &&
+            deviceInfo.hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+            deviceInfo.hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+        {
+            presentIdFeatures.pNext = &presentWaitFeatures;
+            VkPhysicalDeviceFeatures2 features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &presentIdFeatures;
+            vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+            presentIdFeatures.pNext = nullptr;
+
+            presentWaitEnabled = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+            if (presentWaitEnabled)
+            {
+                enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+                enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+                presentIdFeatures.pNext = &presentWaitFeatures;
+            }
+        }
+        // Cercas de apresentação, para destruir os semáforos e as cadeias de troca substituídas na hora certa
+        VkPhysicalDeviceSwapchainMaintenance1FeaturesEXT swapchainMaintenanceFeatures{};
+        swapchainMaintenanceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT;
+        presentFencesEnabled = false;
+        if (surfaceMaintenanceAvailable && deviceInfo.hasExtension(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME))
+        {
+            VkPhysicalDeviceFeatures2 features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &swapchainMaintenanceFeatures;
+            vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+            presentFencesEnabled = swapchainMaintenanceFeatures.swapchainMaintenance1;
+            if (presentFencesEnabled)
+            {
+                enabledExtensions.push_back(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME);
+            }
+        }
+        // Orçamento real do heap para o streaming de texturas; sem a extensão o alocador estima a partir do tamanho
+        memoryBudgetEnabled = deviceInfo.hasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        if (memoryBudgetEnabled)
+        {
+            enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
+        VkDeviceCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+
+        // Informa a quantidade de filas
+        createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+        // Informa a fila de gráficos ao dispositivo
+        createInfo.pQueueCreateInfos = queueCreateInfos.data();
+
+        // As features vão na cadeia VkPhysicalDeviceFeatures2 (pEnabledFeatures deve ficar nulo)
+        if (presentWaitEnabled)
+        {
+            featureChain.append(&presentIdFeatures);
+        }
+        if (presentFencesEnabled)
+        {
+            featureChain.append(&swapchainMaintenanceFeatures);
+        }
+        createInfo.pNext = featureChain.head();
+        createInfo.pEnabledFeatures = nullptr;
+
+        // Informa as extensões que o dispositivo suporta
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size()); // Número de extensões
+        createInfo.ppEnabledExtensionNames = enabledExtensions.data();                      // Nomes das extensões
+
+        // Se as camadas de validação estiverem habilitadas, inclui-as na cadeia de criação
+        if (enableValidationLayers)
+        {
+            createInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
+            createInfo.ppEnabledLayerNames = validationLayers.data();
+        }
+        else
+        {
+            // Caso contrário, não inclui nenhuma camada
+            createInfo.enabledLayerCount = 0;
+        }
+
+        // Cria o dispositivo lógico
+        if (vkCreateDevice(physicalDevice, &createInfo, hostAllocationCallbacks(), &device) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create logical device!");
+        }
+        // Barreiras e submissões passam a usar vkCmdPipelineBarrier2/vkQueueSubmit2 quando o dispositivo habilitou o recurso
+        setSynchronization2Enabled(rendererPaths.synchronization2);
+
+        // Recupera a fila de gráficos do dispositivo
+        vkGetDeviceQueue(device, indices.graphicsFamily.value(), graphicsQueueIndex, &graphicsQueue);
+        // Recupera a fila de apresentação do dispositivo (inexistente no modo sem janela)
+        if (indices.presentFamily.has_value())
+        {
+            vkGetDeviceQueue(device, indices.presentFamily.value(), presentQueueIndex, &presentQueue);
+        }
+        else
+        {
+            presentQueue = VK_NULL_HANDLE;
+        }
+
+        // Recupera as filas assíncronas; sem família dedicada o trabalho é enviado para a fila de gráficos
+        transferQueueFamily = indices.transferFamily.value_or(indices.graphicsFamily.value());
+        computeQueueFamily = indices.computeFamily.value_or(indices.graphicsFamily.value());
+        if (indices.transferFamily.has_value())
+        {
+            vkGetDeviceQueue(device, transferQueueFamily, transferQueueIndex, &transferQueue);
+        }
+        else
+        {
+            transferQueue = graphicsQueue;
+        }
+        if (indices.computeFamily.has_value())
+        {
+            vkGetDeviceQueue(device, computeQueueFamily, computeQueueIndex, &computeQueue);
+        }
+        else
+        {
+            computeQueue = graphicsQueue;
+        }
+
+        if (presentWaitEnabled)
+        {
+            pfnWaitForPresentKHR = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(device, "vkWaitForPresentKHR");
+            presentWaitEnabled = pfnWaitForPresentKHR != nullptr;
+        }
+        if (!headless())
+        {
+            std::cout << "present wait: " << (presentWaitEnabled ? "enabled" : "not supported") << std::endl;
+            std::cout << "present fences: " << (presentFencesEnabled ? "enabled" : "not supported") << std::endl;
+        }
+
+        std::cout << "queue families: graphics=" << indices.graphicsFamily.value()
+                  << " present=" << (indices.presentFamily.has_value() ? std::to_string(indices.presentFamily.value()) : "none")
+                  << " transfer=" << transferQueueFamily
+                  << " compute=" << computeQueueFamily << std::endl;
+        std::cout << "device features: " << deviceCapabilities.describe() << std::endl;
+        std::cout << "renderer paths: " << rendererPaths.describe() << std::endl;
+    }
+
+    // Cria a linha do tempo de cada fila (filas compartilhadas recebem linhas do tempo separadas, o que é inofensivo:
+    // cada uma só conta as próprias submissões). Filas compartilhadas, inclusive com a apresentação, usam o mesmo mutex
+    void createQueueTimelines()
+    {
+        graphicsTimeline.init(device, graphicsQueue, queueLocks.get(graphicsQueue));
+        transferTimeline.init(device, transferQueue, queueLocks.get(transferQueue));
+        computeTimeline.init(device, computeQueue, queueLocks.get(computeQueue));
+        if (presentQueue != VK_NULL_HANDLE)
+        {
+            presentQueueMutex = &queueLocks.get(presentQueue);
+        }
+    }
+
+    // Recria a cadeia de troca de uma janela após um redimensionamento ou quando ela deixa de ser compatível com a superfície
+    // A cadeia atual é entregue como oldSwapchain e a destruição dos seus recursos é adiada, evitando um
+    // vkDeviceWaitIdle: framebuffers e image views são liberados quando a linha do tempo de gráficos alcançar o último
+    // quadro que os usou. Os semáforos de renderização concluída e a cadeia antiga ainda podem estar sendo esperados por
+    // uma apresentação, o que o fim do quadro não garante: eles esperam as cercas dessas apresentações ou, sem
+    // VK_EXT_swapchain_maintenance1, mais MAX_FRAMES_IN_FLIGHT quadros
+    // Uma janela minimizada não tem o que apresentar: fica marcada e é tentada de novo no próximo quadro, sem bloquear
+    // as outras janelas
+    void recreateSwapChain(PresentTarget &target)
+    {
+        int width = 0, height = 0;
+        glfwGetFramebufferSize(target.window, &width, &height);
+        target.minimized = width == 0 || height == 0;
+        if (target.minimized)
+        {
+            return;
+        }
+        target.framebufferResized = false;
+        auto start = std::chrono::steady_clock::now();
+
+        // Registra os recursos antigos antes de criar os novos, para que sejam liberados mesmo se a criação falhar
+        VkSwapchainKHR oldSwapChain = target.swapChain;
+        deletionQueue.defer(graphicsTimeline, graphicsTimeline.lastSubmitted(),
+                            [device = device, imageViews = std::move(target.swapChainImageViews),
+                             framebuffers = std::move(target.swapChainFramebuffers)]
+                            {
+                                for (auto framebuffer : framebuffers)
+                                {
+                                    vkDestroyFramebuffer(device, framebuffer, hostAllocationCallbacks());
+                                }
+                                for (auto imageView : imageViews)
+                                {
+                                    vkDestroyImageView(device, imageView, hostAllocationCallbacks());
+                                }
+                            });
+        auto destroyPresented = [device = device, oldSwapChain, semaphores = std::move(target.renderFinishedSemaphores)]
+        {
+            for (auto semaphore : semaphores)
+            {
+                vkDestroySemaphore(device, semaphore, hostAllocationCallbacks());
+            }
+            vkDestroySwapchainKHR(device, oldSwapChain, hostAllocationCallbacks());
+        };
+        if (presentFencesEnabled)
+        {
+            retiredSwapChains.push_back({std::move(target.presentFences), std::move(destroyPresented)});
+        }
+        else
+        {
+            // Cada quadro faz uma submissão na linha do tempo de gráficos
+            deletionQueue.defer(graphicsTimeline, graphicsTimeline.lastSubmitted() + MAX_FRAMES_IN_FLIGHT,
+                                std::move(destroyPresented));
+        }
+        target.swapChainImageViews.clear();
+        target.swapChainFramebuffers.clear();
+        target.renderFinishedSemaphores.clear();
+        target.presentFences.clear();
+
+        VkSurfaceFormatKHR previousFormat{swapChainImageFormat, swapChainColorSpace};
+        createSwapChain(target, oldSwapChain);
+        bool formatChanged = swapChainImageFormat != previousFormat.format || swapChainColorSpace != previousFormat.colorSpace;
+        if (formatChanged)
+        {
+            recreateFormatDependentPipelines();
+        }
+        // As identificações de apresentação são por cadeia de troca
+        target.presentId = 0;
+        createImageViews(target);
+        createFramebuffers(target);
+        createSwapChainSemaphores(target);
+
+        report.swapChainRecreateMilliseconds.push_back(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        if (formatChanged)
+        {
+            // Todas as janelas compartilham o formato: as outras são recriadas agora, antes de o próximo quadro gravar
+            // com o passe e o pipeline novos (as minimizadas ficam marcadas e são recriadas ao voltar)
+            if (recreatingForFormatChange)
+            {
+                throw std::runtime_error("failed to find a surface format shared by all windows!");
+            }
+            recreatingForFormatChange = true;
+            for (auto &other : presentTargets)
+            {
+                if (&other != &target)
+                {
+                    recreateSwapChain(other);
+                }
+            }
+            recreatingForFormatChange = false;
+        }
+    }
+
+    // Recria o que foi criado para o formato da cadeia de troca, depois que uma superfície deixou de oferecê-lo
+    // Com pós-processamento a cena é desenhada em PostProcess::SCENE_COLOR_FORMAT e a codificação vai nos push constants
+    // do passe de pós-processamento, então nada precisa ser recriado
+    void recreateFormatDependentPipelines()
+    {
+        if (postProcessing)
+        {
+            return;
+        }
+
+        // O passe e o pipeline antigos ainda podem estar em uso pelos quadros em voo
+        VkRenderPass oldRenderPass = renderPass;
+        VkPipeline oldPipeline = graphicsPipeline;
+        createRenderPass();
+        {
+            // Espera uma reconstrução em andamento na thread de recarga terminar com o passe antigo; o pipeline que ela
+            // produzir fica com a geração anterior e é descartado ao ser entregue
+            std::lock_guard<std::mutex> lock(graphicsPipelineMutex);
+            graphicsPipelineInputs = {renderPass, sceneColorFormat, outputEncoding, graphicsPipelineInputs.generation + 1};
+        }
+        deletionQueue.defer(graphicsTimeline, graphicsTimeline.lastSubmitted(),
+                            [device = device, oldRenderPass, oldPipeline]
+                            {
+                                vkDestroyPipeline(device, oldPipeline, hostAllocationCallbacks());
+                                vkDestroyRenderPass(device, oldRenderPass, hostAllocationCallbacks());
+                            });
+        // Lê o SPIR-V atual, então uma recarga descartada não se perde. Só a thread de renderização altera a cópia
+        graphicsPipeline = buildGraphicsPipeline(graphicsPipelineInputs, readFile(SHADER_DIR "shader.vert.spv"),
+                                                 readFile(SHADER_DIR "shader.frag.spv"));
+    }
+
+    // Uma cerca não sinalizada para a próxima apresentação, reaproveitada ou criada
+    VkFence acquirePresentFence()
+    {
+        if (!freePresentFences.empty())
+        {
+            VkFence fence = freePresentFences.back();
+            freePresentFences.pop_back();
+            return fence;
+        }
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        VkFence fence;
+        if (vkCreateFence(device, &fenceInfo, hostAllocationCallbacks(), &fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create present fence!");
+        }
+        return fence;
+    }
+
+    // Devolve ao conjunto livre as cercas já sinalizadas de uma lista; não bloqueia
+    void recyclePresentFences(std::vector<VkFence> &fences)
+    {
+        auto signaled = std::stable_partition(fences.begin(), fences.end(), [this](VkFence fence)
+                                              { return vkGetFenceStatus(device, fence) != VK_SUCCESS; });
+        if (signaled == fences.end())
+        {
+            return;
+        }
+        uint32_t count = static_cast<uint32_t>(fences.end() - signaled);
+        vkResetFences(device, count, &*signaled);
+        freePresentFences.insert(freePresentFences.end(), signaled, fences.end());
+        fences.erase(signaled, fences.end());
+    }
+
+    // Recicla as cercas das apresentações concluídas e destrói as cadeias substituídas que nenhuma apresentação espera mais
+    void collectPresentFences()
+    {
+        if (!presentFencesEnabled)
+        {
+            return;
+        }
+        for (auto &target : presentTargets)
+        {
+            recyclePresentFences(target.presentFences);
+        }
+        for (auto retired = retiredSwapChains.begin(); retired != retiredSwapChains.end();)
+        {
+            recyclePresentFences(retired->presentFences);
+            if (retired->presentFences.empty())
+            {
+                retired->destroy();
+                retired = retiredSwapChains.erase(retired);
+            }
+            else
+            {
+                ++retired;
+            }
+        }
+    }
+
+    // Recria as cadeias de troca marcadas e tenta de novo as das janelas minimizadas
+    void recreatePendingSwapChains()
+    {
+        for (auto &target : presentTargets)
+        {
+            if (target.framebufferResized || target.minimized)
+            {
+                recreateSwapChain(target);
+            }
+        }
+    }
+
+    // Destrói os recursos da cadeia de troca de um alvo
+    void cleanupSwapChain(PresentTarget &target)
+    {
+        for (auto semaphore : target.renderFinishedSemaphores)
+        {
+            vkDestroySemaphore(device, semaphore, hostAllocationCallbacks());
+        }
+
+        // Limpa os framebuffers da cadeia de troca
+        for (auto framebuffer : target.swapChainFramebuffers)
+        {
+            vkDestroyFramebuffer(device, framebuffer, hostAllocationCallbacks());
+        }
+
+        // Limpa as imageViews da cadeia de troca
+        for (auto imageView : target.swapChainImageViews)
+        {
+            vkDestroyImageView(device, imageView, hostAllocationCallbacks());
+        }
+
+        if (headless())
+        {
+            // As imagens fora da tela pertencem à aplicação, ao contrário das imagens da cadeia de troca
+            for (size_t i = 0; i < target.swapChainImages.size(); i++)
+            {
+                allocator.destroyImage(target.swapChainImages[i], target.offscreenImageAllocations[i]);
+            }
+            target.offscreenImageAllocations.clear();
+        }
+        else
+        {
+            vkDestroySwapchainKHR(device, target.swapChain, hostAllocationCallbacks());
+        }
+    }
+
+    // Tamanho da janela ao ser criada, ou das imagens fora da tela
+    VkExtent2D initialExtent() const
+    {
+        if (script.width != 0 && script.height != 0)
+        {
+            return {script.width, script.height};
+        }
+        return {WIDTH, HEIGHT};
+    }
+
+    // Cria as imagens de cor que substituem a cadeia de troca no modo sem janela, uma por quadro em voo
+    void createOffscreenTargets(PresentTarget &target)
+    {
+        swapChainImageFormat = OFFSCREEN_FORMAT;
+        postProcessing = choosePostProcessing(PostProcess::supportsStorageOutput(physicalDevice, OFFSCREEN_FORMAT));
+        sceneColorFormat = postProcessing ? PostProcess::SCENE_COLOR_FORMAT : swapChainImageFormat;
+        target.swapChainExtent = initialExtent();
+        target.swapChainImages.resize(MAX_FRAMES_IN_FLIGHT);
+        target.offscreenImageAllocations.resize(MAX_FRAMES_IN_FLIGHT);
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = swapChainImageFormat;
+        imageInfo.extent = {target.swapChainExtent.width, target.swapChainExtent.height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        // TRANSFER_SRC permite ler o resultado de volta (capturas e testes de imagem)
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        if (postProcessing)
+        {
+            imageInfo.usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+        }
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        for (size_t i = 0; i < target.swapChainImages.size(); i++)
+        {
+            allocator.createImage(imageInfo, MemoryUsage::GpuOnly, target.swapChainImages[i], target.offscreenImageAllocations[i]);
+        }
+    }
+
+    // Cria a cadeia de troca de uma janela
+    // oldSwapChain é a cadeia que está sendo substituída (ou VK_NULL_HANDLE na primeira criação)
+    void createSwapChain(PresentTarget &target, VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE)
+    {
+        // Consulta as capacidades de suporte da cadeia de troca do dispositivo
+        SwapChainSupportDetails swapChainSupport = querySwapChainSupport(physicalDeviceCache.get(physicalDevice), target);
+
+        // A primeira cadeia de troca decide o pós-processamento, que fixa o formato e a usagem das demais
+        VkImageUsageFlags supportedUsage = swapChainSupport.capabilities.supportedUsageFlags;
+        if (swapChainImageFormat == VK_FORMAT_UNDEFINED)
+        {
+            // Os formatos _SRGB não aceitam armazenamento, então a política cai para os _UNORM (codificados no shader)
+            std::optional<VkSurfaceFormatKHR> storageFormat = chooseSurfaceFormat(
+                options.surfaceFormatPolicy, swapChainSupport.formats,
+                [this](VkFormat format) { return PostProcess::supportsStorageOutput(physicalDevice, format); });
+            postProcessing = choosePostProcessing((supportedUsage & VK_IMAGE_USAGE_STORAGE_BIT) != 0 && storageFormat.has_value());
+            if (postProcessing)
+            {
+                swapChainImageFormat = storageFormat->format;
+                swapChainColorSpace = storageFormat->colorSpace;
+            }
+        }
+        else if (postProcessing && (supportedUsage & VK_IMAGE_USAGE_STORAGE_BIT) == 0)
+        {
+            throw std::runtime_error("failed to create a storage swap chain for every window!");
+        }
+
+        // Escolhe o formato da superfície da cadeia de troca
+        VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
+        VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+        VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities, target.window);
+
+        // O número de imagens na cadeia de troca é uma das capacidades suportadas pelo dispositivo
+        uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+        if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount)
+        {
+            imageCount = swapChainSupport.capabilities.maxImageCount;
+        }
+
+        // Preenche a estrutura de criação da cadeia de troca
+        VkSwapchainCreateInfoKHR createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+        createInfo.surface = target.surface;
+
+        // Informa as características da cadeia de troca
+        createInfo.minImageCount = imageCount;
+        createInfo.imageFormat = surfaceFormat.format;
+        createInfo.imageColorSpace = surfaceFormat.colorSpace;
+        createInfo.imageExtent = extent;
+        createInfo.imageArrayLayers = 1;
+        createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        if (postProcessing)
+        {
+            // O pós-processamento escreve a imagem com imageStore; TRANSFER_DST permite também limpá-la ou copiar para ela
+            createInfo.imageUsage |= VK_IMAGE_USAGE_STORAGE_BIT | (supportedUsage & VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+        }
+
+        // As famílias de fila escolhidas na criação do dispositivo lógico
+        const QueueFamilyIndices &indices = this->queueFamilyIndices;
+        uint32_t queueFamilyIndices[] = {indices.graphicsFamily.value(), indices.presentFamily.value()};
+
+        if (indices.graphicsFamily != indices.presentFamily)
+        {
+            // Se as famílias de fila de gráficos e apresentação forem diferentes, a cadeia de troca suporta múltiplas filas
+            createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+            createInfo.queueFamilyIndexCount = 2;
+            createInfo.pQueueFamilyIndices = queueFamilyIndices;
+        }
+        else
+        {
+            // Se as famílias de fila de gráficos e apresentação forem iguais, a cadeia de troca suporta apenas uma fila
+            createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        }
+
+        // Informa a transformação da imagem
+        createInfo.preTransform = swapChainSupport.capabilities.currentTransform;
+        createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+        createInfo.presentMode = presentMode;
+        createInfo.clipped = VK_TRUE;
+        std::cout << "present mode: " << presentModeName(presentMode) << " (policy " << presentPolicyName(presentPolicy) << ")" << std::endl;
+
+        // Informa a cadeia de troca antiga, permitindo que o driver reaproveite seus recursos
+        // e que imagens já adquiridas dela ainda sejam apresentadas
+        createInfo.oldSwapchain = oldSwapChain;
+
+        // Cria a cadeia de troca
+        if (vkCreateSwapchainKHR(device, &createInfo, hostAllocationCallbacks(), &target.swapChain) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create swap chain!");
+        }
+
+        // Recupera as imagens da cadeia de troca
+        vkGetSwapchainImagesKHR(device, target.swapChain, &imageCount, nullptr);
+        target.swapChainImages.resize(imageCount);
+        vkGetSwapchainImagesKHR(device, target.swapChain, &imageCount, target.swapChainImages.data());
+
+        // Armazena o formato da imagem, a extensão e a cadeia de troca
+        if (oldSwapChain == VK_NULL_HANDLE && &target == &presentTargets[0])
+        {
+            std::cout << "surface format: " << surfaceFormatName(surfaceFormat) << " (policy "
+                      << surfaceFormatPolicyName(options.surfaceFormatPolicy) << ")" << std::endl;
+        }
+        swapChainImageFormat = surfaceFormat.format;
+        swapChainColorSpace = surfaceFormat.colorSpace;
+        outputEncoding = outputEncodingFor(surfaceFormat);
+        sceneColorFormat = postProcessing ? PostProcess::SCENE_COLOR_FORMAT : swapChainImageFormat;
+        target.swapChainExtent = extent;
+    }
+
+    // Decide se o pós-processamento (--compute-post, ou a ampliação de --dynamic-resolution) pode ser usado;
+    // storageAllowed diz se as imagens finais aceitam VK_IMAGE_USAGE_STORAGE_BIT em um formato que o compute shader pode
+    // escrever
+    bool choosePostProcessing(bool storageAllowed) const
+    {
+        if (!options.computePost && options.dynamicResolutionFps == 0)
+        {
+            return false;
+        }
+        // O passe de renderização e os framebuffers são criados para as imagens da cadeia de troca, não para a
+        // transitória da cena
+        const char *missing = nullptr;
+        if (!useDynamicRendering())
+        {
+            missing = "dynamic rendering";
+        }
+        else if (!deviceCapabilities.shaderStorageImageWriteWithoutFormat)
+        {
+            missing = "shaderStorageImageWriteWithoutFormat";
+        }
+        else if (!storageAllowed)
+        {
+            missing = "storage swapchain images";
+        }
+        if (missing != nullptr)
+        {
+            std::cout << "post processing: needs " << missing << ", drawing straight into the swap chain" << std::endl;
+            return false;
+        }
+        std::cout << "post processing: compute tonemap, FXAA and upscale into the swap chain images" << std::endl;
+        return true;
+    }
+
+    // Consulta as capacidades de suporte da cadeia de troca do dispositivo para a superfície de um alvo
+    // Na primeira criação, formatos e modos de apresentação da primeira janela vêm da cache; numa recriação são relidos,
+    // pois mudam com o modo do monitor e com a tela em que a janela está. As capacidades incluem a extensão atual da
+    // janela e são sempre relidas
+    SwapChainSupportDetails querySwapChainSupport(const PhysicalDeviceInfo &device, const PresentTarget &target)
+    {
+        SwapChainSupportDetails details;
+        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device.device, target.surface, &details.capabilities);
+        if (&target == &presentTargets[0] && target.swapChain == VK_NULL_HANDLE)
+        {
+            details.formats = device.surfaceFormats;
+            details.presentModes = device.presentModes;
+            return details;
+        }
+
+        uint32_t formatCount = 0;
+        vkGetPhysicalDeviceSurfaceFormatsKHR(device.device, target.surface, &formatCount, nullptr);
+        details.formats.resize(formatCount);
+        vkGetPhysicalDeviceSurfaceFormatsKHR(device.device, target.surface, &formatCount, details.formats.data());
+        uint32_t presentModeCount = 0;
+        vkGetPhysicalDeviceSurfacePresentModesKHR(device.device, target.surface, &presentModeCount, nullptr);
+        details.presentModes.resize(presentModeCount);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(device.device, target.surface, &presentModeCount, details.presentModes.data());
+        return details;
+    }
+
+    // Cria as imageViews da cadeia de troca de um alvo
+    void createImageViews(PresentTarget &target)
+    {
+        // Redimensiona o vetor de imageViews para armazenar todas as imagens da cadeia de troca
+        target.swapChainImageViews.resize(target.swapChainImages.size());
+
+        // Itera sobre as imagens da cadeia de troca e cria uma imageView para cada uma
+        for (size_t i = 0; i < target.swapChainImages.size(); i++)
+        {
+            // Cria a estrutura de criação da imageView
+            VkImageViewCreateInfo createInfo{};
+            createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            createInfo.image = target.swapChainImages[i];
+            createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            createInfo.format = swapChainImageFormat;
+            createInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+            createInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+            createInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+            createInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+            createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            createInfo.subresourceRange.baseMipLevel = 0;
+            createInfo.subresourceRange.levelCount = 1;
+            createInfo.subresourceRange.baseArrayLayer = 0;
+            createInfo.subresourceRange.layerCount = 1;
+
+            // Se a criação da imageView falhar, lança uma exceção            
+            if (vkCreateImageView(device, &createInfo, hostAllocationCallbacks(), &target.swapChainImageViews[i]) != VK_SUCCESS)
+            {   
+                throw std::runtime_error("failed to create image views!");
+            }
+        }
+    }
+
+    // Cria o passe de renderização com um único anexo de cor (a imagem da cadeia de troca)
+    // Com renderização dinâmica o passe é descrito na gravação (vkCmdBeginRendering) e nenhum objeto é criado
+    void createRenderPass()
+    {
+        if (useDynamicRendering())
+        {
+            renderPass = VK_NULL_HANDLE;
+            return;
+        }
+
+        VkAttachmentDescription colorAttachment{};
+        colorAttachment.format = swapChainImageFormat;
+        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;    // Limpa o anexo no início do passe
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;  // Mantém o resultado para a apresentação
+        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        // As transições de e para a apresentação são feitas pelas barreiras do grafo de quadro
+        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference colorAttachmentRef{};
+        colorAttachmentRef.attachment = 0;
+        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachmentRef;
+
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = 1;
+        renderPassInfo.pAttachments = &colorAttachment;
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+
+        if (vkCreateRenderPass(device, &renderPassInfo, hostAllocationCallbacks(), &renderPass) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create render pass!");
+        }
+    }
+
+    // Cria o cache de pipelines a partir do arquivo salvo na execução anterior (se for deste dispositivo)
+    void createPipelineCache()
+    {
+        pipelineCache.create(device, physicalDeviceProperties, PIPELINE_CACHE_FILE, std::move(startupFiles.pipelineCache));
+    }
+
+    // Cria o pipeline gráfico que desenha o triângulo
+    void createGraphicsPipeline()
+    {
+        // Um único conjunto (o heap bindless) compartilhado por todos os pipelines; o que muda entre desenhos são
+        // apenas os índices nos push constants
+        VkDescriptorSetLayout setLayouts[] = {bindlessHeap.setLayout()};
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(DrawPushConstants);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = setLayouts;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, hostAllocationCallbacks(), &pipelineLayout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create pipeline layout!");
+        }
+
+        // A recarga de shaders ainda não começou: a cópia pode ser escrita sem o mutex
+        graphicsPipelineInputs = {renderPass, sceneColorFormat, outputEncoding, 0};
+        graphicsPipeline = buildGraphicsPipeline(graphicsPipelineInputs, startupFiles.vertexShader, startupFiles.fragmentShader);
+    }
+
+    // Cria o pipeline gráfico a partir do SPIR-V dos shaders, com o layout atual e o passe e formatos de inputs
+    // Também chamado pela thread de recarga de shaders, com graphicsPipelineMutex: além de inputs, só lê objetos que não
+    // mudam enquanto a aplicação executa
+    VkPipeline buildGraphicsPipeline(const GraphicsPipelineInputs &inputs, const std::vector<char> &vertShaderCode,
+                                     const std::vector<char> &fragShaderCode)
+    {
+        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
+        VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+
+        VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+        vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+        vertShaderStageInfo.module = vertShaderModule;
+        vertShaderStageInfo.pName = "main";
+
+        VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
+        fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        fragShaderStageInfo.module = fragShaderModule;
+        fragShaderStageInfo.pName = "main";
+
+        // OUTPUT_ENCODING (constant_id 0) e PAPER_WHITE_NITS (1) de shader.frag: a cor sai já codificada para o formato
+        // da cadeia de troca, sem passe de conversão. Com pós-processamento a cena fica linear e post.comp codifica
+        struct FragmentSpecialization
+        {
+            uint32_t outputEncoding;
+            float paperWhiteNits;
+        } fragmentSpecialization{static_cast<uint32_t>(postProcessing ? OutputEncoding::None : inputs.outputEncoding),
+                                 HDR_PAPER_WHITE_NITS};
+        std::array<VkSpecializationMapEntry, 2> specializationEntries{{
+            {0, offsetof(FragmentSpecialization, outputEncoding), sizeof(uint32_t)},
+            {1, offsetof(FragmentSpecialization, paperWhiteNits), sizeof(float)},
+        }};
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+        specializationInfo.pMapEntries = specializationEntries.data();
+        specializationInfo.dataSize = sizeof(fragmentSpecialization);
+        specializationInfo.pData = &fragmentSpecialization;
+        fragShaderStageInfo.pSpecializationInfo = &specializationInfo;
+
+        VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
+
+        // Os vértices vêm do buffer de vértices (binding 0)
+        auto bindingDescription = Vertex::getBindingDescription();
+        auto attributeDescriptions = Vertex::getAttributeDescriptions();
+
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        // Viewport e scissor são dinâmicos, então o pipeline não precisa ser recriado junto com a cadeia de troca
+        VkPipelineViewportStateCreateInfo viewportState{};
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rasterizer{};
+        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizer.depthClampEnable = VK_FALSE;
+        rasterizer.rasterizerDiscardEnable = VK_FALSE;
+        rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizer.lineWidth = 1.0f;
+        rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+        rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+        rasterizer.depthBiasEnable = VK_FALSE;
+
+        VkPipelineMultisampleStateCreateInfo multisampling{};
+        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampling.sampleShadingEnable = VK_FALSE;
+        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachment.blendEnable = VK_FALSE;
+
+        VkPipelineColorBlendStateCreateInfo colorBlending{};
+        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlending.logicOpEnable = VK_FALSE;
+        colorBlending.logicOp = VK_LOGIC_OP_COPY;
+        colorBlending.attachmentCount = 1;
+        colorBlending.pAttachments = &colorBlendAttachment;
+
+        std::vector<VkDynamicState> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicState.pDynamicStates = dynamicStates.data();
+
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.stageCount = 2;
+        pipelineInfo.pStages = shaderStages;
+        pipelineInfo.pVertexInputState = &vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterizer;
+        pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pColorBlendState = &colorBlending;
+        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.layout = pipelineLayout;
+        pipelineInfo.renderPass = inputs.renderPass;
+        pipelineInfo.subpass = 0;
+
+        // Sem passe de renderização, o pipeline declara o formato dos anexos em que vai desenhar
+        VkPipelineRenderingCreateInfo renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachmentFormats = &inputs.sceneColorFormat;
+        if (useDynamicRendering())
+        {
+            pipelineInfo.pNext = &renderingInfo;
+        }
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+        // O cache de pipelines evita recompilar os shaders quando o mesmo pipeline já foi criado antes
+        // (o VkPipelineCache é sincronizado internamente, então é compartilhado com a thread de recarga)
+        VkPipeline pipeline;
+        VkResult result = vkCreateGraphicsPipelines(device, pipelineCache.handle(), 1, &pipelineInfo, hostAllocationCallbacks(), &pipeline);
+
+        // Os módulos de shader só são necessários durante a criação do pipeline
+        vkDestroyShaderModule(device, fragShaderModule, hostAllocationCallbacks());
+        vkDestroyShaderModule(device, vertShaderModule, hostAllocationCallbacks());
+
+        if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create graphics pipeline!");
+        }
+        return pipeline;
+    }
+
+    // Cria um módulo de shader a partir do código SPIR-V
+    VkShaderModule createShaderModule(const std::vector<char> &code)
+    {
+        VkShaderModuleCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.codeSize = code.size();
+        createInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
+
+        VkShaderModule shaderModule;
+        if (vkCreateShaderModule(device, &createInfo, hostAllocationCallbacks(), &shaderModule) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create shader module!");
+        }
+        return shaderModule;
+    }
+
+    // Cria um framebuffer para cada imageView da cadeia de troca de um alvo
+    // Com renderização dinâmica os passes desenham direto nas imageViews, então a recriação da cadeia não cria nenhum
+    void createFramebuffers(PresentTarget &target)
+    {
+        if (useDynamicRendering())
+        {
+            return;
+        }
+
+        target.swapChainFramebuffers.resize(target.swapChainImageViews.size());
+
+        for (size_t i = 0; i < target.swapChainImageViews.size(); i++)
+        {
+            VkImageView attachments[] = {target.swapChainImageViews[i]};
+
+            VkFramebufferCreateInfo framebufferInfo{};
+            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebufferInfo.renderPass = renderPass;
+            framebufferInfo.attachmentCount = 1;
+            framebufferInfo.pAttachments = attachments;
+            framebufferInfo.width = target.swapChainExtent.width;
+            framebufferInfo.height = target.swapChainExtent.height;
+            framebufferInfo.layers = 1;
+
+            if (vkCreateFramebuffer(device, &framebufferInfo, hostAllocationCallbacks(), &target.swapChainFramebuffers[i]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create framebuffer!");
+            }
+        }
+    }
+
+    // Cria o pool de comandos da fila de gráficos
+    void createCommandPool()
+    {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        // Permite regravar cada buffer de comando individualmente a cada quadro
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+
+        if (vkCreateCommandPool(device, &poolInfo, hostAllocationCallbacks(), &commandPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create command pool!");
+        }
+    }
+
+    // Aloca um buffer de comando primário por quadro em voo
+    void createCommandBuffers()
+    {
+        commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate command buffers!");
+        }
+    }
+
+    // Cria as threads de gravação, com pools na família de gráficos (a mesma do buffer primário)
+    void createParallelRecorder()
+    {
+        recorder.init(device, queueFamilyIndices.graphicsFamily.value(), MAX_FRAMES_IN_FLIGHT, jobs);
+    }
+
+    // Cria os pools de consulta de timestamps; os tempos de GPU são medidos na fila de gráficos
+    void createProfiler()
+    {
+        const std::vector<VkQueueFamilyProperties> &queueFamilies = physicalDeviceCache.get(physicalDevice).queueFamilies;
+        uint32_t timestampValidBits = queueFamilies[queueFamilyIndices.graphicsFamily.value()].timestampValidBits;
+        profiler.init(device, physicalDeviceProperties, timestampValidBits, MAX_FRAMES_IN_FLIGHT, options.tracePath);
+    }
+
+    // Cria o grafo de quadro; as imagens transitórias substituídas esperam a linha do tempo de gráficos
+    void createRenderGraph()
+    {
+        renderGraph.init(device, allocator, deletionQueue, graphicsTimeline);
+    }
+
+    // Cria o anel de staging; as cópias rodam na fila de transferência e os recursos são entregues à família de gráficos
+    void createStagingRing()
+    {
+        stagingRing.init(device, allocator, STAGING_RING_SIZE, MAX_FRAMES_IN_FLIGHT,
+                         transferTimeline, transferQueueFamily, queueFamilyIndices.graphicsFamily.value());
+    }
+
+    // Cria um buffer local ao dispositivo e enfileira o envio do seu conteúdo pelo anel de staging
+    // O conteúdo é copiado no primeiro quadro; só o que não couber no anel espera a fila de transferência
+    // Com shareWithCompute o buffer também é lido pela fila de computação e usa VK_SHARING_MODE_CONCURRENT entre as
+    // famílias de gráficos, transferência e computação (quando diferentes), sem transferências de posse
+    void createDeviceLocalBuffer(const void *data, VkDeviceSize size, VkBufferUsageFlags usage,
+                                 VkPipelineStageFlags dstStage, VkAccessFlags dstAccess,
+                                 VkBuffer &buffer, GpuAllocation &allocation, bool shareWithCompute = false)
+    {
+        createDeviceLocalBuffer({{data, size}}, usage, dstStage, dstAccess, buffer, allocation, shareWithCompute);
+    }
+
+    // Faixa de memória da CPU copiada para um buffer
+    struct BufferData
+    {
+        const void *data;
+        VkDeviceSize size;
+    };
+
+    // Como acima, com o conteúdo formado pelas faixas em sequência (copiadas direto para o anel de staging)
+    void createDeviceLocalBuffer(const std::vector<BufferData> &ranges, VkBufferUsageFlags usage,
+                                 VkPipelineStageFlags dstStage, VkAccessFlags dstAccess,
+                                 VkBuffer &buffer, GpuAllocation &allocation, bool shareWithCompute = false)
+    {
+        VkDeviceSize size = 0;
+        for (const BufferData &range : ranges)
+        {
+            size += range.size;
+        }
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        std::set<uint32_t> families;
+        if (shareWithCompute)
+        {
+            families = {queueFamilyIndices.graphicsFamily.value(), transferQueueFamily, computeQueueFamily};
+        }
+        std::vector<uint32_t> familyList(families.begin(), families.end());
+        bool concurrent = familyList.size() > 1;
+        if (concurrent)
+        {
+            bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(familyList.size());
+            bufferInfo.pQueueFamilyIndices = familyList.data();
+        }
+        allocator.createBuffer(bufferInfo, MemoryUsage::GpuOnly, buffer, allocation);
+
+        // O conteúdo pode ser maior que o anel: vai em pedaços de até STARTUP_UPLOAD_CHUNK_SIZE, cada um copiado para o
+        // seu deslocamento no buffer
+        size_t rangeIndex = 0;
+        VkDeviceSize rangeOffset = 0;
+        for (VkDeviceSize dstOffset = 0; dstOffset < size;)
+        {
+            StagingRegion region = allocateStartupStaging(std::min(size - dstOffset, STARTUP_UPLOAD_CHUNK_SIZE));
+            auto *destination = static_cast<char *>(region.data);
+            for (VkDeviceSize written = 0; written < region.size;)
+            {
+                const BufferData &range = ranges[rangeIndex];
+                VkDeviceSize count = std::min(range.size - rangeOffset, region.size - written);
+                memcpy(destination + written, static_cast<const char *>(range.data) + rangeOffset, static_cast<size_t>(count));
+                written += count;
+                rangeOffset += count;
+                if (rangeOffset == range.size)
+                {
+                    rangeIndex++;
+                    rangeOffset = 0;
+                }
+            }
+            stagingRing.copyToBuffer(region, buffer, dstOffset, dstStage, dstAccess, concurrent);
+            dstOffset += region.size;
+        }
+    }
+
+    // Reserva espaço no anel para um upload feito antes do laço de quadros; com o anel cheio, envia as cópias pendentes
+    // e espera que terminem (bloquear é aceitável na inicialização)
+    StagingRegion allocateStartupStaging(VkDeviceSize size, VkDeviceSize alignment = 16)
+    {
+        StagingRegion region;
+        if (!stagingRing.tryAllocate(size, alignment, region))
+        {
+            stagingRing.drain(currentFrame);
+            region = stagingRing.allocate(size, alignment);
+        }
+        return region;
+    }
+
+    // Abre o contêiner de assets informado em --assets; os dados são lidos da memória mapeada durante os uploads
+    // Roda em uma thread própria durante a criação do dispositivo, então já pede a leitura das malhas (copiadas logo
+    // depois por createSceneGeometry)
+    void openAssetPack()
+    {
+        if (options.assetPackPath.empty())
+        {
+            return;
+        }
+        assetPack.open(options.assetPackPath);
+        for (uint32_t i = 0; i < assetPack.meshCount(); i++)
+        {
+            const AssetMeshRecord &mesh = assetPack.mesh(i);
+            assetPack.prefetch(mesh.vertexDataOffset, mesh.vertexDataSize);
+            assetPack.prefetch(mesh.indexDataOffset, mesh.indexDataSize);
+        }
+    }
+
+    // Lê os arquivos usados na criação dos pipelines; roda em uma thread própria antes de o dispositivo existir
+    StartupFiles loadStartupFiles()
+    {
+        StartupFiles files;
+        files.vertexShader = readFile(SHADER_DIR "shader.vert.spv");
+        files.fragmentShader = readFile(SHADER_DIR "shader.frag.spv");
+        files.cullShader = readFile(SHADER_DIR "cull.comp.spv");
+        files.postShader = readFile(SHADER_DIR "post.comp.spv");
+        files.pipelineCache = PipelineCache::load(PIPELINE_CACHE_FILE);
+        return files;
+    }
+
+    // Verifica se uma malha do contêiner pode ser desenhada pelo pipeline gráfico sem conversão
+    static bool isCompatibleMesh(const AssetMeshRecord &mesh)
+    {
+        auto attributes = Vertex::getAttributeDescriptions();
+        if (mesh.vertexStride != sizeof(Vertex) || mesh.attributeCount != attributes.size() ||
+            mesh.indexType != VK_INDEX_TYPE_UINT16)
+        {
+            return false;
+        }
+        for (uint32_t i = 0; i < mesh.attributeCount; i++)
+        {
+            if (mesh.attributes[i].location != attributes[i].location ||
+                mesh.attributes[i].format != static_cast<uint32_t>(attributes[i].format) ||
+                mesh.attributes[i].offset != attributes[i].offset)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Monta os buffers de vértices e índices da cena: o triângulo embutido seguido das malhas do contêiner
+    // Cada malha ocupa uma faixa dos buffers, identificada por firstIndex e vertexOffset em sceneMeshes
+    void createSceneGeometry()
+    {
+        std::vector<BufferData> vertexRanges = {{vertices.data(), sizeof(vertices[0]) * vertices.size()}};
+        std::vector<BufferData> indexRanges = {{indices.data(), sizeof(indices[0]) * indices.size()}};
+        sceneMeshes = {{static_cast<uint32_t>(indices.size()), 0, 0, 0}};
+        sceneMeshRadii = {TRIANGLE_BOUNDING_RADIUS};
+
+        uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+        uint32_t indexCount = static_cast<uint32_t>(indices.size());
+        for (uint32_t i = 0; assetPack.isOpen() && i < assetPack.meshCount(); i++)
+        {
+            const AssetMeshRecord &mesh = assetPack.mesh(i);
+            if (!isCompatibleMesh(mesh))
+            {
+                std::cerr << "assets: skipping mesh " << i << " (vertex layout or index type differs from the pipeline)" << std::endl;
+                continue;
+            }
+            vertexRanges.push_back({assetPack.data(mesh.vertexDataOffset), mesh.vertexDataSize});
+            indexRanges.push_back({assetPack.data(mesh.indexDataOffset), mesh.indexDataSize});
+            sceneMeshes.push_back({mesh.indexCount, indexCount, static_cast<int32_t>(vertexCount), 0});
+            sceneMeshRadii.push_back(mesh.boundingRadius);
+            vertexCount += mesh.vertexCount;
+            indexCount += mesh.indexCount;
+        }
+
+        createDeviceLocalBuffer(vertexRanges, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+                                vertexBuffer, vertexBufferAllocation);
+        createDeviceLocalBuffer(indexRanges, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT,
+                                indexBuffer, indexBufferAllocation);
+    }
+
+    // Registra as texturas no streamer: a xadrez fica sempre residente e as do contêiner são carregadas sob demanda
+    // Texturas em formatos que o dispositivo não amostra são ignoradas
+    void createTextureStreamer()
+    {
+        TextureStreamer::Settings settings;
+        settings.budgetBytes = VkDeviceSize(options.streamingBudgetMiB) * 1024 * 1024;
+        uint32_t maxTextures = 1 + (assetPack.isOpen() ? assetPack.textureCount() : 0);
+        textureStreamer.init(device, allocator, stagingRing, bindlessHeap, assetPack, textureSampler, checkerTextureIndex,
+                             MAX_FRAMES_IN_FLIGHT, maxTextures, settings, jobs);
+
+        sceneTextureIndices = {textureStreamer.addResidentTexture(checkerTextureIndex)};
+        for (uint32_t i = 0; assetPack.isOpen() && i < assetPack.textureCount(); i++)
+        {
+            const AssetTextureRecord &record = assetPack.texture(i);
+            VkFormatProperties formatProperties;
+            vkGetPhysicalDeviceFormatProperties(physicalDevice, static_cast<VkFormat>(record.format), &formatProperties);
+            if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT))
+            {
+                std::cerr << "assets: skipping texture " << i << " (format " << record.format << " is not supported)" << std::endl;
+                continue;
+            }
+            sceneTextureIndices.push_back(textureStreamer.addStreamedTexture(i));
+        }
+    }
+
+    // Informa ao streamer o tamanho na tela, em pixels, de cada textura das instâncias visíveis
+    void requestSceneTextures()
+    {
+        // A janela mais alta é a que mostra as texturas maiores
+        uint32_t height = 0;
+        for (const FrameImage &frameImage : frameImages)
+        {
+            height = std::max(height, frameImage.target->swapChainExtent.height);
+        }
+        float pixelsPerUnit = height / (2.0f * std::tan(glm::radians(CAMERA_FOV_DEGREES) * 0.5f));
+        for (const SceneInstance &instance : sceneInstances)
+        {
+            glm::vec3 center(instance.positionScale.x, instance.positionScale.y, instance.positionScale.z);
+            if (!frustum.intersectsSphere(center, instance.boundingRadius))
+            {
+                continue;
+            }
+            float distance = std::max(glm::length(center - cameraPosition), instance.boundingRadius);
+            textureStreamer.request(instance.textureIndex, 2.0f * instance.boundingRadius * pixelsPerUnit / distance);
+        }
+    }
+
+    // Cria o heap de descritores global, antes dos pipelines que usam o seu layout
+    void createBindlessHeap()
+    {
+        bindlessHeap.init(physicalDevice, device, BINDLESS_MAX_STORAGE_BUFFERS, BINDLESS_MAX_TEXTURES);
+    }
+
+    // Sampler compartilhado pelas texturas; com anisotropia quando o dispositivo suportar
+    void createTextureSampler()
+    {
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.anisotropyEnable = deviceCapabilities.samplerAnisotropy ? VK_TRUE : VK_FALSE;
+        samplerInfo.maxAnisotropy = deviceCapabilities.samplerAnisotropy ? physicalDeviceProperties.limits.maxSamplerAnisotropy : 1.0f;
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+        if (vkCreateSampler(device, &samplerInfo, hostAllocationCallbacks(), &textureSampler) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create texture sampler!");
+        }
+    }
+
+    // Gera uma textura xadrez, envia pelo anel de staging e a registra no heap bindless
+    void createCheckerTexture()
+    {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+        imageInfo.extent = {CHECKER_TEXTURE_SIZE, CHECKER_TEXTURE_SIZE, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        allocator.createImage(imageInfo, MemoryUsage::GpuOnly, checkerTexture, checkerTextureAllocation);
+
+        // Casas de 8 texels alternando entre branco e cinza claro
+        VkDeviceSize size = CHECKER_TEXTURE_SIZE * CHECKER_TEXTURE_SIZE * 4;
+        StagingRegion region = allocateStartupStaging(size);
+        auto *texels = static_cast<uint8_t *>(region.data);
+        for (uint32_t y = 0; y < CHECKER_TEXTURE_SIZE; y++)
+        {
+            for (uint32_t x = 0; x < CHECKER_TEXTURE_SIZE; x++)
+            {
+                uint8_t value = ((x / 8 + y / 8) % 2 == 0) ? 255 : 160;
+                uint8_t *texel = texels + (y * CHECKER_TEXTURE_SIZE + x) * 4;
+                texel[0] = value;
+                texel[1] = value;
+                texel[2] = value;
+                texel[3] = 255;
+            }
+        }
+
+        VkImageSubresourceRange range{};
+        range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        range.levelCount = 1;
+        range.layerCount = 1;
+
+        VkBufferImageCopy copy{};
+        copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copy.imageSubresource.layerCount = 1;
+        copy.imageExtent = imageInfo.extent;
+        stagingRing.copyToImage(region, checkerTexture, copy, range, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = checkerTexture;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = imageInfo.format;
+        viewInfo.subresourceRange = range;
+        if (vkCreateImageView(device, &viewInfo, hostAllocationCallbacks(), &checkerTextureView) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create texture image view!");
+        }
+
+        checkerTextureIndex = bindlessHeap.addTexture(checkerTextureView, textureSampler);
+    }
+
+    // Buffer que recebe os uploads roteirizados; cabe no que o anel de staging pode entregar em um quadro, e cada
+    // quadro escreve no máximo o buffer inteiro, para que as cópias de um mesmo flush nunca se sobreponham
+    void createScriptedUploadBuffer()
+    {
+        if (script.uploadBytesPerFrame == 0)
+        {
+            return;
+        }
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        scriptedUploadSize = std::min<VkDeviceSize>(script.uploadBytesPerFrame, STAGING_RING_SIZE / MAX_FRAMES_IN_FLIGHT);
+        bufferInfo.size = scriptedUploadSize;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        // O conteúdo não é lido: compartilhado entre as filas, cada quadro só espera as próprias cópias, sem
+        // transferências de dono
+        std::vector<uint32_t> families = {queueFamilyIndices.graphicsFamily.value(), transferQueueFamily};
+        scriptedUploadConcurrent = families[0] != families[1];
+        bufferInfo.sharingMode = scriptedUploadConcurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+        bufferInfo.queueFamilyIndexCount = scriptedUploadConcurrent ? 2 : 0;
+        bufferInfo.pQueueFamilyIndices = scriptedUploadConcurrent ? families.data() : nullptr;
+        allocator.createBuffer(bufferInfo, MemoryUsage::GpuOnly, scriptedUploadBuffer, scriptedUploadAllocation);
+    }
+
+    // Envia RunScript::uploadBytesPerFrame (limitado a scriptedUploadSize) pelo anel de staging, em cópias de
+    // SCRIPTED_UPLOAD_CHUNK_SIZE. Quando o anel enche, o restante é descartado; report.uploadedBytes conta só o que foi
+    // enviado
+    void uploadScriptedData()
+    {
+        if (scriptedUploadBuffer == VK_NULL_HANDLE)
+        {
+            return;
+        }
+        // Um quadro percorre o buffer no máximo uma vez a partir do deslocamento atual: nenhum byte de destino é escrito
+        // duas vezes no mesmo flush, o que tornaria as regiões do vkCmdCopyBuffer sobrepostas
+        VkDeviceSize remaining = scriptedUploadSize;
+        while (remaining > 0)
+        {
+            VkDeviceSize size = std::min({remaining, SCRIPTED_UPLOAD_CHUNK_SIZE, scriptedUploadSize - scriptedUploadOffset});
+            StagingRegion region;
+            if (!stagingRing.tryAllocate(size, 16, region))
+            {
+                break;
+            }
+            // A escrita na memória mapeada faz parte do custo do upload
+            memset(region.data, static_cast<int>(sceneFrame & 0xff), static_cast<size_t>(size));
+            stagingRing.copyToBuffer(region, scriptedUploadBuffer, scriptedUploadOffset, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                     VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, scriptedUploadConcurrent);
+            scriptedUploadOffset = (scriptedUploadOffset + size) % scriptedUploadSize;
+            remaining -= size;
+            report.uploadedBytes += size;
+        }
+    }
+
+    // Distribui as instâncias das malhas em uma grade quadrada centrada na origem e envia instâncias e malhas
+    void createScene()
+    {
+        // O buffer de instâncias é vinculado inteiro como storage buffer no heap bindless; o envio vai em pedaços pelo anel
+        VkDeviceSize instanceBytes = sizeof(SceneInstance) * static_cast<VkDeviceSize>(options.instanceCount);
+        if (instanceBytes > physicalDeviceProperties.limits.maxStorageBufferRange)
+        {
+            throw std::runtime_error("--instances " + std::to_string(options.instanceCount) + " needs a " +
+                                     std::to_string(instanceBytes) + "-byte instance buffer, above maxStorageBufferRange (" +
+                                     std::to_string(physicalDeviceProperties.limits.maxStorageBufferRange) + ")!");
+        }
+
+        uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(options.instanceCount))));
+        float halfExtent = (columns - 1) * SCENE_GRID_SPACING * 0.5f;
+        float fullScreenScale = script.fullScreenInstances ? fullScreenTriangleScale() : 0.0f;
+        sceneInstances.resize(options.instanceCount);
+        for (uint32_t i = 0; i < options.instanceCount; i++)
+        {
+            SceneInstance &instance = sceneInstances[i];
+            float x = (i % columns) * SCENE_GRID_SPACING - halfExtent;
+            float y = (i / columns) * SCENE_GRID_SPACING - halfExtent;
+            instance.positionScale = glm::vec4(x, y, 0.0f, 1.0f);
+            // Malhas e texturas alternam entre as instâncias
+            instance.meshIndex = i % static_cast<uint32_t>(sceneMeshes.size());
+            if (script.fullScreenInstances)
+            {
+                instance.positionScale = glm::vec4(0.0f, 0.0f, 0.0f, fullScreenScale);
+                instance.meshIndex = 0;
+            }
+            instance.materialIndex = i % SCENE_MATERIAL_COUNT;
+            instance.textureIndex = sceneTextureIndices[i % sceneTextureIndices.size()];
+            instance.boundingRadius = sceneMeshRadii[instance.meshIndex] * instance.positionScale.w;
+        }
+        sceneDrawCount = options.instanceCount;
+
+        // Lidos pelo vertex shader e, no caminho de GPU, pelo compute shader de seleção
+        createDeviceLocalBuffer(sceneInstances.data(), sizeof(SceneInstance) * sceneInstances.size(),
+                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                                VK_ACCESS_SHADER_READ_BIT, instanceBuffer, instanceBufferAllocation, true);
+        createDeviceLocalBuffer(sceneMeshes.data(), sizeof(SceneMesh) * sceneMeshes.size(),
+                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                                VK_ACCESS_SHADER_READ_BIT, meshBuffer, meshBufferAllocation, true);
+        instanceBufferIndex = bindlessHeap.addStorageBuffer(instanceBuffer);
+        meshBufferIndex = bindlessHeap.addStorageBuffer(meshBuffer);
+    }
+
+    // Escala com que o triângulo embutido, na origem, cobre a vista inteira da câmera fixa em todos os alvos
+    // Na distância da câmera a vista tem meia altura h e meia largura w = h * proporção. A base do triângulo (y = s/2)
+    // cobre a borda de baixo com s >= 2h, e as laterais, que se estreitam até o vértice (0, -s/2), passam pelos cantos
+    // de cima com s >= 4w + 2h
+    float fullScreenTriangleScale() const
+    {
+        float widestAspect = 0.0f;
+        for (const auto &target : presentTargets)
+        {
+            widestAspect = std::max(widestAspect, static_cast<float>(target.swapChainExtent.width) /
+                                                      static_cast<float>(target.swapChainExtent.height));
+        }
+        float halfHeight = CAMERA_DISTANCE * std::tan(glm::radians(CAMERA_FOV_DEGREES) * 0.5f);
+        float halfWidth = halfHeight * widestAspect;
+        // Folga para as bordas não dependerem do arredondamento da rasterização
+        return (4.0f * halfWidth + 2.0f * halfHeight) * 1.05f;
+    }
+
+    // Escolhe entre a seleção na GPU com desenhos indiretos e a gravação de um desenho por instância na CPU
+    void createGpuCulling()
+    {
+        // Os comandos indiretos de todas as instâncias também são um storage buffer, e a seleção usa um grupo por
+        // WORKGROUP_SIZE instâncias em uma única dimensão
+        const VkPhysicalDeviceLimits &limits = physicalDeviceProperties.limits;
+        VkDeviceSize commandBytes = static_cast<VkDeviceSize>(SCENE_MATERIAL_COUNT) * options.instanceCount *
+                                    sizeof(VkDrawIndexedIndirectCommand);
+        uint32_t workgroups = (options.instanceCount + GpuCulling::WORKGROUP_SIZE - 1) / GpuCulling::WORKGROUP_SIZE;
+        bool withinLimits = options.instanceCount <= limits.maxDrawIndirectCount &&
+                            commandBytes <= limits.maxStorageBufferRange && workgroups <= limits.maxComputeWorkGroupCount[0];
+        gpuDrivenDraws = GpuDrivenPolicy::use(rendererPaths.gpuDriven && !options.cpuDraws && withinLimits);
+        if (gpuDrivenDraws && !withinLimits)
+        {
+            // Só acontece sem o caminho de CPU compilado (VKT_FEATURE_TIER=2)
+            throw std::runtime_error("--instances exceeds the device limits for GPU culling!");
+        }
+        if (useGpuDrivenDraws())
+        {
+            gpuCulling.init(device, allocator, bindlessHeap, computeTimeline, computeQueueFamily,
+                            queueFamilyIndices.graphicsFamily.value(), MAX_FRAMES_IN_FLIGHT, options.instanceCount,
+                            SCENE_MATERIAL_COUNT, startupFiles.cullShader, pipelineCache.handle());
+        }
+        std::cout << "scene: " << options.instanceCount << " instances, "
+                  << (useGpuDrivenDraws() ? "GPU culling with indirect count draws" : "CPU culling with one draw per instance")
+                  << std::endl;
+    }
+
+    // Cria o pipeline de pós-processamento, com um conjunto de descritores por quadro em voo e janela, e o controle da
+    // resolução dinâmica, que depende da ampliação feita por ele
+    void createPostProcess()
+    {
+        if (postProcessing)
+        {
+            postProcess.init(device, MAX_FRAMES_IN_FLIGHT, static_cast<uint32_t>(presentTargets.size()),
+                             startupFiles.postShader, pipelineCache.handle());
+        }
+        if (options.dynamicResolutionFps == 0)
+        {
+            return;
+        }
+        dynamicResolutionEnabled = postProcessing;
+        if (dynamicResolutionEnabled)
+        {
+            dynamicResolution.init(1000.0 / options.dynamicResolutionFps, options.minRenderScalePercent / 100.0f, 1.0f);
+            std::cout << "dynamic resolution: " << options.dynamicResolutionFps << " fps target, scale "
+                      << options.minRenderScalePercent << "-100%" << std::endl;
+        }
+        else
+        {
+            std::cout << "dynamic resolution: needs post processing, rendering at full size" << std::endl;
+        }
+    }
+
+    // Tamanho em que a cena de um alvo é desenhada neste quadro: o da imagem final ou, com resolução dinâmica, o
+    // retângulo escalado no canto da transitória
+    VkExtent2D sceneExtent(const PresentTarget &target) const
+    {
+        return dynamicResolutionEnabled ? dynamicResolution.scaledExtent(target.swapChainExtent) : target.swapChainExtent;
+    }
+
+    // Observa os shaders dos pipelines; os substitutos são criados na thread de recarga e aplicados entre quadros
+    void createShaderHotReload()
+    {
+        if (!options.shaderHotReload)
+        {
+            return;
+        }
+
+        shaderHotReload.start(device, GLSLC_PATH, SHADER_HOT_RELOAD_POLL_INTERVAL);
+
+        shaderHotReload.watch(
+            "graphics",
+            {{SHADER_DIR "shader.vert.spv", SHADER_SOURCE_DIR "shader.vert", VK_SHADER_STAGE_VERTEX_BIT},
+             {SHADER_DIR "shader.frag.spv", SHADER_SOURCE_DIR "shader.frag", VK_SHADER_STAGE_FRAGMENT_BIT}},
+            [this](const std::vector<std::vector<char>> &spirv)
+            {
+                std::lock_guard<std::mutex> lock(graphicsPipelineMutex);
+                VkPipeline pipeline = buildGraphicsPipeline(graphicsPipelineInputs, spirv[0], spirv[1]);
+                reloadedGraphicsGenerations[pipeline] = graphicsPipelineInputs.generation;
+                return pipeline;
+            },
+            [this](VkPipeline pipeline)
+            {
+                {
+                    // Um pipeline construído antes de uma troca de formato não é compatível com o passe atual; nunca
+                    // foi usado, então é destruído na hora (recreateFormatDependentPipelines já releu os shaders)
+                    std::lock_guard<std::mutex> lock(graphicsPipelineMutex);
+                    auto built = reloadedGraphicsGenerations.find(pipeline);
+                    bool current = built != reloadedGraphicsGenerations.end() &&
+                                   built->second == graphicsPipelineInputs.generation;
+                    if (built != reloadedGraphicsGenerations.end())
+                    {
+                        reloadedGraphicsGenerations.erase(built);
+                    }
+                    if (!current)
+                    {
+                        vkDestroyPipeline(device, pipeline, hostAllocationCallbacks());
+                        return false;
+                    }
+                }
+                // O pipeline antigo pode estar em uso pelos quadros em voo
+                VkPipeline old = graphicsPipeline;
+                graphicsPipeline = pipeline;
+                deletionQueue.defer(graphicsTimeline, graphicsTimeline.lastSubmitted(),
+                                    [this, old]() { vkDestroyPipeline(device, old, hostAllocationCallbacks()); });
+                return true;
+            });
+
+        if (useGpuDrivenDraws())
+        {
+            shaderHotReload.watch(
+                "culling",
+                {{SHADER_DIR "cull.comp.spv", SHADER_SOURCE_DIR "cull.comp", VK_SHADER_STAGE_COMPUTE_BIT}},
+                [this](const std::vector<std::vector<char>> &spirv) { return gpuCulling.createPipeline(spirv[0]); },
+                [this](VkPipeline pipeline)
+                {
+                    VkPipeline old = gpuCulling.swapPipeline(pipeline);
+                    deletionQueue.defer(computeTimeline, computeTimeline.lastSubmitted(),
+                                        [this, old]() { vkDestroyPipeline(device, old, hostAllocationCallbacks()); });
+                    return true;
+                });
+        }
+        if (postProcessing)
+        {
+            shaderHotReload.watch(
+                "post",
+                {{SHADER_DIR "post.comp.spv", SHADER_SOURCE_DIR "post.comp", VK_SHADER_STAGE_COMPUTE_BIT}},
+                [this](const std::vector<std::vector<char>> &spirv) { return postProcess.createPipeline(spirv[0]); },
+                [this](VkPipeline pipeline)
+                {
+                    // Gravado no buffer de comando de gráficos
+                    VkPipeline old = postProcess.swapPipeline(pipeline);
+                    deletionQueue.defer(graphicsTimeline, graphicsTimeline.lastSubmitted(),
+                                        [this, old]() { vkDestroyPipeline(device, old, hostAllocationCallbacks()); });
+                    return true;
+                });
+        }
+        std::cout << "shader hot reload: watching " << SHADER_SOURCE_DIR << std::endl;
+    }
+
+    // Câmera que percorre a grade em uma curva de Lissajous, para que a seleção mude a cada quadro
+    void updateCamera()
+    {
+        float time = script.fixedTimestep > 0.0f
+                         ? static_cast<float>(sceneFrame) * script.fixedTimestep
+                         : std::chrono::duration<float>(std::chrono::steady_clock::now() - sceneStartTime).count();
+        sceneFrame++;
+        uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(options.instanceCount))));
+        // As camadas de tela cheia só cobrem o alvo vistas de frente, do centro
+        float halfExtent = script.fullScreenInstances ? 0.0f : (columns - 1) * SCENE_GRID_SPACING * 0.5f;
+
+        glm::vec3 target(std::sin(time * 0.21f) * halfExtent, std::sin(time * 0.13f) * halfExtent, 0.0f);
+        cameraPosition = target + glm::vec3(0.0f, 0.0f, CAMERA_DISTANCE);
+        glm::mat4 view = glm::lookAt(cameraPosition, target, glm::vec3(0.0f, 1.0f, 0.0f));
+
+        // Cada janela projeta com a própria proporção. A seleção é uma só por quadro e usa a janela mais larga: com o
+        // mesmo campo de visão vertical, o frustum dela contém o de todas as outras
+        float widestAspect = 0.0f;
+        for (const FrameImage &frameImage : frameImages)
+        {
+            PresentTarget &target = *frameImage.target;
+            float aspect = static_cast<float>(target.swapChainExtent.width) / static_cast<float>(target.swapChainExtent.height);
+            glm::mat4 projection = glm::perspective(glm::radians(CAMERA_FOV_DEGREES), aspect, 0.1f, 100.0f);
+            // O eixo Y do espaço de recorte do Vulkan aponta para baixo
+            projection[1][1] *= -1.0f;
+
+            target.viewProjection = projection * view;
+            if (aspect > widestAspect)
+            {
+                widestAspect = aspect;
+                frustum = Frustum::fromViewProjection(target.viewProjection);
+            }
+        }
+    }
+
+    // Cria os semáforos usados para sincronizar os quadros em voo com a aquisição de imagens
+    // (o fim de cada quadro é acompanhado pela linha do tempo de gráficos, sem cercas)
+    void createSyncObjects()
+    {
+        // O valor 0 está sempre concluído, então o primeiro uso de cada quadro não espera
+        frameTimelineValues.assign(MAX_FRAMES_IN_FLIGHT, 0);
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        for (auto &target : presentTargets)
+        {
+            target.imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+            for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+            {
+                if (vkCreateSemaphore(device, &semaphoreInfo, hostAllocationCallbacks(), &target.imageAvailableSemaphores[i]) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("failed to create synchronization objects for a frame!");
+                }
+            }
+        }
+    }
+
+    // Cria os semáforos que dependem do número de imagens da cadeia de troca de um alvo
+    void createSwapChainSemaphores(PresentTarget &target)
+    {
+        target.renderFinishedSemaphores.resize(target.swapChainImages.size());
+        // As imagens da nova cadeia de troca ainda não pertencem a nenhum quadro
+        target.imagesInFlight.assign(target.swapChainImages.size(), 0);
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        for (size_t i = 0; i < target.renderFinishedSemaphores.size(); i++)
+        {
+            if (vkCreateSemaphore(device, &semaphoreInfo, hostAllocationCallbacks(), &target.renderFinishedSemaphores[i]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create synchronization objects for a swap chain image!");
+            }
+        }
+    }
+
+    // Grava os comandos de renderização de um quadro no buffer de comando informado: um passe da cena por alvo de
+    // frameImages e, com pós-processamento, um passe de compute que leva a cena à imagem do alvo
+    void recordCommandBuffer(VkCommandBuffer commandBuffer)
+    {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin recording command buffer!");
+        }
+
+        profiler.resetGpuScopes(commandBuffer, currentFrame);
+        profiler.beginGpuScope(commandBuffer, currentFrame, "frame");
+
+        // Recebe os buffers enviados pelo anel de staging neste quadro antes de lê-los
+        stagingRing.recordAcquireBarriers(commandBuffer, currentFrame);
+
+        // Os buffers secundários de todas as janelas saem dos pools deste quadro
+        if (!useGpuDrivenDraws())
+        {
+            recorder.beginFrame(currentFrame);
+        }
+
+        // A imagem chega da aquisição sem conteúdo útil (o passe a limpa ou sobrescreve) e sai pronta para a apresentação;
+        // o primeiro uso espera o estágio em que o semáforo de aquisição é esperado
+        renderGraph.reset();
+        RenderGraph::ImageState acquired{VK_IMAGE_LAYOUT_UNDEFINED, backbufferFirstStage(), 0};
+        // Sem cadeia de troca o layout de apresentação não existe; a imagem fica pronta para ser copiada
+        RenderGraph::ImageState presented{headless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                                          VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0};
+        for (size_t i = 0; i < frameImages.size(); i++)
+        {
+            const PresentTarget &target = *frameImages[i].target;
+            uint32_t imageIndex = frameImages[i].imageIndex;
+            std::string suffix = frameImages.size() > 1 ? " " + std::to_string(i) : "";
+            RenderGraph::Resource backbuffer = renderGraph.importImage("backbuffer" + suffix, target.swapChainImages[imageIndex],
+                                                                       target.swapChainImageViews[imageIndex],
+                                                                       VK_IMAGE_ASPECT_COLOR_BIT, acquired, presented);
+            if (!postProcessing)
+            {
+                renderGraph.addPass("scene" + suffix, [this, &target, imageIndex](VkCommandBuffer passCommands)
+                                    { recordScenePass(passCommands, target, imageIndex, target.swapChainImageViews[imageIndex]); })
+                    .use(backbuffer, RenderGraph::Access::ColorAttachment);
+                continue;
+            }
+
+            // A cena vai para uma transitória do tamanho da saída e o compute shader escreve a imagem do alvo. Com resolução
+            // dinâmica só o retângulo de sceneExtent é desenhado, então a transitória não muda com a escala
+            RenderGraph::Resource sceneColor = renderGraph.createImage(
+                "scene color" + suffix, RenderGraph::ImageDesc{PostProcess::SCENE_COLOR_FORMAT, target.swapChainExtent, 0});
+            renderGraph.addPass("scene" + suffix, [this, &target, imageIndex, sceneColor](VkCommandBuffer passCommands)
+                                { recordScenePass(passCommands, target, imageIndex, renderGraph.imageView(sceneColor)); })
+                .use(sceneColor, RenderGraph::Access::ColorAttachment);
+            renderGraph.addPass("post" + suffix, [this, &target, i, sceneColor, backbuffer](VkCommandBuffer passCommands)
+                                {
+                                    PostSettings settings;
+                                    settings.encoding = outputEncoding;
+                                    settings.paperWhiteNits = HDR_PAPER_WHITE_NITS;
+                                    profiler.beginGpuScope(passCommands, currentFrame, "post");
+                                    postProcess.record(passCommands, currentFrame, static_cast<uint32_t>(i),
+                                                       renderGraph.imageView(sceneColor), sceneExtent(target),
+                                                       target.swapChainExtent, renderGraph.imageView(backbuffer),
+                                                       target.swapChainExtent, settings);
+                                    profiler.endGpuScope(passCommands, currentFrame);
+                                })
+                .use(sceneColor, RenderGraph::Access::ComputeSampled)
+                .use(backbuffer, RenderGraph::Access::ComputeStorageWrite);
+        }
+        renderGraph.compile();
+        renderGraph.execute(commandBuffer);
+
+        profiler.endGpuScope(commandBuffer, currentFrame);
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to record command buffer!");
+        }
+    }
+
+    // Passe da cena no grafo: desenha as instâncias na imagem da cadeia de troca de um alvo, ou na transitória da cena
+    // com pós-processamento
+    // Com renderização dinâmica o anexo é colorView; senão, o framebuffer da imagem no passe de renderização.
+    // Nos dois casos a imagem já está em COLOR_ATTACHMENT_OPTIMAL pelas barreiras do grafo
+    void recordScenePass(VkCommandBuffer commandBuffer, const PresentTarget &target, uint32_t imageIndex, VkImageView colorView)
+    {
+        VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
+        VkRect2D renderArea{{0, 0}, sceneExtent(target)};
+
+        VkRenderingAttachmentInfo colorAttachment{};
+        colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        colorAttachment.imageView = colorView;
+        colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.clearValue = clearColor;
+
+        VkRenderingInfo renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        renderingInfo.renderArea = renderArea;
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachments = &colorAttachment;
+
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = useDynamicRendering() ? VK_NULL_HANDLE : target.swapChainFramebuffers[imageIndex];
+        renderPassInfo.renderArea = renderArea;
+        renderPassInfo.clearValueCount = 1;
+        renderPassInfo.pClearValues = &clearColor;
+
+        profiler.beginGpuScope(commandBuffer, currentFrame, SCENE_GPU_SCOPE);
+        if (useGpuDrivenDraws())
+        {
+            // Poucos comandos, independentes do número de instâncias: gravados direto no buffer primário
+            if (useDynamicRendering())
+            {
+                vkCmdBeginRendering(commandBuffer, &renderingInfo);
+            }
+            else
+            {
+                vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+            }
+            recordSceneState(commandBuffer, target);
+            for (uint32_t material = 0; material < SCENE_MATERIAL_COUNT; material++)
+            {
+                gpuCulling.recordDraws(commandBuffer, currentFrame, material);
+            }
+        }
+        else
+        {
+            // O conteúdo do passe vem inteiro dos buffers secundários, que herdam o passe ou os formatos dos anexos
+            VkCommandBufferInheritanceRenderingInfo inheritanceRendering{};
+            inheritanceRendering.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+            inheritanceRendering.colorAttachmentCount = 1;
+            inheritanceRendering.pColorAttachmentFormats = &sceneColorFormat;
+            inheritanceRendering.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+            VkCommandBufferInheritanceInfo inheritance{};
+            inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            if (useDynamicRendering())
+            {
+                renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+                vkCmdBeginRendering(commandBuffer, &renderingInfo);
+                inheritance.pNext = &inheritanceRendering;
+            }
+            else
+            {
+                vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+                inheritance.renderPass = renderPass;
+                inheritance.subpass = 0;
+                inheritance.framebuffer = target.swapChainFramebuffers[imageIndex];
+            }
+
+            std::vector<VkCommandBuffer> secondaries = recorder.record(
+                currentFrame, inheritance, sceneDrawCount,
+                [this, &target](VkCommandBuffer secondary, uint32_t first, uint32_t last) { recordDraws(secondary, target, first, last); });
+            if (!secondaries.empty())
+            {
+                vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+            }
+        }
+
+        if (useDynamicRendering())
+        {
+            vkCmdEndRendering(commandBuffer);
+        }
+        else
+        {
+            vkCmdEndRenderPass(commandBuffer);
+        }
+        profiler.endGpuScope(commandBuffer, currentFrame);
+    }
+
+    // Vincula o pipeline, os buffers e o heap e define o estado dinâmico e as push constants dos desenhos da cena
+    void recordSceneState(VkCommandBuffer commandBuffer, const PresentTarget &target)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+
+        VkExtent2D extent = sceneExtent(target);
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(extent.width);
+        viewport.height = static_cast<float>(extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        VkRect2D scissor{};
+        scissor.offset = {0, 0};
+        scissor.extent = extent;
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        VkBuffer vertexBuffers[] = {vertexBuffer};
+        VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+        bindlessHeap.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout);
+
+        DrawPushConstants pushConstants{};
+        pushConstants.viewProjection = target.viewProjection;
+        pushConstants.instanceBufferIndex = instanceBufferIndex;
+        pushConstants.textureTableIndex = textureStreamer.tableIndex(currentFrame);
+        vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0, sizeof(pushConstants), &pushConstants);
+    }
+
+    // Grava os desenhos das instâncias [first, last) visíveis em um buffer secundário (caminho de CPU)
+    // Chamado em paralelo pelas threads de gravação: só lê o estado da aplicação
+    void recordDraws(VkCommandBuffer commandBuffer, const PresentTarget &target, uint32_t first, uint32_t last)
+    {
+        FrameProfiler::CpuScope scope(profiler, "record draws");
+
+        // Buffers secundários não herdam estado: cada um vincula o pipeline e define o estado dinâmico
+        recordSceneState(commandBuffer, target);
+
+        // A instância chega ao vertex shader por firstInstance, como nos desenhos indiretos
+        for (uint32_t i = first; i < last; i++)
+        {
+            const SceneInstance &instance = sceneInstances[i];
+            glm::vec3 center(instance.positionScale.x, instance.positionScale.y, instance.positionScale.z);
+            if (!frustum.intersectsSphere(center, instance.boundingRadius))
+            {
+                continue;
+            }
+            const SceneMesh &mesh = sceneMeshes[instance.meshIndex];
+            vkCmdDrawIndexed(commandBuffer, mesh.indexCount, 1, mesh.firstIndex, mesh.vertexOffset, i);
+        }
+    }
+
+    // Desenha um quadro: adquire uma imagem de cada janela, grava e submete os comandos e apresenta todas de uma vez
+    // Nenhuma espera pela fila ociosa é feita; a CPU só bloqueia quando todos os quadros em voo estão ocupados
+    void drawFrame()
+    {
+        // Espera a GPU liberar os recursos deste quadro (submetidos MAX_FRAMES_IN_FLIGHT quadros atrás)
+        {
+            FrameProfiler::CpuScope scope(profiler, "wait");
+            graphicsTimeline.wait(frameTimelineValues[currentFrame]);
+        }
+        // Os timestamps de GPU daquele quadro já podem ser lidos sem bloquear
+        profiler.beginFrame(currentFrame);
+        // A escala muda só entre quadros: a gravação (inclusive a dos buffers secundários) lê sempre a mesma
+        if (dynamicResolutionEnabled)
+        {
+            // Só os passes da cena dependem da escala; o pós-processamento e o resto do quadro são custo fixo
+            dynamicResolution.addGpuTime(profiler.lastGpuFrameMilliseconds(),
+                                         profiler.lastGpuScopeMilliseconds(SCENE_GPU_SCOPE));
+        }
+
+        // Ritmo pelo vblank: espera a apresentação anterior chegar à tela antes de amostrar a entrada e gravar o quadro
+        // (IMMEDIATE é usado para medir a vazão máxima, então não é limitado)
+        if (presentWaitEnabled && presentPolicy != PresentPolicy::Immediate)
+        {
+            FrameProfiler::CpuScope scope(profiler, "present wait");
+            for (const auto &target : presentTargets)
+            {
+                // VK_TIMEOUT e erros de cadeia desatualizada são tratados pela aquisição e apresentação a seguir
+                if (!target.minimized && target.presentId > PRESENT_WAIT_LAG)
+                {
+                    pfnWaitForPresentKHR(device, target.swapChain, target.presentId - PRESENT_WAIT_LAG, PRESENT_WAIT_TIMEOUT_NS);
+                }
+            }
+        }
+
+        // Troca os pipelines reconstruídos pela recarga de shaders; os antigos entram na fila de destruição
+        shaderHotReload.applyPending();
+        // Libera os objetos adiados cujo último uso já terminou (como cadeias de troca antigas)
+        collectPresentFences();
+        deletionQueue.collect();
+        // e o espaço do anel de staging cujas cópias já terminaram
+        stagingRing.beginFrame();
+
+        frameImages.clear();
+        VkResult result = VK_SUCCESS;
+        if (headless())
+        {
+            // Sem cadeia de troca: cada quadro em voo renderiza na própria imagem fora da tela
+            frameImages.push_back({&presentTargets[0], currentFrame});
+        }
+        else
+        {
+            // Cadeias desatualizadas na aquisição do quadro anterior e janelas que estavam minimizadas
+            recreatePendingSwapChains();
+
+            FrameProfiler::CpuScope scope(profiler, "acquire");
+            for (auto &target : presentTargets)
+            {
+                if (target.minimized)
+                {
+                    continue;
+                }
+                uint32_t imageIndex;
+                result = vkAcquireNextImageKHR(device, target.swapChain, UINT64_MAX, target.imageAvailableSemaphores[currentFrame],
+                                               VK_NULL_HANDLE, &imageIndex);
+                if (result == VK_ERROR_OUT_OF_DATE_KHR)
+                {
+                    // A cadeia de troca não é mais compatível com a superfície; o semáforo não foi sinalizado. A janela
+                    // fica fora deste quadro e é recriada no próximo, sem atrasar as outras
+                    target.framebufferResized = true;
+                    continue;
+                }
+                else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+                {
+                    throw std::runtime_error("failed to acquire swap chain image!");
+                }
+                frameImages.push_back({&target, imageIndex});
+            }
+        }
+
+        if (frameImages.empty())
+        {
+            // Nenhuma janela para renderizar: com todas minimizadas, dorme até o próximo evento em vez de girar
+            bool allMinimized = std::all_of(presentTargets.begin(), presentTargets.end(),
+                                            [](const PresentTarget &target) { return target.minimized; });
+            if (allMinimized)
+            {
+                glfwWaitEvents();
+            }
+            return;
+        }
+
+        // Se um quadro anterior ainda estiver usando alguma destas imagens, espera por ele
+        for (const FrameImage &frameImage : frameImages)
+        {
+            graphicsTimeline.wait(frameImage.target->imagesInFlight[frameImage.imageIndex]);
+        }
+
+        StagingFlush uploads;
+        uint64_t cullValue = 0;
+        {
+            FrameProfiler::CpuScope scope(profiler, "record");
+
+            updateCamera();
+            // Troca as texturas carregadas desde o último quadro; as cópias delas entram no flush logo abaixo
+            requestSceneTextures();
+            textureStreamer.update(currentFrame, graphicsTimeline, deletionQueue);
+
+            uploadScriptedData();
+            // Submete os uploads pendentes na fila de transferência antes de gravar as aquisições deste quadro
+            uploads = stagingRing.flush(currentFrame);
+            // Descritores registrados desde o último quadro (o conjunto pode ser atualizado mesmo vinculado)
+            bindlessHeap.flushUpdates();
+
+            if (useGpuDrivenDraws())
+            {
+                // A seleção lê as instâncias enviadas neste quadro, então espera os uploads na fila de computação
+                FrameProfiler::CpuScope cullScope(profiler, "cull");
+                cullValue = gpuCulling.cull(currentFrame, frustum, instanceBufferIndex, meshBufferIndex,
+                                            options.instanceCount, &transferTimeline, uploads.value);
+            }
+
+            vkResetCommandBuffer(commandBuffers[currentFrame], 0);
+            recordCommandBuffer(commandBuffers[currentFrame]);
+        }
+
+        // A escrita nos anexos de cor só começa depois que as imagens estiverem disponíveis,
+        // e a leitura dos dados enviados depois que as cópias terminarem
+        SubmitBatch batch;
+        if (!headless())
+        {
+            for (const FrameImage &frameImage : frameImages)
+            {
+                batch.wait(frameImage.target->imageAvailableSemaphores[currentFrame], backbufferFirstStage());
+            }
+        }
+        if (uploads.value != 0)
+        {
+            batch.wait(transferTimeline, uploads.value, uploads.waitStage);
+        }
+        // Os comandos e contagens indiretos são lidos depois que a seleção deste quadro terminar
+        if (cullValue != 0)
+        {
+            batch.wait(computeTimeline, cullValue, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+        }
+        batch.addCommandBuffer(commandBuffers[currentFrame]);
+        // Sem apresentação não há quem espere pelo fim da renderização além da linha do tempo
+        if (!headless())
+        {
+            for (const FrameImage &frameImage : frameImages)
+            {
+                batch.signal(frameImage.target->renderFinishedSemaphores[frameImage.imageIndex]);
+            }
+        }
+
+        // A linha do tempo de gráficos alcança o valor deste quadro quando a GPU terminá-lo
+        {
+            FrameProfiler::CpuScope scope(profiler, "submit");
+            if (graphicsTimeline.submit(batch, frameTimelineValues[currentFrame]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to submit draw command buffer!");
+            }
+        }
+        for (const FrameImage &frameImage : frameImages)
+        {
+            frameImage.target->imagesInFlight[frameImage.imageIndex] = frameTimelineValues[currentFrame];
+        }
+
+        if (headless())
+        {
+            currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+            return;
+        }
+
+        // Uma única apresentação para todas as janelas do quadro
+        std::vector<VkSemaphore> waitSemaphores;
+        std::vector<VkSwapchainKHR> swapChains;
+        std::vector<uint32_t> imageIndices;
+        std::vector<uint64_t> presentIds;
+        for (const FrameImage &frameImage : frameImages)
+        {
+            waitSemaphores.push_back(frameImage.target->renderFinishedSemaphores[frameImage.imageIndex]);
+            swapChains.push_back(frameImage.target->swapChain);
+            imageIndices.push_back(frameImage.imageIndex);
+            presentIds.push_back(frameImage.target->presentId + 1);
+        }
+        std::vector<VkResult> results(frameImages.size(), VK_SUCCESS);
+
+        VkPresentInfoKHR presentInfo{};
+        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        presentInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+        presentInfo.pWaitSemaphores = waitSemaphores.data();
+        presentInfo.swapchainCount = static_cast<uint32_t>(swapChains.size());
+        presentInfo.pSwapchains = swapChains.data();
+        presentInfo.pImageIndices = imageIndices.data();
+        // O resultado de cada cadeia: uma janela desatualizada não invalida a apresentação das outras
+        presentInfo.pResults = results.data();
+
+        // Identifica a apresentação para que quadros futuros possam esperar por ela
+        VkPresentIdKHR presentIdInfo{};
+        if (presentWaitEnabled)
+        {
+            presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+            presentIdInfo.swapchainCount = static_cast<uint32_t>(presentIds.size());
+            presentIdInfo.pPresentIds = presentIds.data();
+            presentInfo.pNext = &presentIdInfo;
+        }
+        // Uma cerca por cadeia, sinalizada quando a apresentação não precisar mais dos semáforos nem da cadeia
+        std::vector<VkFence> presentFences;
+        VkSwapchainPresentFenceInfoEXT presentFenceInfo{};
+        if (presentFencesEnabled)
+        {
+            for (size_t i = 0; i < frameImages.size(); i++)
+            {
+                presentFences.push_back(acquirePresentFence());
+            }
+            presentFenceInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_FENCE_INFO_EXT;
+            presentFenceInfo.pNext = presentInfo.pNext;
+            presentFenceInfo.swapchainCount = static_cast<uint32_t>(presentFences.size());
+            presentFenceInfo.pFences = presentFences.data();
+            presentInfo.pNext = &presentFenceInfo;
+        }
+
+        VkResult presentResult;
+        {
+            FrameProfiler::CpuScope scope(profiler, "present");
+            std::lock_guard<std::mutex> lock(*presentQueueMutex);
+            presentResult = vkQueuePresentKHR(presentQueue, &presentInfo);
+        }
+        // O resultado geral é o pior dos de cada cadeia, mas erros do dispositivo podem não ser escritos em pResults
+        if (presentResult != VK_SUCCESS && presentResult != VK_SUBOPTIMAL_KHR && presentResult != VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            throw std::runtime_error("failed to present swap chain image!");
+        }
+
+        currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+
+        for (size_t i = 0; i < frameImages.size(); i++)
+        {
+            PresentTarget &target = *frameImages[i].target;
+            target.presentId = presentIds[i];
+            if (presentFencesEnabled)
+            {
+                target.presentFences.push_back(presentFences[i]);
+            }
+            if (results[i] == VK_ERROR_OUT_OF_DATE_KHR || results[i] == VK_SUBOPTIMAL_KHR || presentPolicyChanged)
+            {
+                target.framebufferResized = true;
+            }
+            else if (results[i] != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to present swap chain image!");
+            }
+        }
+        // A troca de política vale para as janelas que não entraram neste quadro também
+        if (presentPolicyChanged)
+        {
+            for (auto &target : presentTargets)
+            {
+                target.framebufferResized = true;
+            }
+            presentPolicyChanged = false;
+        }
+        if (script.recreateSwapChainEveryFrame)
+        {
+            for (auto &target : presentTargets)
+            {
+                target.framebufferResized = true;
+            }
+        }
+        // Recria depois da apresentação para não descartar o quadro já renderizado
+        recreatePendingSwapChains();
+    }
+
+    // Escolhe o formato da superfície da cadeia de troca pela política (--surface-format)
+    // Depois da primeira cadeia de troca o formato é mantido enquanto a superfície o oferecer: os pipelines foram criados
+    // com ele (e com a sua codificação) e servem a todas as janelas
+    VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &availableFormats)
+    {
+        if (swapChainImageFormat != VK_FORMAT_UNDEFINED)
+        {
+            for (const auto &availableFormat : availableFormats)
+            {
+                if (availableFormat.format == swapChainImageFormat && availableFormat.colorSpace == swapChainColorSpace)
+                {
+                    return availableFormat;
+                }
+            }
+
+            // O formato deixou de ser oferecido (o monitor saiu do modo HDR, ou a janela foi para outra tela): cai para o
+            // sRGB de 8 bits, e recreateSwapChain recria os pipelines e as outras janelas para ele
+            std::optional<VkSurfaceFormatKHR> fallback = chooseSurfaceFormat(
+                SurfaceFormatPolicy::Sdr8, availableFormats,
+                [this](VkFormat format) { return !postProcessing || PostProcess::supportsStorageOutput(physicalDevice, format); });
+            if (!fallback.has_value() && postProcessing)
+            {
+                throw std::runtime_error("failed to find a storage surface format for every window!");
+            }
+            VkSurfaceFormatKHR surfaceFormat = fallback.value_or(availableFormats[0]);
+            std::cout << "surface format: " << surfaceFormatName({swapChainImageFormat, swapChainColorSpace})
+                      << " is no longer offered, falling back to " << surfaceFormatName(surfaceFormat) << std::endl;
+            return surfaceFormat;
+        }
+
+        // Nenhum formato conhecido: o primeiro, com a codificação deduzida do espaço de cores
+        return chooseSurfaceFormat(options.surfaceFormatPolicy, availableFormats, [](VkFormat) { return true; })
+            .value_or(availableFormats[0]);
+    }
+
+    // Escolhe o modo de apresentação da cadeia de troca de acordo com a política atual
+    VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes)
+    {
+        return choosePresentMode(presentPolicy, availablePresentModes);
+    }
+
+    // Escolhe a extensão da cadeia de troca
+    VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities, GLFWwindow *window)
+    {
+        // Se a largura e altura da cadeia de troca forem diferentes de std::numeric_limits<uint32_t>::max(), retorna as dimensões atuais
+        if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max())
+        {
+            return capabilities.currentExtent;
+        }
+        else // Caso contrário, ajusta as dimensões da cadeia de troca para se ajustar à janela
+        {
+            int width, height;
+            glfwGetFramebufferSize(window, &width, &height);
+
+            VkExtent2D actualExtent = {
+                static_cast<uint32_t>(width),
+                static_cast<uint32_t>(height)};
+
+            actualExtent.width = std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+            actualExtent.height = std::clamp(actualExtent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+
+            return actualExtent;
+        }
+    }
+
+    // Verifica se o dispositivo é adequado para a aplicação
+    bool isDeviceSuitable(const PhysicalDeviceInfo &device)
+    {
+        // Indices das famílias de fila suportadas pelo dispositivo
+        QueueFamilyIndices indices = findQueueFamilies(device);
+
+        // O escalonamento dos quadros usa semáforos de linha do tempo e os shaders acessam os recursos pelo heap bindless
+        // (ambos do Vulkan 1.2)
+        const DeviceCapabilities &capabilities = device.capabilities;
+        if (!capabilities.timelineSemaphore || !capabilities.supportsBindless())
+        {
+            return false;
+        }
+        // Caminhos compilados sem alternativa
+        if (!RendererPaths::select(capabilities).coversBuild())
+        {
+            return false;
+        }
+
+        // Sem janela basta uma família de gráficos: não há superfície nem cadeia de troca
+        if (headless())
+        {
+            return indices.isComplete(false);
+        }
+
+        // Verifica se o dispositivo suporta as extensões necessárias
+        bool extensionsSupported = checkDeviceExtensionSupport(device);
+
+        // Verifica se o dispositivo suporta a cadeia de troca
+        bool swapChainAdequate = false;
+        if (extensionsSupported)
+        {
+            swapChainAdequate = !device.surfaceFormats.empty() && !device.presentModes.empty();
+        }
+
+        return indices.isComplete() && extensionsSupported && swapChainAdequate;
+    }
+
+    bool checkDeviceExtensionSupport(const PhysicalDeviceInfo &device)
+    {
+        // Cria um conjunto com as extensões necessárias
+        std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
+
+        // Remove as extensões disponíveis do conjunto de extensões necessárias
+        for (const auto &extension : device.extensions)
+        {
+            requiredExtensions.erase(extension.extensionName);
+        }
+
+        return requiredExtensions.empty();
+    }
+
+    // Encontra as famílias de fila suportadas pelo dispositivo
+    QueueFamilyIndices findQueueFamilies(const PhysicalDeviceInfo &device)
+    {
+        QueueFamilyIndices indices;
+
+        const std::vector<VkQueueFamilyProperties> &queueFamilies = device.queueFamilies;
+        uint32_t queueFamilyCount = static_cast<uint32_t>(queueFamilies.size());
+
+        uint32_t i = 0;
+        for (const auto &queueFamily : queueFamilies)
+        {
+            if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !indices.graphicsFamily.has_value())
+            {
+                indices.graphicsFamily = i;
+            }
+
+            VkBool32 presentSupport = device.presentSupport[i];
+            // A cache só conhece a superfície da primeira janela; a família precisa apresentar em todas
+            for (size_t target = 1; presentSupport && target < presentTargets.size(); target++)
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device.device, i, presentTargets[target].surface, &presentSupport);
+            }
+
+            // Prefere apresentar na mesma família de gráficos para evitar o compartilhamento concorrente das imagens
+            if (presentSupport && (!indices.presentFamily.has_value() || indices.graphicsFamily == i))
+            {
+                indices.presentFamily = i;
+            }
+
+            i++;
+        }
+
+        // Procura as famílias assíncronas sem parar na primeira família completa:
+        // a cópia prefere uma família só de transferência (motor DMA) e a computação uma família diferente da de cópia
+        for (i = 0; i < queueFamilyCount; i++)
+        {
+            VkQueueFlags flags = queueFamilies[i].queueFlags;
+            bool graphics = flags & VK_QUEUE_GRAPHICS_BIT;
+            bool compute = flags & VK_QUEUE_COMPUTE_BIT;
+            bool transfer = flags & VK_QUEUE_TRANSFER_BIT;
+
+            if (transfer && !graphics && !compute)
+            {
+                indices.transferFamily = i;
+            }
+            else if (compute && !graphics && !indices.computeFamily.has_value())
+            {
+                indices.computeFamily = i;
+            }
+        }
+
+        // Sem motor DMA dedicado, uma família de computação também serve para cópias fora da fila de gráficos
+        if (!indices.transferFamily.has_value() && indices.computeFamily.has_value())
+        {
+            indices.transferFamily = indices.computeFamily;
+        }
+
+        return indices;
+    }
+
+    // Retorna as extensões necessárias para criar a instância
+    std::vector<const char *> getRequiredExtensions()
+    {
+        std::vector<const char *> extensions;
+
+        // Sem janela as extensões de superfície não são necessárias
+        if (!headless())
+        {
+            uint32_t glfwExtensionCount = 0;
+            const char **glfwExtensions;
+            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
+
+        if (enableValidationLayers)
+        {
+            extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        }
+
+        // Sem VK_EXT_swapchain_colorspace as superfícies só informam o espaço de cores sRGB não linear
+        if (!headless() && surfaceFormatPolicyWantsExtendedColorSpaces(options.surfaceFormatPolicy) &&
+            isInstanceExtensionSupported(VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME))
+        {
+            extensions.push_back(VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME);
+        }
+
+        // Pré-requisito de VK_EXT_swapchain_maintenance1 (cercas de apresentação), habilitada no dispositivo se houver
+        surfaceMaintenanceAvailable = !headless() &&
+                                      isInstanceExtensionSupported(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME) &&
+                                      isInstanceExtensionSupported(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
+        if (surfaceMaintenanceAvailable)
+        {
+            for (const char *name : {VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME, VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME})
+            {
+                if (std::none_of(extensions.begin(), extensions.end(),
+                                 [name](const char *enabled) { return strcmp(enabled, name) == 0; }))
+                {
+                    extensions.push_back(name);
+                }
+            }
+        }
+
+        return extensions;
+    }
+
+    // Verifica se as camadas de validação solicitadas estão disponíveis na instância Vulkan
+    bool checkValidationLayerSupport()
+    {
+        uint32_t layerCount;
+        vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+
+        std::vector<VkLayerProperties> availableLayers(layerCount);
+        vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
+
+        // Verifica se cada camada do vetor validationLayers existe entre as camadas disponíveis
+        for (const char *layerName : validationLayers)
+        {
+            bool layerFound = false;
+
+            for (const auto &layerProperties : availableLayers)
+            {
+                if (strcmp(layerName, layerProperties.layerName) == 0)
+                {
+                    layerFound = true;
+                    break;
+                }
+            }
+
+            if (!layerFound)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Lê um arquivo binário inteiro (usado para carregar os shaders SPIR-V)
+    static std::vector<char> readFile(const std::string &filename)
+    {
+        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+        if (!file.is_open())
+        {
+            throw std::runtime_error("failed to open file: " + filename);
+        }
+
+        size_t fileSize = static_cast<size_t>(file.tellg());
+        std::vector<char> buffer(fileSize);
+
+        file.seekg(0);
+        file.read(buffer.data(), fileSize);
+
+        return buffer;
+    }
+
+    // Função de callback que será chamada quando houver mensagens de validação ou erro do Vulkan
+    // Pode ser chamada de qualquer thread que use o Vulkan, inclusive as de gravação: só enfileira a mensagem
+    static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData, void *pUserData)
+    {
+        LogLevel level = LogLevel::Info;
+        if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT)
+        {
+            level = LogLevel::Error;
+        }
+        else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
+        {
+            level = LogLevel::Warning;
+        }
+
+        // Envia a mensagem ao registro assíncrono (escrita no stderr pela thread do registro)
+        auto log = reinterpret_cast<AsyncLogger *>(pUserData);
+        log->log(level, "validation layer", pCallbackData->pMessage);
+        // Retornar VK_FALSE indica que não está sendo requisitada nenhuma ação adicional
+        return VK_FALSE;
+    }
+};
+
+RunReport runApplication(const AppOptions &options, const RunScript &script)
+{
+    HelloTriangleApplication app(options, script);
+    return app.run();
+}
@@ -0,0 +1,408 @@
+#include "asset_pack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Dimensões em texels e tamanho em bytes de um bloco do formato; false para formatos que o contêiner não descreve
+static bool formatBlock(uint32_t format, uint32_t &blockWidth, uint32_t &blockHeight, uint32_t &blockBytes)
+{
+    blockWidth = 1;
+    blockHeight = 1;
+    switch (static_cast<VkFormat>(format))
+    {
+    case VK_FORMAT_R8_UNORM:
+        blockBytes = 1;
+        return true;
+    case VK_FORMAT_R8G8_UNORM:
+        blockBytes = 2;
+        return true;
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+        blockBytes = 4;
+        return true;
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+        blockBytes = 8;
+        return true;
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+    case VK_FORMAT_BC4_SNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+    case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+    case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+        blockWidth = 4;
+        blockHeight = 4;
+        blockBytes = 8;
+        return true;
+    case VK_FORMAT_BC2_UNORM_BLOCK:
+    case VK_FORMAT_BC2_SRGB_BLOCK:
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+    case VK_FORMAT_BC5_SNORM_BLOCK:
+    case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+    case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+    case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+    case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+        blockWidth = 4;
+        blockHeight = 4;
+        blockBytes = 16;
+        return true;
+    default:
+        break;
+    }
+
+    // ASTC: 16 bytes por bloco; os formatos vêm em pares UNORM/SRGB, na ordem dos tamanhos de bloco
+    static const uint32_t ASTC_BLOCKS[][2] = {{4, 4}, {5, 4}, {5, 5}, {6, 5}, {6, 6}, {8, 5}, {8, 6},
+                                              {8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12}};
+    if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+    {
+        const uint32_t *block = ASTC_BLOCKS[(format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2];
+        blockWidth = block[0];
+        blockHeight = block[1];
+        blockBytes = 16;
+        return true;
+    }
+    return false;
+}
+
+AssetPack::~AssetPack()
+{
+    close();
+}
+
+void AssetPack::open(const std::string &path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("failed to open asset pack " + path + "!");
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *view = fileMapping != nullptr ? MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr)
+    {
+        if (fileMapping != nullptr)
+        {
+            CloseHandle(fileMapping);
+        }
+        CloseHandle(file);
+        throw std::runtime_error("failed to map asset pack " + path + "!");
+    }
+    fileHandle = file;
+    mappingHandle = fileMapping;
+    mapping = view;
+    mappedSize = static_cast<uint64_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("failed to open asset pack " + path + "!");
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size == 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("failed to map asset pack " + path + "!");
+    }
+    void *view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // O mapeamento continua válido depois de fechar o descritor
+    ::close(fd);
+    if (view == MAP_FAILED)
+    {
+        throw std::runtime_error("failed to map asset pack " + path + "!");
+    }
+    // Os mips são lidos sob demanda pelo streaming de texturas, fora de ordem
+    madvise(view, static_cast<size_t>(status.st_size), MADV_RANDOM);
+    mapping = view;
+    mappedSize = static_cast<uint64_t>(status.st_size);
+#endif
+
+    try
+    {
+        validate(path);
+    }
+    catch (...)
+    {
+        close();
+        throw;
+    }
+}
+
+void AssetPack::close()
+{
+    if (mapping == nullptr)
+    {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(mapping, static_cast<size_t>(mappedSize));
+#endif
+    mapping = nullptr;
+    mappedSize = 0;
+}
+
+void AssetPack::validate(const std::string &path) const
+{
+    auto fail = [&](const char *reason)
+    {
+        throw std::runtime_error("invalid asset pack " + path + ": " + reason + "!");
+    };
+    // Faixa [offset, offset + size) dentro do arquivo, sem estouro na soma
+    auto inFile = [&](uint64_t offset, uint64_t size)
+    {
+        return offset <= mappedSize && size <= mappedSize - offset;
+    };
+
+    if (mappedSize < sizeof(AssetPackHeader))
+    {
+        fail("file too small");
+    }
+    const AssetPackHeader &pack = header();
+    if (pack.magic != ASSET_PACK_MAGIC)
+    {
+        fail("bad magic");
+    }
+    if (pack.version != ASSET_PACK_VERSION)
+    {
+        fail("unsupported version");
+    }
+    if (pack.fileSize != mappedSize)
+    {
+        fail("truncated file");
+    }
+    if (!inFile(pack.meshTableOffset, uint64_t(pack.meshCount) * sizeof(AssetMeshRecord)) ||
+        !inFile(pack.textureTableOffset, uint64_t(pack.textureCount) * sizeof(AssetTextureRecord)) ||
+        pack.meshTableOffset % ASSET_PACK_ALIGNMENT != 0 || pack.textureTableOffset % ASSET_PACK_ALIGNMENT != 0 ||
+        pack.mipTableOffset % ASSET_PACK_ALIGNMENT != 0)
+    {
+        fail("record tables out of range");
+    }
+
+    for (uint32_t i = 0; i < pack.meshCount; i++)
+    {
+        const AssetMeshRecord &record = mesh(i);
+        uint64_t indexSize = record.indexType == VK_INDEX_TYPE_UINT16 ? 2 : 4;
+        if (record.attributeCount > ASSET_PACK_MAX_ATTRIBUTES ||
+            record.vertexDataSize != uint64_t(record.vertexCount) * record.vertexStride ||
+            record.indexDataSize != uint64_t(record.indexCount) * indexSize ||
+            !inFile(record.vertexDataOffset, record.vertexDataSize) || !inFile(record.indexDataOffset, record.indexDataSize))
+        {
+            fail("mesh data out of range");
+        }
+    }
+
+    uint64_t mipCount = 0;
+    for (uint32_t i = 0; i < pack.textureCount; i++)
+    {
+        const AssetTextureRecord &record = texture(i);
+        // A cadeia não passa do mip 1x1: floor(log2(maior lado)) + 1 níveis
+        uint32_t maxLevels = 0;
+        for (uint32_t side = std::max(record.width, record.height); side != 0; side >>= 1)
+        {
+            maxLevels++;
+        }
+        if (record.width == 0 || record.height == 0 || record.mipLevels == 0 || record.mipLevels > maxLevels ||
+            record.firstMip != mipCount)
+        {
+            fail("bad texture mip chain");
+        }
+        uint32_t blockWidth, blockHeight, blockBytes;
+        if (!formatBlock(record.format, blockWidth, blockHeight, blockBytes))
+        {
+            fail("unsupported texture format");
+        }
+        mipCount += record.mipLevels;
+    }
+    if (!inFile(pack.mipTableOffset, mipCount * sizeof(AssetMipRecord)))
+    {
+        fail("mip table out of range");
+    }
+    for (uint64_t i = 0; i < mipCount; i++)
+    {
+        const auto &record = static_cast<const AssetMipRecord *>(data(pack.mipTableOffset))[i];
+        if (!inFile(record.dataOffset, record.dataSize) || record.dataOffset % ASSET_PACK_ALIGNMENT != 0)
+        {
+            fail("mip data out of range");
+        }
+    }
+
+    // Cada mip tem o tamanho do nível e dados para todos os blocos dele (vkCmdCopyBufferToImage lê linhas compactas)
+    for (uint32_t i = 0; i < pack.textureCount; i++)
+    {
+        const AssetTextureRecord &record = texture(i);
+        uint32_t blockWidth, blockHeight, blockBytes;
+        formatBlock(record.format, blockWidth, blockHeight, blockBytes);
+        for (uint32_t level = 0; level < record.mipLevels; level++)
+        {
+            const AssetMipRecord &mipRecord = mip(i, level);
+            if (mipRecord.width != std::max(record.width >> level, 1u) ||
+                mipRecord.height != std::max(record.height >> level, 1u))
+            {
+                fail("mip extent does not match the texture");
+            }
+            uint64_t blocks = uint64_t((mipRecord.width + blockWidth - 1) / blockWidth) *
+                              ((mipRecord.height + blockHeight - 1) / blockHeight);
+            if (mipRecord.dataSize < blocks * blockBytes)
+            {
+                fail("mip data smaller than its blocks");
+            }
+        }
+    }
+}
+
+void AssetPack::prefetch(uint64_t offset, uint64_t size) const
+{
+    if (size == 0)
+    {
+        return;
+    }
+#ifdef _WIN32
+#if _WIN32_WINNT >= 0x0602
+    WIN32_MEMORY_RANGE_ENTRY range{const_cast<void *>(data(offset)), static_cast<SIZE_T>(size)};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+#else
+    // madvise exige um endereço alinhado à página
+    uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t begin = offset / pageSize * pageSize;
+    madvise(static_cast<char *>(mapping) + begin, static_cast<size_t>(offset + size - begin), MADV_WILLNEED);
+#endif
+}
+
+const AssetMeshRecord &AssetPack::mesh(uint32_t index) const
+{
+    return static_cast<const AssetMeshRecord *>(data(header().meshTableOffset))[index];
+}
+
+const AssetTextureRecord &AssetPack::texture(uint32_t index) const
+{
+    return static_cast<const AssetTextureRecord *>(data(header().textureTableOffset))[index];
+}
+
+const AssetMipRecord &AssetPack::mip(uint32_t textureIndex, uint32_t level) const
+{
+    return static_cast<const AssetMipRecord *>(data(header().mipTableOffset))[texture(textureIndex).firstMip + level];
+}
+
+uint64_t AssetPackWriter::appendPayload(const void *data, uint64_t size)
+{
+    uint64_t offset = alignUp(payload.size(), ASSET_PACK_ALIGNMENT);
+    payload.resize(static_cast<size_t>(offset + size));
+    std::memcpy(payload.data() + offset, data, static_cast<size_t>(size));
+    return offset;
+}
+
+void AssetPackWriter::addMesh(const AssetMeshRecord &mesh, const void *vertexData, const void *indexData)
+{
+    AssetMeshRecord record = mesh;
+    record.vertexDataSize = uint64_t(mesh.vertexCount) * mesh.vertexStride;
+    record.indexDataSize = uint64_t(mesh.indexCount) * (mesh.indexType == VK_INDEX_TYPE_UINT16 ? 2 : 4);
+    record.vertexDataOffset = appendPayload(vertexData, record.vertexDataSize);
+    record.indexDataOffset = appendPayload(indexData, record.indexDataSize);
+    meshes.push_back(record);
+}
+
+void AssetPackWriter::addTexture(VkFormat format, uint32_t width, uint32_t height,
+                                 const std::vector<std::vector<char>> &mipData)
+{
+    AssetTextureRecord record{};
+    record.format = static_cast<uint32_t>(format);
+    record.width = width;
+    record.height = height;
+    record.mipLevels = static_cast<uint32_t>(mipData.size());
+    record.firstMip = static_cast<uint32_t>(mips.size());
+    textures.push_back(record);
+
+    for (uint32_t level = 0; level < mipData.size(); level++)
+    {
+        AssetMipRecord mip{};
+        mip.width = std::max(width >> level, 1u);
+        mip.height = std::max(height >> level, 1u);
+        mip.dataSize = mipData[level].size();
+        mip.dataOffset = appendPayload(mipData[level].data(), mip.dataSize);
+        mips.push_back(mip);
+    }
+}
+
+void AssetPackWriter::write(const std::string &path) const
+{
+    AssetPackHeader header{};
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+    header.textureCount = static_cast<uint32_t>(textures.size());
+    header.meshTableOffset = alignUp(sizeof(header), ASSET_PACK_ALIGNMENT);
+    header.textureTableOffset = alignUp(header.meshTableOffset + meshes.size() * sizeof(AssetMeshRecord), ASSET_PACK_ALIGNMENT);
+    header.mipTableOffset = alignUp(header.textureTableOffset + textures.size() * sizeof(AssetTextureRecord), ASSET_PACK_ALIGNMENT);
+    uint64_t payloadOffset = alignUp(header.mipTableOffset + mips.size() * sizeof(AssetMipRecord), ASSET_PACK_ALIGNMENT);
+    header.fileSize = payloadOffset + payload.size();
+
+    // Os offsets dos dados passam a ser absolutos
+    std::vector<AssetMeshRecord> meshRecords = meshes;
+    for (auto &mesh : meshRecords)
+    {
+        mesh.vertexDataOffset += payloadOffset;
+        mesh.indexDataOffset += payloadOffset;
+    }
+    std::vector<AssetMipRecord> mipRecords = mips;
+    for (auto &mip : mipRecords)
+    {
+        mip.dataOffset += payloadOffset;
+    }
+
+    std::vector<char> file(static_cast<size_t>(header.fileSize), 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + header.meshTableOffset, meshRecords.data(), meshRecords.size() * sizeof(AssetMeshRecord));
+    std::memcpy(file.data() + header.textureTableOffset, textures.data(), textures.size() * sizeof(AssetTextureRecord));
+    std::memcpy(file.data() + header.mipTableOffset, mipRecords.data(), mipRecords.size() * sizeof(AssetMipRecord));
+    std::memcpy(file.data() + payloadOffset, payload.data(), payload.size());
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output.write(file.data(), static_cast<std::streamsize>(file.size()));
+    if (!output)
+    {
+        throw std::runtime_error("failed to write asset pack " + path + "!");
+    }
+}
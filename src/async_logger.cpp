@@ -0,0 +1,182 @@
+#include "async_logger.hpp"
+
+#include <functional>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// Intervalo entre resumos de repetições e descartes
+static const auto SUMMARY_INTERVAL = std::chrono::seconds(1);
+// Caracteres da mensagem mostrados no resumo de repetições
+static const size_t SUMMARY_LENGTH = 96;
+
+static const char *levelName(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::Info:
+        return "info";
+    case LogLevel::Warning:
+        return "warning";
+    case LogLevel::Error:
+        return "error";
+    }
+    return "?";
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stop();
+}
+
+void AsyncLogger::start(std::ostream &output, const Limits &limits)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running)
+    {
+        return;
+    }
+
+    this->output = &output;
+    this->limits = limits;
+    windowStart = Clock::now();
+    windowCount = 0;
+    running = true;
+    writer = std::thread(&AsyncLogger::writerLoop, this);
+}
+
+void AsyncLogger::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running)
+        {
+            return;
+        }
+        running = false;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+void AsyncLogger::log(LogLevel level, const char *category, const char *message)
+{
+    size_t key = std::hash<std::string_view>{}(message) ^ (std::hash<std::string_view>{}(category) << 1);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running)
+        {
+            return;
+        }
+
+        // Repetição: só conta, sem copiar a mensagem
+        auto it = seen.find(key);
+        if (it != seen.end())
+        {
+            it->second.repeats++;
+            return;
+        }
+
+        // Limite de mensagens novas por segundo
+        Clock::time_point now = Clock::now();
+        if (now - windowStart >= std::chrono::seconds(1))
+        {
+            windowStart = now;
+            windowCount = 0;
+        }
+        if (windowCount >= limits.messagesPerSecond || queue.size() >= limits.queueCapacity)
+        {
+            dropped++;
+            return;
+        }
+        windowCount++;
+
+        if (seen.size() >= limits.maxTrackedMessages)
+        {
+            // Esquece as mensagens antigas; no pior caso uma delas é registrada de novo
+            seen.clear();
+        }
+        seen[key].summary = std::string(message).substr(0, SUMMARY_LENGTH);
+
+        queue.push_back({level, category, message});
+    }
+    wake.notify_one();
+}
+
+void AsyncLogger::writerLoop()
+{
+    std::vector<Entry> batch;
+    std::unordered_map<size_t, Seen> summaries;
+    Clock::time_point lastSummary = Clock::now();
+
+    for (;;)
+    {
+        bool stopping;
+        uint64_t droppedCount = 0;
+        bool summaryDue;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait_for(lock, SUMMARY_INTERVAL, [&] { return !queue.empty() || !running; });
+
+            stopping = !running;
+            batch.assign(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.end()));
+            queue.clear();
+
+            // Os resumos são coletados com o mutex travado e escritos depois, fora dele
+            summaryDue = stopping || Clock::now() - lastSummary >= SUMMARY_INTERVAL;
+            if (summaryDue)
+            {
+                for (auto &[key, entry] : seen)
+                {
+                    if (entry.repeats > 0)
+                    {
+                        summaries[key] = entry;
+                        entry.repeats = 0;
+                    }
+                }
+                droppedCount = dropped;
+                dropped = 0;
+            }
+        }
+
+        for (const auto &entry : batch)
+        {
+            writeEntry(entry);
+        }
+        if (summaryDue)
+        {
+            writeSummaries(summaries, droppedCount);
+            lastSummary = Clock::now();
+        }
+        if (!batch.empty() || summaryDue)
+        {
+            output->flush();
+        }
+        batch.clear();
+
+        if (stopping)
+        {
+            return;
+        }
+    }
+}
+
+void AsyncLogger::writeEntry(const Entry &entry)
+{
+    *output << entry.category << " " << levelName(entry.level) << ": " << entry.message << '\n';
+}
+
+void AsyncLogger::writeSummaries(std::unordered_map<size_t, Seen> &summaries, uint64_t droppedCount)
+{
+    for (const auto &[key, entry] : summaries)
+    {
+        *output << "  (repeated " << entry.repeats << " more times) " << entry.summary << '\n';
+    }
+    summaries.clear();
+
+    if (droppedCount > 0)
+    {
+        *output << "  (" << droppedCount << " messages dropped by the rate limit)\n";
+    }
+}
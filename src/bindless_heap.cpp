@@ -0,0 +1,216 @@
+#include "bindless_heap.hpp"
+
+#include "host_allocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+uint32_t BindlessHeap::Slots::allocate()
+{
+    if (!freed.empty())
+    {
+        uint32_t index = freed.back();
+        freed.pop_back();
+        return index;
+    }
+    if (next == capacity)
+    {
+        throw std::runtime_error("bindless heap is full!");
+    }
+    return next++;
+}
+
+void BindlessHeap::Slots::release(uint32_t index)
+{
+    freed.push_back(index);
+}
+
+void BindlessHeap::init(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t maxStorageBuffers, uint32_t maxTextures)
+{
+    this->device = device;
+
+    // Limites dos descritores UPDATE_AFTER_BIND; uma textura combinada conta como imagem amostrada e como sampler
+    VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+    vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &vulkan12Properties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+    storageBuffers = Slots{};
+    storageBuffers.capacity = std::min({maxStorageBuffers,
+                                        vulkan12Properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                        vulkan12Properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers});
+    textures = Slots{};
+    textures.capacity = std::min({maxTextures,
+                                  vulkan12Properties.maxDescriptorSetUpdateAfterBindSampledImages,
+                                  vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                  vulkan12Properties.maxDescriptorSetUpdateAfterBindSamplers,
+                                  vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers});
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = STORAGE_BUFFER_BINDING;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[0].descriptorCount = storageBuffers.capacity;
+    bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+    bindings[1].binding = TEXTURE_BINDING;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorCount = textures.capacity;
+    bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+
+    // Só o último binding pode ter tamanho variável; o conjunto é alocado com a capacidade inteira
+    const VkDescriptorBindingFlags commonFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                 VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                                 VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    std::array<VkDescriptorBindingFlags, 2> bindingFlags = {
+        commonFlags,
+        commonFlags | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT,
+    };
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+    flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+    flagsInfo.pBindingFlags = bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &flagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, hostAllocationCallbacks(), &descriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create bindless descriptor set layout!");
+    }
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[0].descriptorCount = storageBuffers.capacity;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[1].descriptorCount = textures.capacity;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+
+    if (vkCreateDescriptorPool(device, &poolInfo, hostAllocationCallbacks(), &descriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create bindless descriptor pool!");
+    }
+
+    VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{};
+    variableCountInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+    variableCountInfo.descriptorSetCount = 1;
+    variableCountInfo.pDescriptorCounts = &textures.capacity;
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.pNext = &variableCountInfo;
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &descriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate bindless descriptor set!");
+    }
+}
+
+void BindlessHeap::destroy()
+{
+    // Destruir o pool libera o conjunto
+    if (descriptorPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(device, descriptorPool, hostAllocationCallbacks());
+        descriptorPool = VK_NULL_HANDLE;
+        descriptorSet = VK_NULL_HANDLE;
+    }
+    if (descriptorSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayout, hostAllocationCallbacks());
+        descriptorSetLayout = VK_NULL_HANDLE;
+    }
+    pendingBuffers.clear();
+    pendingTextures.clear();
+}
+
+uint32_t BindlessHeap::addStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    uint32_t index = storageBuffers.allocate();
+    pendingBuffers.push_back({index, {buffer, offset, range}});
+    return index;
+}
+
+uint32_t BindlessHeap::addTexture(VkImageView imageView, VkSampler sampler, VkImageLayout layout)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    uint32_t index = textures.allocate();
+    pendingTextures.push_back({index, {sampler, imageView, layout}});
+    return index;
+}
+
+void BindlessHeap::removeStorageBuffer(uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    // O descritor antigo continua no conjunto até ser sobrescrito; com PARTIALLY_BOUND ele só não pode ser lido
+    storageBuffers.release(index);
+}
+
+void BindlessHeap::removeTexture(uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    textures.release(index);
+}
+
+void BindlessHeap::flushUpdates()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pendingBuffers.empty() && pendingTextures.empty())
+    {
+        return;
+    }
+
+    // Os ponteiros para as infos ficam válidos: os vetores pendentes não mudam até o fim da função
+    writes.clear();
+    for (const auto &pending : pendingBuffers)
+    {
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = descriptorSet;
+        write.dstBinding = STORAGE_BUFFER_BINDING;
+        write.dstArrayElement = pending.index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &pending.info;
+        writes.push_back(write);
+    }
+    for (const auto &pending : pendingTextures)
+    {
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = descriptorSet;
+        write.dstBinding = TEXTURE_BINDING;
+        write.dstArrayElement = pending.index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &pending.info;
+        writes.push_back(write);
+    }
+
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    pendingBuffers.clear();
+    pendingTextures.clear();
+}
+
+void BindlessHeap::bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout layout) const
+{
+    vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, 0, 1, &descriptorSet, 0, nullptr);
+}
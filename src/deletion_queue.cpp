@@ -0,0 +1,29 @@
+#include "deletion_queue.hpp"
+
+#include <algorithm>
+
+void DeletionQueue::defer(QueueTimeline &timeline, uint64_t value, std::function<void()> destroy)
+{
+    entries.push_back({&timeline, value, std::move(destroy)});
+}
+
+void DeletionQueue::collect()
+{
+    // As entradas são destruídas na ordem em que foram adiadas
+    auto pending = std::stable_partition(entries.begin(), entries.end(),
+                                         [](const Entry &entry) { return !entry.timeline->isComplete(entry.value); });
+    for (auto it = pending; it != entries.end(); ++it)
+    {
+        it->destroy();
+    }
+    entries.erase(pending, entries.end());
+}
+
+void DeletionQueue::flush()
+{
+    for (auto &entry : entries)
+    {
+        entry.destroy();
+    }
+    entries.clear();
+}
@@ -0,0 +1,189 @@
+#include "device_capabilities.hpp"
+
+#include "build_config.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+DeviceCapabilities DeviceCapabilities::query(VkPhysicalDevice physicalDevice, uint32_t instanceApiVersion)
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    DeviceCapabilities capabilities;
+    // Só é permitido usar recursos de uma versão que a instância e o dispositivo suportem
+    capabilities.apiVersion = std::min(instanceApiVersion, properties.apiVersion);
+
+    VkPhysicalDeviceVulkan11Features vulkan11{};
+    vulkan11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+    VkPhysicalDeviceVulkan12Features vulkan12{};
+    vulkan12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceVulkan13Features vulkan13{};
+    vulkan13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+
+    // As estruturas Vulkan11/12Features foram introduzidas no 1.2; antes disso ficam fora da cadeia
+    if (capabilities.apiVersion >= VK_API_VERSION_1_2)
+    {
+        features2.pNext = &vulkan11;
+        vulkan11.pNext = &vulkan12;
+        if (capabilities.apiVersion >= VK_API_VERSION_1_3)
+        {
+            vulkan12.pNext = &vulkan13;
+        }
+    }
+
+    if (capabilities.apiVersion >= VK_API_VERSION_1_1)
+    {
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+    }
+    else
+    {
+        vkGetPhysicalDeviceFeatures(physicalDevice, &features2.features);
+    }
+
+    capabilities.multiDrawIndirect = features2.features.multiDrawIndirect;
+    capabilities.drawIndirectFirstInstance = features2.features.drawIndirectFirstInstance;
+    capabilities.samplerAnisotropy = features2.features.samplerAnisotropy;
+    capabilities.textureCompressionBC = features2.features.textureCompressionBC;
+    capabilities.textureCompressionASTC_LDR = features2.features.textureCompressionASTC_LDR;
+    capabilities.shaderStorageImageWriteWithoutFormat = features2.features.shaderStorageImageWriteWithoutFormat;
+
+    capabilities.shaderDrawParameters = vulkan11.shaderDrawParameters;
+
+    capabilities.timelineSemaphore = vulkan12.timelineSemaphore;
+    capabilities.bufferDeviceAddress = vulkan12.bufferDeviceAddress;
+    capabilities.hostQueryReset = vulkan12.hostQueryReset;
+    capabilities.drawIndirectCount = vulkan12.drawIndirectCount;
+    capabilities.descriptorIndexing = vulkan12.descriptorIndexing;
+    capabilities.runtimeDescriptorArray = vulkan12.runtimeDescriptorArray;
+    capabilities.descriptorBindingPartiallyBound = vulkan12.descriptorBindingPartiallyBound;
+    capabilities.descriptorBindingVariableDescriptorCount = vulkan12.descriptorBindingVariableDescriptorCount;
+    capabilities.descriptorBindingSampledImageUpdateAfterBind = vulkan12.descriptorBindingSampledImageUpdateAfterBind;
+    capabilities.descriptorBindingStorageBufferUpdateAfterBind = vulkan12.descriptorBindingStorageBufferUpdateAfterBind;
+    capabilities.descriptorBindingUpdateUnusedWhilePending = vulkan12.descriptorBindingUpdateUnusedWhilePending;
+    capabilities.shaderSampledImageArrayNonUniformIndexing = vulkan12.shaderSampledImageArrayNonUniformIndexing;
+
+    capabilities.dynamicRendering = vulkan13.dynamicRendering;
+    capabilities.synchronization2 = vulkan13.synchronization2;
+
+    return capabilities;
+}
+
+bool DeviceCapabilities::supportsBindless() const
+{
+    // Arrays sem entradas obrigatórias, atualizados com o conjunto vinculado e indexados de forma não uniforme
+    return descriptorIndexing && runtimeDescriptorArray && descriptorBindingPartiallyBound &&
+           descriptorBindingVariableDescriptorCount && descriptorBindingUpdateUnusedWhilePending &&
+           descriptorBindingSampledImageUpdateAfterBind && descriptorBindingStorageBufferUpdateAfterBind &&
+           shaderSampledImageArrayNonUniformIndexing;
+}
+
+std::string DeviceCapabilities::describe() const
+{
+    std::ostringstream out;
+    out << "Vulkan " << VK_API_VERSION_MAJOR(apiVersion) << "." << VK_API_VERSION_MINOR(apiVersion);
+
+    auto feature = [&](bool supported, const char *name)
+    {
+        if (supported)
+        {
+            out << " " << name;
+        }
+    };
+    feature(dynamicRendering, "dynamicRendering");
+    feature(synchronization2, "synchronization2");
+    feature(timelineSemaphore, "timelineSemaphore");
+    feature(bufferDeviceAddress, "bufferDeviceAddress");
+    feature(descriptorIndexing, "descriptorIndexing");
+    feature(drawIndirectCount, "drawIndirectCount");
+    feature(hostQueryReset, "hostQueryReset");
+    feature(shaderDrawParameters, "shaderDrawParameters");
+    feature(multiDrawIndirect, "multiDrawIndirect");
+    feature(textureCompressionBC, "BC");
+    feature(textureCompressionASTC_LDR, "ASTC");
+    feature(shaderStorageImageWriteWithoutFormat, "storageWriteWithoutFormat");
+    return out.str();
+}
+
+DeviceFeatureChain::DeviceFeatureChain(const DeviceCapabilities &capabilities)
+{
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.features.multiDrawIndirect = capabilities.multiDrawIndirect;
+    features2.features.drawIndirectFirstInstance = capabilities.drawIndirectFirstInstance;
+    features2.features.samplerAnisotropy = capabilities.samplerAnisotropy;
+    features2.features.textureCompressionBC = capabilities.textureCompressionBC;
+    features2.features.textureCompressionASTC_LDR = capabilities.textureCompressionASTC_LDR;
+    features2.features.shaderStorageImageWriteWithoutFormat = capabilities.shaderStorageImageWriteWithoutFormat;
+    tail = &features2.pNext;
+
+    if (capabilities.apiVersion >= VK_API_VERSION_1_2)
+    {
+        vulkan11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+        vulkan11.shaderDrawParameters = capabilities.shaderDrawParameters;
+        append(&vulkan11);
+
+        vulkan12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        vulkan12.timelineSemaphore = capabilities.timelineSemaphore;
+        // Só negociado: nenhum buffer é criado com VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT por enquanto
+        vulkan12.bufferDeviceAddress = capabilities.bufferDeviceAddress;
+        vulkan12.hostQueryReset = capabilities.hostQueryReset;
+        vulkan12.drawIndirectCount = capabilities.drawIndirectCount;
+        vulkan12.descriptorIndexing = capabilities.descriptorIndexing;
+        vulkan12.runtimeDescriptorArray = capabilities.runtimeDescriptorArray;
+        vulkan12.descriptorBindingPartiallyBound = capabilities.descriptorBindingPartiallyBound;
+        vulkan12.descriptorBindingVariableDescriptorCount = capabilities.descriptorBindingVariableDescriptorCount;
+        vulkan12.descriptorBindingSampledImageUpdateAfterBind = capabilities.descriptorBindingSampledImageUpdateAfterBind;
+        vulkan12.descriptorBindingStorageBufferUpdateAfterBind = capabilities.descriptorBindingStorageBufferUpdateAfterBind;
+        vulkan12.descriptorBindingUpdateUnusedWhilePending = capabilities.descriptorBindingUpdateUnusedWhilePending;
+        vulkan12.shaderSampledImageArrayNonUniformIndexing = capabilities.shaderSampledImageArrayNonUniformIndexing;
+        append(&vulkan12);
+    }
+
+    if (capabilities.apiVersion >= VK_API_VERSION_1_3)
+    {
+        vulkan13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        vulkan13.dynamicRendering = capabilities.dynamicRendering;
+        vulkan13.synchronization2 = capabilities.synchronization2;
+        append(&vulkan13);
+    }
+}
+
+void DeviceFeatureChain::append(void *structure)
+{
+    *tail = structure;
+    // Avança até o fim da cadeia acrescentada, que pode ter mais de uma estrutura
+    auto *last = static_cast<VkBaseOutStructure *>(structure);
+    while (last->pNext != nullptr)
+    {
+        last = last->pNext;
+    }
+    tail = reinterpret_cast<void **>(&last->pNext);
+}
+
+RendererPaths RendererPaths::select(const DeviceCapabilities &capabilities)
+{
+    RendererPaths paths;
+    paths.dynamicRendering = BuildConfig::dynamicRendering && capabilities.dynamicRendering;
+    paths.synchronization2 = capabilities.synchronization2;
+    // A GPU escreve os comandos e a contagem; o shader identifica o desenho por gl_DrawID
+    paths.gpuDriven = BuildConfig::gpuDrivenDraws && capabilities.drawIndirectCount && capabilities.multiDrawIndirect &&
+                      capabilities.drawIndirectFirstInstance && capabilities.shaderDrawParameters;
+    return paths;
+}
+
+bool RendererPaths::coversBuild() const
+{
+    return (dynamicRendering || BuildConfig::renderPassObjects) && (gpuDriven || BuildConfig::cpuDraws);
+}
+
+std::string RendererPaths::describe() const
+{
+    std::ostringstream out;
+    out << (dynamicRendering ? "dynamic rendering" : "render pass objects");
+    out << ", " << (synchronization2 ? "synchronization2" : "legacy barriers");
+    out << ", " << (gpuDriven ? "GPU-driven draws" : "CPU draws");
+    return out.str();
+}
@@ -0,0 +1,79 @@
+#include "dynamic_resolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+void DynamicResolution::init(double targetMilliseconds, float minScale, float maxScale)
+{
+    this->targetMilliseconds = targetMilliseconds;
+    this->minScale = minScale;
+    this->maxScale = maxScale;
+    currentScale = maxScale;
+    lowestScale = maxScale;
+    smoothedMilliseconds = 0.0;
+    smoothedSceneMilliseconds = 0.0;
+    hasSample = false;
+    samples = 0;
+    changes = 0;
+    scaleSum = 0.0;
+}
+
+void DynamicResolution::addGpuTime(double frameMilliseconds, double sceneMilliseconds)
+{
+    if (frameMilliseconds <= 0.0 || sceneMilliseconds <= 0.0 || targetMilliseconds <= 0.0)
+    {
+        return;
+    }
+    sceneMilliseconds = std::min(sceneMilliseconds, frameMilliseconds);
+    smoothedMilliseconds =
+        hasSample ? smoothedMilliseconds + SMOOTHING * (frameMilliseconds - smoothedMilliseconds) : frameMilliseconds;
+    smoothedSceneMilliseconds = hasSample ? smoothedSceneMilliseconds + SMOOTHING * (sceneMilliseconds - smoothedSceneMilliseconds)
+                                          : sceneMilliseconds;
+    hasSample = true;
+
+    // Escala que levaria o tempo suavizado à meta, com só o custo da cena proporcional à área; se o custo fixo sozinho
+    // já passa da meta, nenhuma escala basta e ela vai para o mínimo
+    double fixedMilliseconds = std::max(smoothedMilliseconds - smoothedSceneMilliseconds, 0.0);
+    double sceneBudget = targetMilliseconds * HEADROOM - fixedMilliseconds;
+    float desired = sceneBudget > 0.0
+                        ? currentScale * static_cast<float>(std::sqrt(sceneBudget / smoothedSceneMilliseconds))
+                        : minScale;
+    desired = std::clamp(desired, minScale, maxScale);
+    float delta = std::clamp(desired - currentScale, -MAX_STEP, MAX_STEP);
+    // A zona morta não impede chegar aos limites
+    if (std::abs(delta) >= DEAD_ZONE || desired == minScale || desired == maxScale)
+    {
+        float next = std::clamp(currentScale + delta, minScale, maxScale);
+        if (next != currentScale)
+        {
+            currentScale = next;
+            changes++;
+        }
+    }
+
+    samples++;
+    scaleSum += currentScale;
+    lowestScale = std::min(lowestScale, currentScale);
+}
+
+VkExtent2D DynamicResolution::scaledExtent(VkExtent2D full) const
+{
+    auto scaleSide = [this](uint32_t side)
+    {
+        uint32_t scaled = static_cast<uint32_t>(std::lround(side * currentScale));
+        scaled = (scaled + EXTENT_ALIGNMENT - 1) / EXTENT_ALIGNMENT * EXTENT_ALIGNMENT;
+        return std::clamp(scaled, 1u, side);
+    };
+    return {scaleSide(full.width), scaleSide(full.height)};
+}
+
+std::string DynamicResolution::describe() const
+{
+    std::ostringstream out;
+    out << "dynamic resolution: target " << std::fixed << std::setprecision(2) << targetMilliseconds << " ms, scale "
+        << lowestScale << " min / " << (samples != 0 ? scaleSum / samples : currentScale) << " avg / " << currentScale
+        << " last, " << changes << " changes over " << samples << " frames";
+    return out.str();
+}
@@ -0,0 +1,351 @@
+#include "frame_profiler.hpp"
+
+#include "host_allocator.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+// Limite de eventos guardados para o trace (~40 MB de JSON); além disso os eventos são descartados
+static const size_t MAX_TRACE_EVENTS = 1000000;
+// Largura de cada faixa do histograma de tempos de quadro
+static const double HISTOGRAM_BUCKET_MS = 4.0;
+
+void RollingTimings::add(double milliseconds)
+{
+    samples[next] = milliseconds;
+    next = (next + 1) % CAPACITY;
+    size = std::min(size + 1, CAPACITY);
+}
+
+double RollingTimings::percentile(double p) const
+{
+    if (size == 0)
+    {
+        return 0.0;
+    }
+
+    std::array<double, CAPACITY> sorted;
+    std::copy(samples.begin(), samples.begin() + size, sorted.begin());
+    size_t rank = std::min(size - 1, static_cast<size_t>(p / 100.0 * size));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + size);
+    return sorted[rank];
+}
+
+void FrameProfiler::init(VkDevice device, const VkPhysicalDeviceProperties &properties, uint32_t timestampValidBits,
+                         uint32_t frameCount, const std::string &tracePath)
+{
+    this->device = device;
+    this->tracePath = tracePath;
+    tracing = !tracePath.empty();
+    epoch = Clock::now();
+
+    // Sem timestampComputeAndGraphics ou sem bits válidos na fila de gráficos não há medição de GPU
+    gpuEnabled = timestampValidBits > 0 && properties.limits.timestampComputeAndGraphics;
+    timestampPeriod = properties.limits.timestampPeriod;
+    timestampMask = timestampValidBits >= 64 ? ~0ull : (1ull << timestampValidBits) - 1;
+
+    gpuFrames.resize(frameCount);
+    if (!gpuEnabled)
+    {
+        std::cerr << "profiler: GPU timestamps are not supported on the graphics queue" << std::endl;
+        return;
+    }
+
+    for (auto &frame : gpuFrames)
+    {
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = MAX_GPU_SCOPES * 2;
+
+        if (vkCreateQueryPool(device, &poolInfo, hostAllocationCallbacks(), &frame.queryPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create timestamp query pool!");
+        }
+    }
+}
+
+void FrameProfiler::destroy()
+{
+    if (tracing)
+    {
+        writeTrace();
+    }
+
+    for (auto &frame : gpuFrames)
+    {
+        if (frame.queryPool != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(device, frame.queryPool, hostAllocationCallbacks());
+        }
+    }
+    gpuFrames.clear();
+}
+
+void FrameProfiler::beginFrame(uint32_t frameIndex)
+{
+    lastGpuFrameTime = 0.0;
+    lastGpuScopes.clear();
+    GpuFrame &frame = gpuFrames[frameIndex];
+    if (!gpuEnabled || !frame.pending)
+    {
+        return;
+    }
+    frame.pending = false;
+
+    if (frame.queryCount == 0 || !frame.openScopes.empty())
+    {
+        return;
+    }
+
+    // A cerca do quadro já foi esperada, então os resultados estão disponíveis sem VK_QUERY_RESULT_WAIT_BIT
+    std::vector<uint64_t> ticks(frame.queryCount);
+    if (vkGetQueryPoolResults(device, frame.queryPool, 0, frame.queryCount, ticks.size() * sizeof(uint64_t), ticks.data(),
+                              sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+    {
+        return;
+    }
+
+    auto toMicroseconds = [&](uint64_t value)
+    {
+        return static_cast<double>(value & timestampMask) * timestampPeriod / 1000.0;
+    };
+
+    double frameBegin = toMicroseconds(ticks[frame.scopes.front().beginQuery]);
+    double frameEnd = frameBegin;
+    for (const auto &scope : frame.scopes)
+    {
+        frameBegin = std::min(frameBegin, toMicroseconds(ticks[scope.beginQuery]));
+        frameEnd = std::max(frameEnd, toMicroseconds(ticks[scope.endQuery]));
+    }
+
+    lastGpuFrameTime = (frameEnd - frameBegin) / 1000.0;
+    std::lock_guard<std::mutex> lock(mutex);
+    gpuFrameTimes.add(lastGpuFrameTime);
+    for (const auto &scope : frame.scopes)
+    {
+        double begin = toMicroseconds(ticks[scope.beginQuery]);
+        double end = toMicroseconds(ticks[scope.endQuery]);
+        scopeTimes[std::string("gpu ") + scope.name].add((end - begin) / 1000.0);
+        lastGpuScopes.emplace_back(scope.name, (end - begin) / 1000.0);
+    }
+
+    if (tracing)
+    {
+        double recordTime = std::chrono::duration<double, std::micro>(frame.recordTime - epoch).count();
+        if (!hasGpuOffset || frameBegin + gpuToCpuOffsetMicroseconds < recordTime)
+        {
+            gpuToCpuOffsetMicroseconds = recordTime - frameBegin;
+            hasGpuOffset = true;
+        }
+
+        for (const auto &scope : frame.scopes)
+        {
+            if (traceEvents.size() >= MAX_TRACE_EVENTS)
+            {
+                break;
+            }
+            double begin = toMicroseconds(ticks[scope.beginQuery]);
+            double end = toMicroseconds(ticks[scope.endQuery]);
+            traceEvents.push_back({scope.name, 0, begin + gpuToCpuOffsetMicroseconds, end - begin});
+        }
+    }
+}
+
+double FrameProfiler::lastGpuScopeMilliseconds(const char *name) const
+{
+    double milliseconds = 0.0;
+    for (const auto &scope : lastGpuScopes)
+    {
+        if (std::strcmp(scope.first, name) == 0)
+        {
+            milliseconds += scope.second;
+        }
+    }
+    return milliseconds;
+}
+
+void FrameProfiler::endFrame()
+{
+    Clock::time_point now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (hasLastFrame)
+    {
+        double milliseconds = std::chrono::duration<double, std::milli>(now - lastFrameEnd).count();
+        frameTimes.add(milliseconds);
+        size_t bucket = std::min(histogram.size() - 1, static_cast<size_t>(milliseconds / HISTOGRAM_BUCKET_MS));
+        histogram[bucket]++;
+    }
+    lastFrameEnd = now;
+    hasLastFrame = true;
+}
+
+void FrameProfiler::resetGpuScopes(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+{
+    GpuFrame &frame = gpuFrames[frameIndex];
+    frame.scopes.clear();
+    frame.openScopes.clear();
+    frame.queryCount = 0;
+    frame.recordTime = Clock::now();
+    frame.pending = false;
+
+    if (gpuEnabled)
+    {
+        vkCmdResetQueryPool(commandBuffer, frame.queryPool, 0, MAX_GPU_SCOPES * 2);
+    }
+}
+
+void FrameProfiler::beginGpuScope(VkCommandBuffer commandBuffer, uint32_t frameIndex, const char *name)
+{
+    GpuFrame &frame = gpuFrames[frameIndex];
+    if (!gpuEnabled || frame.scopes.size() >= MAX_GPU_SCOPES)
+    {
+        // Sem espaço: o escopo é ignorado, mas a pilha continua balanceada
+        frame.openScopes.push_back(UINT32_MAX);
+        return;
+    }
+
+    GpuScope scope{};
+    scope.name = name;
+    scope.beginQuery = frame.queryCount++;
+    scope.endQuery = frame.queryCount++;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, scope.beginQuery);
+
+    frame.openScopes.push_back(static_cast<uint32_t>(frame.scopes.size()));
+    frame.scopes.push_back(scope);
+}
+
+void FrameProfiler::endGpuScope(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+{
+    GpuFrame &frame = gpuFrames[frameIndex];
+    if (frame.openScopes.empty())
+    {
+        return;
+    }
+
+    uint32_t index = frame.openScopes.back();
+    frame.openScopes.pop_back();
+    if (index != UINT32_MAX)
+    {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.queryPool, frame.scopes[index].endQuery);
+    }
+
+    frame.pending = frame.openScopes.empty() && !frame.scopes.empty();
+}
+
+FrameProfiler::CpuScope::CpuScope(FrameProfiler &profiler, const char *name)
+    : profiler(profiler), name(name), start(Clock::now())
+{
+}
+
+FrameProfiler::CpuScope::~CpuScope()
+{
+    profiler.addCpuScope(name, start, Clock::now());
+}
+
+void FrameProfiler::addCpuScope(const char *name, Clock::time_point start, Clock::time_point end)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    scopeTimes[name].add(std::chrono::duration<double, std::milli>(end - start).count());
+
+    if (tracing && traceEvents.size() < MAX_TRACE_EVENTS)
+    {
+        traceEvents.push_back({name, traceThreadId(),
+                               std::chrono::duration<double, std::micro>(start - epoch).count(),
+                               std::chrono::duration<double, std::micro>(end - start).count()});
+    }
+}
+
+uint32_t FrameProfiler::traceThreadId()
+{
+    // Chamado com mutex travado; a GPU usa o identificador 0
+    auto [it, inserted] = threadIds.try_emplace(std::this_thread::get_id(), static_cast<uint32_t>(threadIds.size() + 1));
+    return it->second;
+}
+
+std::string FrameProfiler::summary() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2)
+         << "cpu " << frameTimes.percentile(50) << "/" << frameTimes.percentile(95) << "/" << frameTimes.percentile(99) << " ms";
+    if (gpuEnabled)
+    {
+        text << " | gpu " << gpuFrameTimes.percentile(50) << "/" << gpuFrameTimes.percentile(95) << "/" << gpuFrameTimes.percentile(99) << " ms";
+    }
+    text << " (p50/p95/p99)";
+    return text.str();
+}
+
+void FrameProfiler::printReport() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "profiler: last " << frameTimes.count() << " frames, p50/p95/p99 in ms\n";
+    std::cout << "  frame (cpu)  " << frameTimes.percentile(50) << " / " << frameTimes.percentile(95) << " / " << frameTimes.percentile(99) << "\n";
+    if (gpuEnabled)
+    {
+        std::cout << "  frame (gpu)  " << gpuFrameTimes.percentile(50) << " / " << gpuFrameTimes.percentile(95) << " / " << gpuFrameTimes.percentile(99) << "\n";
+    }
+    for (const auto &[name, timings] : scopeTimes)
+    {
+        std::cout << "  " << name << "  " << timings.percentile(50) << " / " << timings.percentile(95) << " / " << timings.percentile(99) << "\n";
+    }
+
+    std::cout << "profiler: frame time histogram (all frames)\n";
+    for (size_t i = 0; i < histogram.size(); i++)
+    {
+        double low = i * HISTOGRAM_BUCKET_MS;
+        std::cout << "  " << std::setprecision(0) << std::setw(3) << low;
+        if (i + 1 < histogram.size())
+        {
+            std::cout << "-" << std::setw(2) << low + HISTOGRAM_BUCKET_MS << " ms ";
+        }
+        else
+        {
+            std::cout << "+    ms ";
+        }
+        std::cout << histogram[i] << "\n";
+    }
+    std::cout << std::defaultfloat << std::flush;
+}
+
+void FrameProfiler::writeTrace() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::ofstream file(tracePath, std::ios::trunc);
+    if (!file)
+    {
+        std::cerr << "profiler: failed to write trace " << tracePath << std::endl;
+        return;
+    }
+
+    // Formato "Trace Event": eventos completos ("X") com início e duração em microssegundos
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+    for (const auto &[id, tid] : threadIds)
+    {
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid
+             << ",\"args\":{\"name\":\"" << (tid == 1 ? "main" : "worker " + std::to_string(tid)) << "\"}}";
+    }
+
+    file << std::fixed << std::setprecision(3);
+    for (const auto &event : traceEvents)
+    {
+        file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+             << ",\"ts\":" << event.startMicroseconds << ",\"dur\":" << event.durationMicroseconds << "}";
+    }
+    file << "\n]}\n";
+
+    std::cout << "profiler: wrote " << traceEvents.size() << " events to " << tracePath << std::endl;
+}
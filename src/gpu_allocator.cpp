@@ -0,0 +1,616 @@
+#include "gpu_allocator.hpp"
+
+#include "host_allocator.hpp"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+// Fração do heap local ao dispositivo usada como orçamento quando o driver não o informa (VK_EXT_memory_budget)
+static const double DEFAULT_BUDGET_FRACTION = 0.8;
+
+// Bloco de VkDeviceMemory dividido em regiões livres e ocupadas
+struct GpuMemoryBlock
+{
+    struct UsedRange
+    {
+        VkDeviceSize size;
+        VkDeviceSize alignment;
+        void *userData;
+    };
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+    void *mapped = nullptr;
+    uint32_t memoryType = 0;
+    ResourceKind kind = ResourceKind::Linear;
+    bool dedicated = false;
+
+    std::map<VkDeviceSize, VkDeviceSize> freeRanges; // offset -> tamanho
+    std::map<VkDeviceSize, UsedRange> usedRanges;    // offset -> região ocupada
+    VkDeviceSize usedBytes = 0;
+
+    // Sub-aloca uma região usando a menor região livre que comporte o pedido (best fit)
+    bool allocate(VkDeviceSize requestSize, VkDeviceSize alignment, void *userData, VkDeviceSize &offset)
+    {
+        auto best = freeRanges.end();
+        VkDeviceSize bestAligned = 0;
+        for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it)
+        {
+            VkDeviceSize aligned = (it->first + alignment - 1) / alignment * alignment;
+            VkDeviceSize padding = aligned - it->first;
+            if (padding + requestSize <= it->second && (best == freeRanges.end() || it->second < best->second))
+            {
+                best = it;
+                bestAligned = aligned;
+            }
+        }
+        if (best == freeRanges.end())
+        {
+            return false;
+        }
+
+        VkDeviceSize rangeOffset = best->first;
+        VkDeviceSize rangeSize = best->second;
+        freeRanges.erase(best);
+
+        // O espaço de alinhamento antes e a sobra depois da região continuam livres
+        if (bestAligned > rangeOffset)
+        {
+            freeRanges[rangeOffset] = bestAligned - rangeOffset;
+        }
+        VkDeviceSize end = bestAligned + requestSize;
+        if (end < rangeOffset + rangeSize)
+        {
+            freeRanges[end] = rangeOffset + rangeSize - end;
+        }
+
+        usedRanges[bestAligned] = {requestSize, alignment, userData};
+        usedBytes += requestSize;
+        offset = bestAligned;
+        return true;
+    }
+
+    // Devolve uma região, juntando-a às regiões livres vizinhas
+    void release(VkDeviceSize offset)
+    {
+        auto used = usedRanges.find(offset);
+        if (used == usedRanges.end())
+        {
+            throw std::runtime_error("GPU allocation freed twice or not owned by this block!");
+        }
+        VkDeviceSize rangeSize = used->second.size;
+        usedBytes -= rangeSize;
+        usedRanges.erase(used);
+
+        auto inserted = freeRanges.emplace(offset, rangeSize).first;
+
+        auto next = std::next(inserted);
+        if (next != freeRanges.end() && inserted->first + inserted->second == next->first)
+        {
+            inserted->second += next->second;
+            freeRanges.erase(next);
+        }
+
+        if (inserted != freeRanges.begin())
+        {
+            auto prev = std::prev(inserted);
+            if (prev->first + prev->second == inserted->first)
+            {
+                prev->second += inserted->second;
+                freeRanges.erase(inserted);
+            }
+        }
+    }
+};
+
+GpuAllocator::GpuAllocator() = default;
+GpuAllocator::~GpuAllocator() = default;
+
+void GpuAllocator::init(VkPhysicalDevice physicalDevice, VkDevice device, bool memoryBudgetEnabled)
+{
+    this->physicalDevice = physicalDevice;
+    this->device = device;
+    this->memoryBudgetEnabled = memoryBudgetEnabled;
+
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+    deviceLocalHeap = 0;
+    for (uint32_t i = 0; i < memProperties.memoryHeapCount; i++)
+    {
+        const VkMemoryHeap &heap = memProperties.memoryHeaps[i];
+        if ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) &&
+            (!(memProperties.memoryHeaps[deviceLocalHeap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ||
+             heap.size > memProperties.memoryHeaps[deviceLocalHeap].size))
+        {
+            deviceLocalHeap = i;
+        }
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    maxMemoryAllocationCount = properties.limits.maxMemoryAllocationCount;
+}
+
+void GpuAllocator::destroy()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto &pool : pools)
+    {
+        for (auto &block : pool)
+        {
+            freeBlock(block.get());
+        }
+        pool.clear();
+    }
+    for (auto &block : dedicatedBlocks)
+    {
+        freeBlock(block.get());
+    }
+    dedicatedBlocks.clear();
+}
+
+uint32_t GpuAllocator::findMemoryType(uint32_t typeBits, MemoryUsage usage) const
+{
+    VkMemoryPropertyFlags required = 0;
+    VkMemoryPropertyFlags preferred = 0;
+    VkMemoryPropertyFlags avoided = 0;
+    switch (usage)
+    {
+    case MemoryUsage::GpuOnly:
+        preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        avoided = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        break;
+    case MemoryUsage::CpuToGpu:
+        // Memória combinada para escrita (sem cache) é a mais rápida para a CPU escrever e a GPU ler uma vez;
+        // evita a memória local visível pela CPU (BAR), que costuma ser pequena
+        required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        avoided = VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        break;
+    case MemoryUsage::GpuToCpu:
+        required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        break;
+    }
+
+    // Os tipos de memória já vêm ordenados por preferência do driver; o primeiro com a melhor pontuação vence
+    int bestScore = -1;
+    uint32_t bestType = 0;
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+    {
+        VkMemoryPropertyFlags flags = memProperties.memoryTypes[i].propertyFlags;
+        if (!(typeBits & (1u << i)) || (flags & required) != required)
+        {
+            continue;
+        }
+
+        int score = ((flags & preferred) == preferred ? 2 : 0) + ((flags & avoided) == 0 ? 1 : 0);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestType = i;
+        }
+    }
+
+    if (bestScore < 0)
+    {
+        throw std::runtime_error("failed to find suitable memory type!");
+    }
+    return bestType;
+}
+
+VkDeviceSize GpuAllocator::preferredBlockSize(uint32_t memoryType) const
+{
+    const VkDeviceSize MiB = 1024 * 1024;
+    VkDeviceSize heapSize = memProperties.memoryHeaps[memProperties.memoryTypes[memoryType].heapIndex].size;
+
+    // Heaps pequenos (por exemplo a janela BAR de 256 MiB) usam blocos proporcionalmente menores
+    if (heapSize >= 1024 * MiB)
+    {
+        return 64 * MiB;
+    }
+    return std::max<VkDeviceSize>((heapSize / 8 + MiB - 1) / MiB * MiB, MiB);
+}
+
+GpuMemoryBlock *GpuAllocator::allocateBlock(uint32_t memoryType, ResourceKind kind, VkDeviceSize size, bool dedicated)
+{
+    if (deviceAllocationCount >= maxMemoryAllocationCount)
+    {
+        throw std::runtime_error("maxMemoryAllocationCount (" + std::to_string(maxMemoryAllocationCount) + ") exceeded!");
+    }
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(device, &allocInfo, hostAllocationCallbacks(), &memory) != VK_SUCCESS)
+    {
+        return nullptr;
+    }
+    deviceAllocationCount++;
+
+    auto block = std::make_unique<GpuMemoryBlock>();
+    block->memory = memory;
+    block->size = size;
+    block->memoryType = memoryType;
+    block->kind = kind;
+    block->dedicated = dedicated;
+    block->freeRanges[0] = size;
+
+    // Blocos visíveis pela CPU ficam mapeados durante toda a vida do bloco
+    if (memProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        if (vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &block->mapped) != VK_SUCCESS)
+        {
+            vkFreeMemory(device, memory, hostAllocationCallbacks());
+            deviceAllocationCount--;
+            throw std::runtime_error("failed to map GPU memory block!");
+        }
+    }
+
+    GpuMemoryBlock *result = block.get();
+    if (dedicated)
+    {
+        dedicatedBlocks.push_back(std::move(block));
+    }
+    else
+    {
+        pools[memoryType * 2 + static_cast<uint32_t>(kind)].push_back(std::move(block));
+    }
+    return result;
+}
+
+void GpuAllocator::freeBlock(GpuMemoryBlock *block)
+{
+    if (block->mapped != nullptr)
+    {
+        vkUnmapMemory(device, block->memory);
+    }
+    vkFreeMemory(device, block->memory, hostAllocationCallbacks());
+    deviceAllocationCount--;
+}
+
+bool GpuAllocator::allocateFromPool(uint32_t memoryType, ResourceKind kind, VkDeviceSize size, VkDeviceSize alignment,
+                                    void *userData, GpuMemoryBlock *exclude, GpuAllocation &allocation)
+{
+    for (auto &block : pools[memoryType * 2 + static_cast<uint32_t>(kind)])
+    {
+        // Na desfragmentação (exclude != nullptr) mover para um bloco vazio não libera nada
+        if (block.get() == exclude || (exclude != nullptr && block->usedBytes == 0))
+        {
+            continue;
+        }
+
+        VkDeviceSize offset;
+        if (block->allocate(size, alignment, userData, offset))
+        {
+            allocation.memory = block->memory;
+            allocation.offset = offset;
+            allocation.size = size;
+            allocation.mapped = block->mapped != nullptr ? static_cast<char *>(block->mapped) + offset : nullptr;
+            allocation.memoryType = memoryType;
+            allocation.block = block.get();
+            return true;
+        }
+    }
+    return false;
+}
+
+GpuAllocation GpuAllocator::allocate(const VkMemoryRequirements &requirements, MemoryUsage usage, ResourceKind kind, void *userData)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, usage);
+    VkDeviceSize blockSize = preferredBlockSize(memoryType);
+    VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+
+    GpuAllocation allocation{};
+
+    // Recursos maiores que meio bloco desperdiçariam a maior parte de um bloco novo: recebem memória própria
+    if (requirements.size > blockSize / 2)
+    {
+        GpuMemoryBlock *block = allocateBlock(memoryType, kind, requirements.size, true);
+        if (block == nullptr)
+        {
+            throw std::runtime_error("failed to allocate dedicated GPU memory!");
+        }
+        VkDeviceSize offset;
+        block->allocate(requirements.size, alignment, userData, offset);
+        allocation.memory = block->memory;
+        allocation.offset = offset;
+        allocation.size = requirements.size;
+        allocation.mapped = block->mapped;
+        allocation.memoryType = memoryType;
+        allocation.block = block;
+        return allocation;
+    }
+
+    if (allocateFromPool(memoryType, kind, requirements.size, alignment, userData, nullptr, allocation))
+    {
+        return allocation;
+    }
+
+    // Nenhum bloco comporta o pedido: reserva um novo, reduzindo o tamanho se o heap estiver quase cheio
+    for (VkDeviceSize size = blockSize; size >= requirements.size; size /= 2)
+    {
+        if (allocateBlock(memoryType, kind, size, false) != nullptr)
+        {
+            allocateFromPool(memoryType, kind, requirements.size, alignment, userData, nullptr, allocation);
+            return allocation;
+        }
+    }
+
+    throw std::runtime_error("failed to allocate GPU memory!");
+}
+
+void GpuAllocator::freeLocked(GpuAllocation &allocation)
+{
+    GpuMemoryBlock *block = allocation.block;
+    block->release(allocation.offset);
+
+    if (block->dedicated)
+    {
+        freeBlock(block);
+        dedicatedBlocks.erase(std::find_if(dedicatedBlocks.begin(), dedicatedBlocks.end(),
+                                           [&](const auto &candidate)
+                                           { return candidate.get() == block; }));
+    }
+
+    allocation = {};
+}
+
+void GpuAllocator::free(GpuAllocation &allocation)
+{
+    if (allocation.block == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    freeLocked(allocation);
+}
+
+void GpuAllocator::createBuffer(const VkBufferCreateInfo &createInfo, MemoryUsage usage, VkBuffer &buffer, GpuAllocation &allocation, void *userData)
+{
+    if (vkCreateBuffer(device, &createInfo, hostAllocationCallbacks(), &buffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create buffer!");
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device, buffer, &requirements);
+
+    try
+    {
+        allocation = allocate(requirements, usage, ResourceKind::Linear, userData);
+    }
+    catch (...)
+    {
+        vkDestroyBuffer(device, buffer, hostAllocationCallbacks());
+        buffer = VK_NULL_HANDLE;
+        throw;
+    }
+
+    if (vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset) != VK_SUCCESS)
+    {
+        vkDestroyBuffer(device, buffer, hostAllocationCallbacks());
+        buffer = VK_NULL_HANDLE;
+        free(allocation);
+        throw std::runtime_error("failed to bind buffer memory!");
+    }
+}
+
+void GpuAllocator::destroyBuffer(VkBuffer buffer, GpuAllocation &allocation)
+{
+    vkDestroyBuffer(device, buffer, hostAllocationCallbacks());
+    free(allocation);
+}
+
+void GpuAllocator::createImage(const VkImageCreateInfo &createInfo, MemoryUsage usage, VkImage &image, GpuAllocation &allocation, void *userData)
+{
+    if (vkCreateImage(device, &createInfo, hostAllocationCallbacks(), &image) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create image!");
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(device, image, &requirements);
+
+    ResourceKind kind = createInfo.tiling == VK_IMAGE_TILING_OPTIMAL ? ResourceKind::Optimal : ResourceKind::Linear;
+    try
+    {
+        allocation = allocate(requirements, usage, kind, userData);
+    }
+    catch (...)
+    {
+        vkDestroyImage(device, image, hostAllocationCallbacks());
+        image = VK_NULL_HANDLE;
+        throw;
+    }
+
+    if (vkBindImageMemory(device, image, allocation.memory, allocation.offset) != VK_SUCCESS)
+    {
+        vkDestroyImage(device, image, hostAllocationCallbacks());
+        image = VK_NULL_HANDLE;
+        free(allocation);
+        throw std::runtime_error("failed to bind image memory!");
+    }
+}
+
+void GpuAllocator::destroyImage(VkImage image, GpuAllocation &allocation)
+{
+    vkDestroyImage(device, image, hostAllocationCallbacks());
+    free(allocation);
+}
+
+std::vector<GpuDefragmentationMove> GpuAllocator::planDefragmentation(VkDeviceSize maxBytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<GpuDefragmentationMove> moves;
+    VkDeviceSize plannedBytes = 0;
+
+    for (uint32_t poolIndex = 0; poolIndex < pools.size(); poolIndex++)
+    {
+        auto &pool = pools[poolIndex];
+        if (pool.size() < 2)
+        {
+            continue;
+        }
+
+        // O bloco ocupado com menos bytes é o que custa menos esvaziar
+        GpuMemoryBlock *source = nullptr;
+        for (auto &block : pool)
+        {
+            if (block->usedBytes > 0 && (source == nullptr || block->usedBytes < source->usedBytes))
+            {
+                source = block.get();
+            }
+        }
+        if (source == nullptr || plannedBytes + source->usedBytes > maxBytes)
+        {
+            continue;
+        }
+
+        // Tudo ou nada: mover só parte do bloco não libera memória
+        size_t firstMove = moves.size();
+        bool complete = true;
+        for (const auto &[offset, range] : source->usedRanges)
+        {
+            GpuDefragmentationMove move{};
+            if (!allocateFromPool(source->memoryType, source->kind, range.size, range.alignment, range.userData, source, move.destination))
+            {
+                complete = false;
+                break;
+            }
+            move.source.memory = source->memory;
+            move.source.offset = offset;
+            move.source.size = range.size;
+            move.source.mapped = source->mapped != nullptr ? static_cast<char *>(source->mapped) + offset : nullptr;
+            move.source.memoryType = source->memoryType;
+            move.source.block = source;
+            move.userData = range.userData;
+            moves.push_back(move);
+        }
+
+        if (!complete)
+        {
+            for (size_t i = firstMove; i < moves.size(); i++)
+            {
+                freeLocked(moves[i].destination);
+            }
+            moves.resize(firstMove);
+            continue;
+        }
+        plannedBytes += source->usedBytes;
+    }
+
+    return moves;
+}
+
+void GpuAllocator::completeMove(const GpuDefragmentationMove &move)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    GpuAllocation source = move.source;
+    freeLocked(source);
+}
+
+void GpuAllocator::releaseEmptyBlocks()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto &pool : pools)
+    {
+        bool keptEmpty = false;
+        for (auto it = pool.begin(); it != pool.end();)
+        {
+            if ((*it)->usedBytes == 0)
+            {
+                if (!keptEmpty)
+                {
+                    keptEmpty = true;
+                    ++it;
+                    continue;
+                }
+                freeBlock(it->get());
+                it = pool.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
+
+GpuMemoryBudget GpuAllocator::deviceLocalBudget() const
+{
+    GpuMemoryBudget result{};
+    if (memoryBudgetEnabled)
+    {
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+        VkPhysicalDeviceMemoryProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        properties2.pNext = &budgetProperties;
+        vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &properties2);
+
+        result.budget = budgetProperties.heapBudget[deviceLocalHeap];
+        result.usage = budgetProperties.heapUsage[deviceLocalHeap];
+        return result;
+    }
+
+    result.budget = static_cast<VkDeviceSize>(memProperties.memoryHeaps[deviceLocalHeap].size * DEFAULT_BUDGET_FRACTION);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto accumulate = [&](const GpuMemoryBlock &block)
+    {
+        if (memProperties.memoryTypes[block.memoryType].heapIndex == deviceLocalHeap)
+        {
+            result.usage += block.size;
+        }
+    };
+    for (const auto &pool : pools)
+    {
+        for (const auto &block : pool)
+        {
+            accumulate(*block);
+        }
+    }
+    for (const auto &block : dedicatedBlocks)
+    {
+        accumulate(*block);
+    }
+    return result;
+}
+
+GpuAllocatorStats GpuAllocator::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    GpuAllocatorStats result{};
+    auto accumulate = [&](const GpuMemoryBlock &block)
+    {
+        result.blockCount++;
+        result.allocationCount += static_cast<uint32_t>(block.usedRanges.size());
+        result.reservedBytes += block.size;
+        result.usedBytes += block.usedBytes;
+    };
+
+    for (const auto &pool : pools)
+    {
+        for (const auto &block : pool)
+        {
+            accumulate(*block);
+        }
+    }
+    for (const auto &block : dedicatedBlocks)
+    {
+        accumulate(*block);
+    }
+    return result;
+}
@@ -0,0 +1,284 @@
+#include "gpu_culling.hpp"
+
+#include "host_allocator.hpp"
+#include "synchronization.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Push constants de cull.comp (limite garantido pelo Vulkan: 128 bytes)
+struct CullPushConstants
+{
+    glm::vec4 planes[6];
+    uint32_t instanceBufferIndex;
+    uint32_t meshBufferIndex;
+    uint32_t commandBufferIndex;
+    uint32_t countBufferIndex;
+    uint32_t instanceCount;
+    uint32_t maxDrawsPerMaterial;
+};
+static_assert(sizeof(CullPushConstants) <= 128, "cull push constants exceed the guaranteed limit");
+
+Frustum Frustum::fromViewProjection(const glm::mat4 &viewProjection)
+{
+    // Linhas da matriz (glm guarda colunas): cada plano é uma combinação de linhas (Gribb e Hartmann)
+    auto row = [&](int i)
+    {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+
+    Frustum frustum;
+    frustum.planes[0] = row(3) + row(0); // Esquerda
+    frustum.planes[1] = row(3) - row(0); // Direita
+    frustum.planes[2] = row(3) + row(1); // Inferior
+    frustum.planes[3] = row(3) - row(1); // Superior
+    frustum.planes[4] = row(2);          // Próximo (profundidade em [0, 1])
+    frustum.planes[5] = row(3) - row(2); // Distante
+
+    // Planos normalizados: a distância ao plano fica em unidades do mundo, comparável ao raio
+    for (auto &plane : frustum.planes)
+    {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        plane = plane / length;
+    }
+    return frustum;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3 &center, float radius) const
+{
+    for (const auto &plane : planes)
+    {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void GpuCulling::init(VkDevice device, GpuAllocator &allocator, BindlessHeap &heap, QueueTimeline &computeTimeline,
+                      uint32_t computeFamily, uint32_t graphicsFamily, uint32_t frameCount,
+                      uint32_t maxInstances, uint32_t materialCount,
+                      const std::vector<char> &shaderCode, VkPipelineCache pipelineCache)
+{
+    this->device = device;
+    this->allocator = &allocator;
+    this->heap = &heap;
+    this->computeTimeline = &computeTimeline;
+    this->maxInstances = maxInstances;
+    this->materialCount = materialCount;
+    this->pipelineCache = pipelineCache;
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(CullPushConstants);
+
+    VkDescriptorSetLayout setLayout = heap.setLayout();
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+    if (vkCreatePipelineLayout(device, &layoutInfo, hostAllocationCallbacks(), &pipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create culling pipeline layout!");
+    }
+
+    pipeline = createPipeline(shaderCode);
+
+    // Escritos pela fila de computação e lidos pela de gráficos
+    uint32_t families[] = {computeFamily, graphicsFamily};
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    if (computeFamily != graphicsFamily)
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = 2;
+        bufferInfo.pQueueFamilyIndices = families;
+    }
+    else
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+
+    frames.resize(frameCount);
+    for (auto &frame : frames)
+    {
+        bufferInfo.size = static_cast<VkDeviceSize>(materialCount) * maxInstances * sizeof(VkDrawIndexedIndirectCommand);
+        bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+        allocator.createBuffer(bufferInfo, MemoryUsage::GpuOnly, frame.commandBuffer, frame.commandAllocation);
+
+        bufferInfo.size = materialCount * sizeof(uint32_t);
+        bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                           VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        allocator.createBuffer(bufferInfo, MemoryUsage::GpuOnly, frame.countBuffer, frame.countAllocation);
+
+        frame.commandBufferIndex = heap.addStorageBuffer(frame.commandBuffer);
+        frame.countBufferIndex = heap.addStorageBuffer(frame.countBuffer);
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = computeFamily;
+        if (vkCreateCommandPool(device, &poolInfo, hostAllocationCallbacks(), &frame.commandPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create culling command pool!");
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = frame.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(device, &allocInfo, &frame.computeCommands) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate culling command buffer!");
+        }
+    }
+}
+
+VkPipeline GpuCulling::createPipeline(const std::vector<char> &shaderCode) const
+{
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = shaderCode.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t *>(shaderCode.data());
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(device, &moduleInfo, hostAllocationCallbacks(), &shaderModule) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create culling shader module!");
+    }
+
+    // local_size_x_id = 0
+    uint32_t workgroupSize = WORKGROUP_SIZE;
+    VkSpecializationMapEntry specializationEntry{0, 0, sizeof(workgroupSize)};
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = 1;
+    specializationInfo.pMapEntries = &specializationEntry;
+    specializationInfo.dataSize = sizeof(workgroupSize);
+    specializationInfo.pData = &workgroupSize;
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.stage.pSpecializationInfo = &specializationInfo;
+    pipelineInfo.layout = pipelineLayout;
+    VkPipeline created;
+    VkResult result = vkCreateComputePipelines(device, pipelineCache, 1, &pipelineInfo, hostAllocationCallbacks(), &created);
+    vkDestroyShaderModule(device, shaderModule, hostAllocationCallbacks());
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create culling pipeline!");
+    }
+    return created;
+}
+
+VkPipeline GpuCulling::swapPipeline(VkPipeline newPipeline)
+{
+    VkPipeline old = pipeline;
+    pipeline = newPipeline;
+    return old;
+}
+
+void GpuCulling::destroy()
+{
+    for (auto &frame : frames)
+    {
+        heap->removeStorageBuffer(frame.commandBufferIndex);
+        heap->removeStorageBuffer(frame.countBufferIndex);
+        allocator->destroyBuffer(frame.commandBuffer, frame.commandAllocation);
+        allocator->destroyBuffer(frame.countBuffer, frame.countAllocation);
+        vkDestroyCommandPool(device, frame.commandPool, hostAllocationCallbacks());
+    }
+    frames.clear();
+
+    if (pipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(device, pipeline, hostAllocationCallbacks());
+        pipeline = VK_NULL_HANDLE;
+    }
+    if (pipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(device, pipelineLayout, hostAllocationCallbacks());
+        pipelineLayout = VK_NULL_HANDLE;
+    }
+}
+
+uint64_t GpuCulling::cull(uint32_t frameIndex, const Frustum &frustum, uint32_t instanceBufferIndex,
+                          uint32_t meshBufferIndex, uint32_t instanceCount,
+                          const QueueTimeline *waitTimeline, uint64_t waitValue)
+{
+    FrameData &frame = frames[frameIndex];
+
+    // Os gráficos do quadro anterior esperaram esta seleção, então a espera normalmente não bloqueia
+    computeTimeline->wait(frame.value);
+    vkResetCommandPool(device, frame.commandPool, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(frame.computeCommands, &beginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to begin recording culling command buffer!");
+    }
+
+    // Zera as contagens antes que o shader as incremente
+    vkCmdFillBuffer(frame.computeCommands, frame.countBuffer, 0, VK_WHOLE_SIZE, 0);
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    cmdPipelineBarrier(frame.computeCommands, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                       1, &barrier, 0, nullptr, 0, nullptr);
+
+    CullPushConstants pushConstants{};
+    for (size_t i = 0; i < frustum.planes.size(); i++)
+    {
+        pushConstants.planes[i] = frustum.planes[i];
+    }
+    pushConstants.instanceBufferIndex = instanceBufferIndex;
+    pushConstants.meshBufferIndex = meshBufferIndex;
+    pushConstants.commandBufferIndex = frame.commandBufferIndex;
+    pushConstants.countBufferIndex = frame.countBufferIndex;
+    pushConstants.instanceCount = std::min(instanceCount, maxInstances);
+    pushConstants.maxDrawsPerMaterial = maxInstances;
+
+    vkCmdBindPipeline(frame.computeCommands, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    heap->bind(frame.computeCommands, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout);
+    vkCmdPushConstants(frame.computeCommands, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+    vkCmdDispatch(frame.computeCommands, (pushConstants.instanceCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+    if (vkEndCommandBuffer(frame.computeCommands) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to record culling command buffer!");
+    }
+
+    // A submissão de gráficos espera o valor devolvido, o que também torna os comandos escritos visíveis para ela
+    SubmitBatch batch;
+    batch.addCommandBuffer(frame.computeCommands);
+    if (waitTimeline != nullptr && waitValue != 0)
+    {
+        batch.wait(*waitTimeline, waitValue, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    }
+    if (computeTimeline->submit(batch, frame.value) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit culling commands!");
+    }
+    return frame.value;
+}
+
+void GpuCulling::recordDraws(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t material) const
+{
+    const FrameData &frame = frames[frameIndex];
+    VkDeviceSize commandOffset = static_cast<VkDeviceSize>(material) * maxInstances * sizeof(VkDrawIndexedIndirectCommand);
+    vkCmdDrawIndexedIndirectCount(commandBuffer, frame.commandBuffer, commandOffset,
+                                  frame.countBuffer, material * sizeof(uint32_t),
+                                  maxInstances, sizeof(VkDrawIndexedIndirectCommand));
+}
@@ -0,0 +1,424 @@
+#include "host_allocator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+// Alinhamento garantido por std::malloc; os blocos dos pools e da arena partem dele
+static const size_t BASE_ALIGNMENT = alignof(std::max_align_t);
+static const size_t MIN_POOL_BLOCK = 32;
+static const size_t POOL_CHUNK_SIZE = 64 * 1024;
+
+static const char *SCOPE_NAMES[HostAllocator::SCOPE_COUNT] = {"command", "object", "cache", "device", "instance"};
+
+enum class BlockKind : uint8_t
+{
+    Arena,
+    Pool,
+    Heap,
+};
+
+// Antes de cada ponteiro devolvido ao driver
+struct BlockHeader
+{
+    uint64_t size;        // Pedido pelo driver
+    uint32_t offset;      // Do início do bloco até o ponteiro devolvido
+    uint8_t scope;
+    BlockKind kind;
+    uint8_t sizeClass;    // Pool
+    uint8_t alignmentLog; // Heap
+};
+
+static_assert(sizeof(BlockHeader) == 16, "BlockHeader layout changed");
+
+static const VkAllocationCallbacks *installedCallbacks = nullptr;
+
+const VkAllocationCallbacks *hostAllocationCallbacks()
+{
+    return installedCallbacks;
+}
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static BlockHeader *headerOf(void *memory)
+{
+    return reinterpret_cast<BlockHeader *>(static_cast<char *>(memory) - sizeof(BlockHeader));
+}
+
+// Escreve o cabeçalho e devolve o primeiro endereço alinhado depois dele
+static void *placeBlock(char *base, size_t size, size_t alignment, VkSystemAllocationScope scope, BlockKind kind)
+{
+    char *memory = reinterpret_cast<char *>(alignUp(reinterpret_cast<uintptr_t>(base) + sizeof(BlockHeader), alignment));
+    BlockHeader *header = headerOf(memory);
+    header->size = size;
+    header->offset = static_cast<uint32_t>(memory - base);
+    header->scope = static_cast<uint8_t>(scope);
+    header->kind = kind;
+    header->sizeClass = 0;
+    header->alignmentLog = 0;
+    return memory;
+}
+
+static size_t poolClassSize(uint32_t sizeClass)
+{
+    return MIN_POOL_BLOCK << sizeClass;
+}
+
+static void updatePeak(std::atomic<uint64_t> &peak, uint64_t value)
+{
+    uint64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+HostAllocator::~HostAllocator()
+{
+    uninstall();
+}
+
+void HostAllocator::install(uint64_t limit)
+{
+    limitBytes = limit;
+    if (!reserve(ARENA_SIZE))
+    {
+        throw std::runtime_error("failed to reserve the host allocation arena!");
+    }
+    arena.memory = static_cast<char *>(std::malloc(ARENA_SIZE));
+    if (arena.memory == nullptr)
+    {
+        throw std::runtime_error("failed to reserve the host allocation arena!");
+    }
+
+    vkCallbacks.pUserData = this;
+    vkCallbacks.pfnAllocation = allocationCallback;
+    vkCallbacks.pfnReallocation = reallocationCallback;
+    vkCallbacks.pfnFree = freeCallback;
+    vkCallbacks.pfnInternalAllocation = internalAllocationCallback;
+    vkCallbacks.pfnInternalFree = internalFreeCallback;
+    installedCallbacks = &vkCallbacks;
+    installed = true;
+}
+
+void HostAllocator::uninstall()
+{
+    if (!installed)
+    {
+        return;
+    }
+    installedCallbacks = nullptr;
+    installed = false;
+
+    for (auto &pool : pools)
+    {
+        for (void *chunk : pool.chunks)
+        {
+            std::free(chunk);
+        }
+        pool.chunks.clear();
+        pool.freeList = nullptr;
+    }
+    std::free(arena.memory);
+    arena.memory = nullptr;
+}
+
+void HostAllocator::beginFrame()
+{
+    if (!installed)
+    {
+        return;
+    }
+
+    // O primeiro quadro ainda inclui a criação dos recursos feita sob demanda
+    bool counted = framesBegun > 1;
+    for (auto &scope : scopes)
+    {
+        uint64_t frameAllocations = scope.frameAllocations.exchange(0, std::memory_order_relaxed);
+        if (counted)
+        {
+            scope.loopAllocations += frameAllocations;
+            scope.maxFrameAllocations = std::max(scope.maxFrameAllocations, frameAllocations);
+        }
+    }
+    framesBegun++;
+
+    std::lock_guard<std::mutex> lock(arena.mutex);
+    if (arena.live == 0)
+    {
+        arena.offset = 0;
+    }
+    else
+    {
+        arena.skippedResets++;
+    }
+}
+
+bool HostAllocator::reserve(uint64_t bytes)
+{
+    uint64_t reserved = reservedBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (limitBytes != 0 && reserved > limitBytes)
+    {
+        reservedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        return false;
+    }
+    updatePeak(peakReservedBytes, reserved);
+    return true;
+}
+
+void HostAllocator::release(uint64_t bytes)
+{
+    reservedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void *HostAllocator::allocate(size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    if (size == 0)
+    {
+        return nullptr;
+    }
+    alignment = std::max(alignment, BASE_ALIGNMENT);
+
+    void *memory = nullptr;
+    if (scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND)
+    {
+        memory = allocateFromArena(size, alignment);
+    }
+    else if (alignment == BASE_ALIGNMENT && size + sizeof(BlockHeader) <= poolClassSize(POOL_CLASS_COUNT - 1))
+    {
+        uint32_t sizeClass = 0;
+        while (poolClassSize(sizeClass) < size + sizeof(BlockHeader))
+        {
+            sizeClass++;
+        }
+        char *base = static_cast<char *>(allocateFromPool(sizeClass));
+        if (base != nullptr)
+        {
+            memory = placeBlock(base, size, alignment, scope, BlockKind::Pool);
+            headerOf(memory)->sizeClass = static_cast<uint8_t>(sizeClass);
+        }
+    }
+    // Também recebe o que não coube na arena ou no limite dos pools
+    if (memory == nullptr)
+    {
+        memory = allocateFromHeap(size, alignment, scope);
+    }
+    if (memory == nullptr)
+    {
+        failedAllocations.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    ScopeCounters &counters = scopes[scope];
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    updatePeak(counters.peakBytes, counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+    return memory;
+}
+
+void *HostAllocator::allocateFromArena(size_t size, size_t alignment)
+{
+    std::lock_guard<std::mutex> lock(arena.mutex);
+    uintptr_t start = reinterpret_cast<uintptr_t>(arena.memory);
+    size_t end = alignUp(start + arena.offset + sizeof(BlockHeader), alignment) + size - start;
+    if (end > ARENA_SIZE)
+    {
+        arena.overflows++;
+        return nullptr;
+    }
+    void *memory = placeBlock(arena.memory + arena.offset, size, alignment, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND,
+                              BlockKind::Arena);
+    arena.offset = end;
+    arena.peakOffset = std::max(arena.peakOffset, arena.offset);
+    arena.live++;
+    return memory;
+}
+
+void *HostAllocator::allocateFromPool(uint32_t sizeClass)
+{
+    Pool &pool = pools[sizeClass];
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (pool.freeList == nullptr)
+    {
+        if (!reserve(POOL_CHUNK_SIZE))
+        {
+            return nullptr;
+        }
+        char *chunk = static_cast<char *>(std::malloc(POOL_CHUNK_SIZE));
+        if (chunk == nullptr)
+        {
+            release(POOL_CHUNK_SIZE);
+            return nullptr;
+        }
+        pool.chunks.push_back(chunk);
+        size_t blockSize = poolClassSize(sizeClass);
+        for (size_t offset = 0; offset + blockSize <= POOL_CHUNK_SIZE; offset += blockSize)
+        {
+            *reinterpret_cast<void **>(chunk + offset) = pool.freeList;
+            pool.freeList = chunk + offset;
+        }
+    }
+    void *block = pool.freeList;
+    pool.freeList = *static_cast<void **>(block);
+    return block;
+}
+
+void *HostAllocator::allocateFromHeap(size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    size_t total = sizeof(BlockHeader) + size + (alignment > BASE_ALIGNMENT ? alignment : 0);
+    if (!reserve(total))
+    {
+        return nullptr;
+    }
+    char *base = static_cast<char *>(std::malloc(total));
+    if (base == nullptr)
+    {
+        release(total);
+        return nullptr;
+    }
+    void *memory = placeBlock(base, size, alignment, scope, BlockKind::Heap);
+    uint8_t alignmentLog = 0;
+    while ((size_t(1) << alignmentLog) < alignment)
+    {
+        alignmentLog++;
+    }
+    headerOf(memory)->alignmentLog = alignmentLog;
+    return memory;
+}
+
+void *HostAllocator::reallocate(void *original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    if (original == nullptr)
+    {
+        return allocate(size, alignment, scope);
+    }
+    if (size == 0)
+    {
+        free(original);
+        return nullptr;
+    }
+
+    // Se falhar, o bloco original continua válido
+    void *memory = allocate(size, alignment, scope);
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+    std::memcpy(memory, original, static_cast<size_t>(std::min<uint64_t>(headerOf(original)->size, size)));
+    free(original);
+    scopes[scope].reallocations.fetch_add(1, std::memory_order_relaxed);
+    return memory;
+}
+
+void HostAllocator::free(void *memory)
+{
+    if (memory == nullptr)
+    {
+        return;
+    }
+    BlockHeader *header = headerOf(memory);
+    ScopeCounters &counters = scopes[header->scope];
+    counters.frees.fetch_add(1, std::memory_order_relaxed);
+    counters.liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+
+    char *base = static_cast<char *>(memory) - header->offset;
+    switch (header->kind)
+    {
+    case BlockKind::Arena:
+    {
+        std::lock_guard<std::mutex> lock(arena.mutex);
+        arena.live--;
+        break;
+    }
+    case BlockKind::Pool:
+    {
+        Pool &pool = pools[header->sizeClass];
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        *reinterpret_cast<void **>(base) = pool.freeList;
+        pool.freeList = base;
+        break;
+    }
+    case BlockKind::Heap:
+    {
+        size_t alignment = size_t(1) << header->alignmentLog;
+        release(sizeof(BlockHeader) + header->size + (alignment > BASE_ALIGNMENT ? alignment : 0));
+        std::free(base);
+        break;
+    }
+    }
+}
+
+std::string HostAllocator::describe() const
+{
+    std::ostringstream out;
+    if (!installed)
+    {
+        out << "host allocator: driver";
+        return out.str();
+    }
+
+    uint64_t loopFrames = framesBegun > 2 ? framesBegun - 2 : 0;
+    out << std::fixed << std::setprecision(1) << "host allocator: " << reservedBytes.load() / (1024.0 * 1024.0)
+        << " MiB reserved (peak " << peakReservedBytes.load() / (1024.0 * 1024.0) << " MiB";
+    if (limitBytes != 0)
+    {
+        out << ", limit " << limitBytes / (1024.0 * 1024.0) << " MiB";
+    }
+    out << "), arena peak " << arena.peakOffset / 1024.0 << " KiB of " << ARENA_SIZE / 1024 << " KiB, " << arena.overflows
+        << " arena overflows (" << arena.skippedResets << " frames without reset), " << failedAllocations.load() << " failed";
+    for (uint32_t i = 0; i < SCOPE_COUNT; i++)
+    {
+        const ScopeCounters &scope = scopes[i];
+        if (scope.allocations.load() == 0 && scope.internalBytes.load() == 0)
+        {
+            continue;
+        }
+        out << "\n  " << SCOPE_NAMES[i] << ": " << scope.allocations.load() << " allocations ("
+            << scope.reallocations.load() << " reallocations), " << scope.liveBytes.load() / 1024.0 << " KiB live, peak "
+            << scope.peakBytes.load() / 1024.0 << " KiB";
+        if (loopFrames > 0)
+        {
+            out << ", " << double(scope.loopAllocations) / loopFrames << " per frame (max " << scope.maxFrameAllocations
+                << ")";
+        }
+        if (scope.internalBytes.load() != 0)
+        {
+            out << ", internal " << scope.internalBytes.load() / 1024.0 << " KiB";
+        }
+    }
+    return out.str();
+}
+
+void *VKAPI_CALL HostAllocator::allocationCallback(void *userData, size_t size, size_t alignment,
+                                                   VkSystemAllocationScope scope)
+{
+    return static_cast<HostAllocator *>(userData)->allocate(size, alignment, scope);
+}
+
+void *VKAPI_CALL HostAllocator::reallocationCallback(void *userData, void *original, size_t size, size_t alignment,
+                                                     VkSystemAllocationScope scope)
+{
+    return static_cast<HostAllocator *>(userData)->reallocate(original, size, alignment, scope);
+}
+
+void VKAPI_CALL HostAllocator::freeCallback(void *userData, void *memory)
+{
+    static_cast<HostAllocator *>(userData)->free(memory);
+}
+
+void VKAPI_CALL HostAllocator::internalAllocationCallback(void *userData, size_t size, VkInternalAllocationType,
+                                                          VkSystemAllocationScope scope)
+{
+    static_cast<HostAllocator *>(userData)->scopes[scope].internalBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void VKAPI_CALL HostAllocator::internalFreeCallback(void *userData, size_t size, VkInternalAllocationType,
+                                                    VkSystemAllocationScope scope)
+{
+    static_cast<HostAllocator *>(userData)->scopes[scope].internalBytes.fetch_sub(size, std::memory_order_relaxed);
+}
@@ -0,0 +1,350 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace
+{
+// Sistema e índice da thread atual; trabalhos de um sistema nunca rodam em threads de outro
+thread_local const JobSystem *currentSystem = nullptr;
+thread_local uint32_t currentIndex = JobSystem::EXTERNAL_THREAD;
+} // namespace
+
+JobCounter::~JobCounter()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return pending == 0; });
+}
+
+bool JobCounter::done() const
+{
+    // Sob o mutex: quem zerou o contador já o soltou quando esta leitura vê zero, e o contador pode ser destruído
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending == 0;
+}
+
+JobSystem::~JobSystem()
+{
+    destroy();
+}
+
+void JobSystem::init(uint32_t workerCount)
+{
+    if (workerCount == 0)
+    {
+        // A thread principal executa trabalhos só enquanto espera; os trabalhadores ocupam os outros núcleos
+        // (hardware_concurrency pode retornar 0 quando a informação não está disponível)
+        workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+
+    queues.resize(workerCount + 1);
+    for (auto &queue : queues)
+    {
+        queue = std::make_unique<Queue>();
+    }
+    currentSystem = this;
+    currentIndex = 0;
+
+    stopping = false;
+    for (uint32_t i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+    }
+}
+
+void JobSystem::destroy()
+{
+    if (queues.empty())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    workers.clear();
+
+    // Continuações lançadas pelos últimos trabalhos; os contadores precisam zerar para poderem ser destruídos
+    Job job;
+    while (take(0, true, job))
+    {
+        execute(job);
+    }
+    queues.clear();
+
+    if (currentSystem == this)
+    {
+        currentSystem = nullptr;
+        currentIndex = EXTERNAL_THREAD;
+    }
+}
+
+uint32_t JobSystem::threadIndex() const
+{
+    return currentSystem == this ? currentIndex : EXTERNAL_THREAD;
+}
+
+void JobSystem::run(std::function<void()> function, JobCounter *counter, JobPriority priority)
+{
+    for (JobCounter *target : {counter, priority == JobPriority::Frame ? &frameJobs : nullptr})
+    {
+        if (target != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(target->mutex);
+            target->pending++;
+        }
+    }
+    push(Job{std::move(function), counter, priority});
+}
+
+void JobSystem::runAfter(JobCounter &dependency, std::function<void()> function, JobCounter *counter,
+                         JobPriority priority)
+{
+    // Os contadores contam a continuação desde já: esperar por counter também espera a dependência
+    for (JobCounter *target : {counter, priority == JobPriority::Frame ? &frameJobs : nullptr})
+    {
+        if (target != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(target->mutex);
+            target->pending++;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.mutex);
+        if (dependency.pending != 0)
+        {
+            dependency.continuations.push_back({std::move(function), counter, priority});
+            return;
+        }
+    }
+    push(Job{std::move(function), counter, priority});
+}
+
+void JobSystem::wait(JobCounter &counter)
+{
+    uint32_t index = threadIndex();
+    for (;;)
+    {
+        // O evento é lido antes das verificações: o que acontecer depois delas muda epoch e acorda a espera
+        uint64_t seen = currentEpoch();
+        if (counter.done())
+        {
+            break;
+        }
+
+        Job job;
+        if (index != EXTERNAL_THREAD && take(index, false, job))
+        {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&] { return epoch != seen; });
+    }
+
+    std::exception_ptr jobError;
+    {
+        std::lock_guard<std::mutex> lock(counter.mutex);
+        jobError = std::exchange(counter.error, nullptr);
+    }
+    if (jobError)
+    {
+        std::rethrow_exception(jobError);
+    }
+}
+
+void JobSystem::frameBarrier()
+{
+    auto start = std::chrono::steady_clock::now();
+    wait(frameJobs);
+    barrierWait += std::chrono::steady_clock::now() - start;
+    barriers++;
+
+    std::exception_ptr jobError;
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        jobError = std::exchange(error, nullptr);
+    }
+    if (jobError)
+    {
+        std::rethrow_exception(jobError);
+    }
+}
+
+std::string JobSystem::describe() const
+{
+    std::ostringstream out;
+    out << "jobs: " << workers.size() << " workers + main thread, " << executed.load() << " jobs, " << steals.load()
+        << " stolen, frame barrier wait " << std::fixed << std::setprecision(3)
+        << (barriers != 0 ? barrierWait.count() / barriers : 0.0) << " ms avg over " << barriers << " frames";
+    return out.str();
+}
+
+void JobSystem::push(Job job)
+{
+    if (job.priority == JobPriority::Background)
+    {
+        std::lock_guard<std::mutex> lock(backgroundMutex);
+        backgroundJobs.push_back(std::move(job));
+    }
+    else
+    {
+        // Threads de fora do sistema (como a da recarga de shaders) distribuem os trabalhos entre as filas
+        uint32_t index = threadIndex();
+        if (index == EXTERNAL_THREAD)
+        {
+            index = nextExternalQueue.fetch_add(1) % static_cast<uint32_t>(queues.size());
+        }
+        Queue &queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    signal();
+}
+
+bool JobSystem::take(uint32_t index, bool allowBackground, Job &job)
+{
+    {
+        Queue &own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+
+    // Rouba o trabalho mais antigo, começando pela thread seguinte para espalhar os roubos entre as filas
+    uint32_t count = static_cast<uint32_t>(queues.size());
+    for (uint32_t i = 1; i < count; i++)
+    {
+        Queue &victim = *queues[(index + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            steals++;
+            return true;
+        }
+    }
+
+    if (allowBackground)
+    {
+        std::lock_guard<std::mutex> lock(backgroundMutex);
+        if (!backgroundJobs.empty())
+        {
+            job = std::move(backgroundJobs.front());
+            backgroundJobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(Job &job)
+{
+    std::exception_ptr jobError;
+    try
+    {
+        job.function();
+    }
+    catch (...)
+    {
+        jobError = std::current_exception();
+    }
+    executed++;
+    // As capturas podem referenciar a pilha de quem espera: são liberadas antes de o contador zerar
+    job.function = nullptr;
+
+    if (job.counter != nullptr)
+    {
+        finish(*job.counter, jobError);
+    }
+    else if (jobError)
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+        {
+            error = jobError;
+        }
+    }
+    if (job.priority == JobPriority::Frame)
+    {
+        finish(frameJobs, nullptr);
+    }
+}
+
+void JobSystem::finish(JobCounter &counter, std::exception_ptr jobError)
+{
+    std::vector<JobCounter::Continuation> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter.mutex);
+        if (jobError && !counter.error)
+        {
+            counter.error = jobError;
+        }
+        if (--counter.pending == 0)
+        {
+            ready.swap(counter.continuations);
+            counter.finished.notify_all();
+        }
+    }
+    // Depois de soltar o mutex o contador não é mais tocado: quem o espera pode destruí-lo
+    for (auto &continuation : ready)
+    {
+        push(Job{std::move(continuation.function), continuation.counter, continuation.priority});
+    }
+    signal();
+}
+
+void JobSystem::signal()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        epoch++;
+    }
+    wake.notify_all();
+}
+
+uint64_t JobSystem::currentEpoch()
+{
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    return epoch;
+}
+
+void JobSystem::workerLoop(uint32_t index)
+{
+    currentSystem = this;
+    currentIndex = index;
+
+    for (;;)
+    {
+        uint64_t seen = currentEpoch();
+        Job job;
+        if (take(index, true, job))
+        {
+            execute(job);
+            continue;
+        }
+
+        // Só encerra com as filas vazias: os trabalhos lançados antes de destroy ainda rodam
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (stopping)
+        {
+            return;
+        }
+        wake.wait(lock, [&] { return stopping || epoch != seen; });
+    }
+}
@@ -0,0 +1,153 @@
+#include "parallel_recorder.hpp"
+
+#include "host_allocator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+// Blocos muito pequenos custam mais em vkCmdExecuteCommands e troca de estado do que economizam em paralelismo
+static const uint32_t MIN_DRAWS_PER_CHUNK = 256;
+// Blocos por thread: alguns a mais que o número de threads equilibram blocos mais lentos que outros
+static const uint32_t CHUNKS_PER_THREAD = 4;
+
+void ParallelRecorder::init(VkDevice device, uint32_t queueFamily, uint32_t frameCount, JobSystem &jobs)
+{
+    this->device = device;
+    this->frameCount = frameCount;
+    this->jobs = &jobs;
+
+    pools.resize(jobs.threadCount());
+    for (auto &threadPools : pools)
+    {
+        threadPools.resize(frameCount);
+        for (auto &pool : threadPools)
+        {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            // Sem RESET_COMMAND_BUFFER_BIT: o pool inteiro é resetado de uma vez a cada quadro
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = queueFamily;
+
+            if (vkCreateCommandPool(device, &poolInfo, hostAllocationCallbacks(), &pool.commandPool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create worker command pool!");
+            }
+        }
+    }
+}
+
+void ParallelRecorder::destroy()
+{
+    // Destruir o pool libera os buffers de comando alocados nele
+    for (auto &threadPools : pools)
+    {
+        for (auto &pool : threadPools)
+        {
+            vkDestroyCommandPool(device, pool.commandPool, hostAllocationCallbacks());
+        }
+    }
+    pools.clear();
+}
+
+void ParallelRecorder::beginFrame(uint32_t frameIndex)
+{
+    // Nenhum buffer deste quadro está mais em uso pela GPU: reaproveita todos de uma vez
+    for (auto &threadPools : pools)
+    {
+        vkResetCommandPool(device, threadPools[frameIndex].commandPool, 0);
+        threadPools[frameIndex].used = 0;
+    }
+}
+
+std::vector<VkCommandBuffer> ParallelRecorder::record(uint32_t frameIndex, const VkCommandBufferInheritanceInfo &inheritance,
+                                                      uint32_t drawCount, const RecordFunction &recordRange)
+{
+    if (drawCount == 0)
+    {
+        return {};
+    }
+
+    uint32_t targetChunks = jobs->threadCount() * CHUNKS_PER_THREAD;
+    uint32_t drawsPerChunk = std::max(MIN_DRAWS_PER_CHUNK, (drawCount + targetChunks - 1) / targetChunks);
+    uint32_t chunkCount = (drawCount + drawsPerChunk - 1) / drawsPerChunk;
+    std::vector<VkCommandBuffer> results(chunkCount, VK_NULL_HANDLE);
+
+    // Depois de uma falha os blocos restantes não são gravados; wait relança a exceção
+    std::atomic<bool> failed{false};
+    JobCounter chunks;
+    for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        uint32_t first = chunk * drawsPerChunk;
+        uint32_t last = std::min(first + drawsPerChunk, drawCount);
+        jobs->run([this, frameIndex, &inheritance, &recordRange, first, last, &result = results[chunk], &failed]
+                  {
+                      if (failed.load())
+                      {
+                          return;
+                      }
+                      try
+                      {
+                          // O índice da thread escolhe o pool: nenhum outro trabalho usa este pool ao mesmo tempo
+                          recordChunk(pools[jobs->threadIndex()][frameIndex], inheritance, recordRange, first, last,
+                                      result);
+                      }
+                      catch (...)
+                      {
+                          failed.store(true);
+                          throw;
+                      }
+                  },
+                  &chunks);
+    }
+    jobs->wait(chunks);
+    return results;
+}
+
+void ParallelRecorder::recordChunk(ThreadPool &pool, const VkCommandBufferInheritanceInfo &inheritance,
+                                   const RecordFunction &recordRange, uint32_t first, uint32_t last,
+                                   VkCommandBuffer &result)
+{
+    VkCommandBuffer commandBuffer = acquireCommandBuffer(pool);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    // Executado dentro do passe de renderização do buffer primário
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritance;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to begin recording secondary command buffer!");
+    }
+
+    recordRange(commandBuffer, first, last);
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to record secondary command buffer!");
+    }
+
+    // Cada bloco tem a sua posição em results, então as escritas não conflitam
+    result = commandBuffer;
+}
+
+VkCommandBuffer ParallelRecorder::acquireCommandBuffer(ThreadPool &pool)
+{
+    if (pool.used == pool.commandBuffers.size())
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = pool.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate secondary command buffer!");
+        }
+        pool.commandBuffers.push_back(commandBuffer);
+    }
+    return pool.commandBuffers[pool.used++];
+}
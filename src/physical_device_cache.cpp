@@ -0,0 +1,106 @@
+#include "physical_device_cache.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+static std::string queryUuid(VkPhysicalDevice device, const VkPhysicalDeviceProperties &properties)
+{
+    if (properties.apiVersion < VK_API_VERSION_1_1)
+    {
+        return {};
+    }
+
+    VkPhysicalDeviceIDProperties idProperties{};
+    idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &idProperties;
+    vkGetPhysicalDeviceProperties2(device, &properties2);
+
+    std::ostringstream uuid;
+    for (uint32_t i = 0; i < VK_UUID_SIZE; i++)
+    {
+        uuid << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(idProperties.deviceUUID[i]);
+    }
+    return uuid.str();
+}
+
+bool PhysicalDeviceInfo::hasExtension(const char *name) const
+{
+    for (const auto &extension : extensions)
+    {
+        if (std::strcmp(extension.extensionName, name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PhysicalDeviceCache::init(VkInstance instance, VkSurfaceKHR surface, uint32_t instanceApiVersion)
+{
+    uint32_t deviceCount = 0;
+    vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+    std::vector<VkPhysicalDevice> devices(deviceCount);
+    vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+
+    infos.clear();
+    for (VkPhysicalDevice device : devices)
+    {
+        PhysicalDeviceInfo info;
+        info.device = device;
+        vkGetPhysicalDeviceProperties(device, &info.properties);
+        vkGetPhysicalDeviceMemoryProperties(device, &info.memoryProperties);
+        info.capabilities = DeviceCapabilities::query(device, instanceApiVersion);
+        info.uuid = queryUuid(device, info.properties);
+
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+        info.queueFamilies.resize(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, info.queueFamilies.data());
+
+        info.presentSupport.assign(queueFamilyCount, VK_FALSE);
+        if (surface != VK_NULL_HANDLE)
+        {
+            for (uint32_t i = 0; i < queueFamilyCount; i++)
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &info.presentSupport[i]);
+            }
+        }
+
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+        info.extensions.resize(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, info.extensions.data());
+
+        // Sem VK_KHR_swapchain a superfície não pode ser usada por este dispositivo
+        if (surface != VK_NULL_HANDLE && info.hasExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME))
+        {
+            uint32_t formatCount = 0;
+            vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, nullptr);
+            info.surfaceFormats.resize(formatCount);
+            vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, info.surfaceFormats.data());
+
+            uint32_t presentModeCount = 0;
+            vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, nullptr);
+            info.presentModes.resize(presentModeCount);
+            vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, info.presentModes.data());
+        }
+        infos.push_back(std::move(info));
+    }
+}
+
+const PhysicalDeviceInfo &PhysicalDeviceCache::get(VkPhysicalDevice device) const
+{
+    for (const PhysicalDeviceInfo &info : infos)
+    {
+        if (info.device == device)
+        {
+            return info;
+        }
+    }
+    throw std::runtime_error("failed to find physical device in the cache!");
+}
@@ -0,0 +1,127 @@
+#include "pipeline_cache.hpp"
+
+#include "host_allocator.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// Lê o arquivo inteiro; retorna um vetor vazio se ele não existir
+static std::vector<char> readCacheFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (!file.is_open())
+    {
+        return {};
+    }
+
+    std::vector<char> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(data.data(), data.size());
+    if (!file)
+    {
+        return {};
+    }
+    return data;
+}
+
+bool PipelineCache::isCompatible(const std::vector<char> &data, const VkPhysicalDeviceProperties &properties)
+{
+    VkPipelineCacheHeaderVersionOne header{};
+    if (data.size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    // O cabeçalho identifica o fornecedor, o dispositivo e a versão do driver (pipelineCacheUUID)
+    return header.headerSize >= sizeof(header) &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == properties.vendorID &&
+           header.deviceID == properties.deviceID &&
+           std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+std::vector<char> PipelineCache::load(const std::string &path)
+{
+    return readCacheFile(path);
+}
+
+void PipelineCache::create(VkDevice device, const VkPhysicalDeviceProperties &properties, const std::string &path)
+{
+    create(device, properties, path, readCacheFile(path));
+}
+
+void PipelineCache::create(VkDevice device, const VkPhysicalDeviceProperties &properties, const std::string &path,
+                           std::vector<char> data)
+{
+    this->device = device;
+    this->path = path;
+
+    if (!data.empty() && !isCompatible(data, properties))
+    {
+        // Dados de outro dispositivo ou driver: o driver poderia rejeitá-los ou, pior, aceitá-los sem benefício
+        std::cerr << "pipeline cache: discarding " << path << " (created by a different device or driver)" << std::endl;
+        data.clear();
+    }
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(device, &createInfo, hostAllocationCallbacks(), &cache) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+}
+
+void PipelineCache::save() const
+{
+    if (cache == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(device, cache, &size, nullptr) != VK_SUCCESS || size == 0)
+    {
+        return;
+    }
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(device, cache, &size, data.data()) != VK_SUCCESS)
+    {
+        return;
+    }
+
+    // Escreve em um arquivo temporário e renomeia, para não deixar um cache truncado se o processo for interrompido
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), size);
+        if (!file)
+        {
+            std::cerr << "pipeline cache: failed to write " << tempPath << std::endl;
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::cerr << "pipeline cache: failed to replace " << path << ": " << error.message() << std::endl;
+    }
+}
+
+void PipelineCache::destroy()
+{
+    if (cache != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineCache(device, cache, hostAllocationCallbacks());
+        cache = VK_NULL_HANDLE;
+    }
+}
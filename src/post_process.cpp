@@ -0,0 +1,230 @@
+#include "post_process.hpp"
+
+#include "host_allocator.hpp"
+
+#include <array>
+#include <stdexcept>
+
+// Push constants de post.comp
+struct PostPushConstants
+{
+    uint32_t outputWidth;
+    uint32_t outputHeight;
+    float sceneTexelWidth;
+    float sceneTexelHeight;
+    float sceneUvScaleX; // Fração da imagem da cena ocupada pelo retângulo desenhado
+    float sceneUvScaleY;
+    float exposure;
+    uint32_t outputEncoding; // OutputEncoding
+    float paperWhiteNits;
+};
+static_assert(sizeof(PostPushConstants) <= 128, "post push constants exceed the guaranteed limit");
+
+bool PostProcess::supportsStorageOutput(VkPhysicalDevice physicalDevice, VkFormat format)
+{
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+    return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+}
+
+void PostProcess::init(VkDevice device, uint32_t frameCount, uint32_t outputCount, const std::vector<char> &shaderCode,
+                       VkPipelineCache pipelineCache)
+{
+    this->device = device;
+    this->outputCount = outputCount;
+    this->pipelineCache = pipelineCache;
+
+    // A ampliação é a própria filtragem bilinear; a borda é repetida para o FXAA não ler fora da cena
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = 0.0f;
+    if (vkCreateSampler(device, &samplerInfo, hostAllocationCallbacks(), &sampler) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create post processing sampler!");
+    }
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[0].pImmutableSamplers = &sampler;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo{};
+    setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    setLayoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    setLayoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(device, &setLayoutInfo, hostAllocationCallbacks(), &setLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create post processing descriptor set layout!");
+    }
+
+    uint32_t setCount = frameCount * outputCount;
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0] = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, setCount};
+    poolSizes[1] = {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, setCount};
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = setCount;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    if (vkCreateDescriptorPool(device, &poolInfo, hostAllocationCallbacks(), &descriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create post processing descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(setCount, setLayout);
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = setCount;
+    allocInfo.pSetLayouts = layouts.data();
+    descriptorSets.resize(setCount);
+    if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate post processing descriptor sets!");
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PostPushConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+    if (vkCreatePipelineLayout(device, &layoutInfo, hostAllocationCallbacks(), &pipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create post processing pipeline layout!");
+    }
+
+    pipeline = createPipeline(shaderCode);
+}
+
+VkPipeline PostProcess::createPipeline(const std::vector<char> &shaderCode) const
+{
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = shaderCode.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t *>(shaderCode.data());
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(device, &moduleInfo, hostAllocationCallbacks(), &shaderModule) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create post processing shader module!");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = pipelineLayout;
+    VkPipeline created;
+    VkResult result = vkCreateComputePipelines(device, pipelineCache, 1, &pipelineInfo, hostAllocationCallbacks(), &created);
+    vkDestroyShaderModule(device, shaderModule, hostAllocationCallbacks());
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create post processing pipeline!");
+    }
+    return created;
+}
+
+VkPipeline PostProcess::swapPipeline(VkPipeline newPipeline)
+{
+    VkPipeline old = pipeline;
+    pipeline = newPipeline;
+    return old;
+}
+
+void PostProcess::destroy()
+{
+    if (pipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(device, pipeline, hostAllocationCallbacks());
+        pipeline = VK_NULL_HANDLE;
+    }
+    if (pipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(device, pipelineLayout, hostAllocationCallbacks());
+        pipelineLayout = VK_NULL_HANDLE;
+    }
+    // Os conjuntos são liberados junto com o pool
+    if (descriptorPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(device, descriptorPool, hostAllocationCallbacks());
+        descriptorPool = VK_NULL_HANDLE;
+    }
+    descriptorSets.clear();
+    if (setLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(device, setLayout, hostAllocationCallbacks());
+        setLayout = VK_NULL_HANDLE;
+    }
+    if (sampler != VK_NULL_HANDLE)
+    {
+        vkDestroySampler(device, sampler, hostAllocationCallbacks());
+        sampler = VK_NULL_HANDLE;
+    }
+}
+
+void PostProcess::record(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t outputIndex,
+                         VkImageView sceneView, VkExtent2D sceneExtent, VkExtent2D sceneImageExtent,
+                         VkImageView outputView, VkExtent2D outputExtent, const PostSettings &settings)
+{
+    // As imagens (transitórias do grafo e da cadeia de troca) podem mudar a cada quadro
+    VkDescriptorSet descriptorSet = descriptorSets[frameIndex * outputCount + outputIndex];
+
+    VkDescriptorImageInfo sceneInfo{};
+    sceneInfo.imageView = sceneView;
+    sceneInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    VkDescriptorImageInfo outputInfo{};
+    outputInfo.imageView = outputView;
+    outputInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    std::array<VkWriteDescriptorSet, 2> writes{};
+    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[0].dstSet = descriptorSet;
+    writes[0].dstBinding = 0;
+    writes[0].descriptorCount = 1;
+    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writes[0].pImageInfo = &sceneInfo;
+    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[1].dstSet = descriptorSet;
+    writes[1].dstBinding = 1;
+    writes[1].descriptorCount = 1;
+    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    writes[1].pImageInfo = &outputInfo;
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    PostPushConstants pushConstants{};
+    pushConstants.outputWidth = outputExtent.width;
+    pushConstants.outputHeight = outputExtent.height;
+    pushConstants.sceneTexelWidth = 1.0f / static_cast<float>(sceneImageExtent.width);
+    pushConstants.sceneTexelHeight = 1.0f / static_cast<float>(sceneImageExtent.height);
+    pushConstants.sceneUvScaleX = static_cast<float>(sceneExtent.width) / static_cast<float>(sceneImageExtent.width);
+    pushConstants.sceneUvScaleY = static_cast<float>(sceneExtent.height) / static_cast<float>(sceneImageExtent.height);
+    pushConstants.exposure = settings.exposure;
+    pushConstants.outputEncoding = static_cast<uint32_t>(settings.encoding);
+    pushConstants.paperWhiteNits = settings.paperWhiteNits;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+    vkCmdDispatch(commandBuffer, (outputExtent.width + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE,
+                  (outputExtent.height + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1);
+}
@@ -0,0 +1,95 @@
+#include "present_policy.hpp"
+
+#include <algorithm>
+
+const char *presentPolicyName(PresentPolicy policy)
+{
+    switch (policy)
+    {
+    case PresentPolicy::Immediate:
+        return "immediate";
+    case PresentPolicy::Mailbox:
+        return "mailbox";
+    case PresentPolicy::Fifo:
+        return "fifo";
+    case PresentPolicy::FifoRelaxed:
+        return "fifo-relaxed";
+    }
+    return "unknown";
+}
+
+bool parsePresentPolicy(const std::string &name, PresentPolicy &policy)
+{
+    for (PresentPolicy candidate : {PresentPolicy::Immediate, PresentPolicy::Mailbox, PresentPolicy::Fifo, PresentPolicy::FifoRelaxed})
+    {
+        if (name == presentPolicyName(candidate))
+        {
+            policy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+PresentPolicy nextPresentPolicy(PresentPolicy policy)
+{
+    switch (policy)
+    {
+    case PresentPolicy::Immediate:
+        return PresentPolicy::Mailbox;
+    case PresentPolicy::Mailbox:
+        return PresentPolicy::Fifo;
+    case PresentPolicy::Fifo:
+        return PresentPolicy::FifoRelaxed;
+    case PresentPolicy::FifoRelaxed:
+        return PresentPolicy::Immediate;
+    }
+    return PresentPolicy::Fifo;
+}
+
+VkPresentModeKHR choosePresentMode(PresentPolicy policy, const std::vector<VkPresentModeKHR> &availableModes)
+{
+    std::vector<VkPresentModeKHR> preferred;
+    switch (policy)
+    {
+    case PresentPolicy::Immediate:
+        preferred = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR};
+        break;
+    case PresentPolicy::Mailbox:
+        preferred = {VK_PRESENT_MODE_MAILBOX_KHR};
+        break;
+    case PresentPolicy::FifoRelaxed:
+        preferred = {VK_PRESENT_MODE_FIFO_RELAXED_KHR};
+        break;
+    case PresentPolicy::Fifo:
+        break;
+    }
+
+    for (VkPresentModeKHR mode : preferred)
+    {
+        if (std::find(availableModes.begin(), availableModes.end(), mode) != availableModes.end())
+        {
+            return mode;
+        }
+    }
+
+    // FIFO é o único modo com suporte garantido pela especificação
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+const char *presentModeName(VkPresentModeKHR mode)
+{
+    switch (mode)
+    {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+        return "IMMEDIATE";
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+        return "MAILBOX";
+    case VK_PRESENT_MODE_FIFO_KHR:
+        return "FIFO";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+        return "FIFO_RELAXED";
+    default:
+        return "other";
+    }
+}
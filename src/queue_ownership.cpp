@@ -0,0 +1,112 @@
+#include "queue_ownership.hpp"
+
+#include "synchronization.hpp"
+
+void releaseBufferOwnership(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+                            uint32_t srcFamily, uint32_t dstFamily,
+                            VkPipelineStageFlags srcStage, VkAccessFlags srcAccess)
+{
+    // Mesma família: a aquisição sozinha já faz a sincronização necessária
+    if (srcFamily == dstFamily)
+    {
+        return;
+    }
+
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = 0; // Ignorado na liberação
+    barrier.srcQueueFamilyIndex = srcFamily;
+    barrier.dstQueueFamilyIndex = dstFamily;
+    barrier.buffer = buffer;
+    barrier.offset = offset;
+    barrier.size = size;
+
+    cmdPipelineBarrier(commandBuffer, srcStage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+void acquireBufferOwnership(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+                            uint32_t srcFamily, uint32_t dstFamily,
+                            VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                            VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.buffer = buffer;
+    barrier.offset = offset;
+    barrier.size = size;
+    barrier.dstAccessMask = dstAccess;
+
+    if (srcFamily == dstFamily)
+    {
+        // Barreira comum: torna visíveis as escritas gravadas antes nesta mesma fila
+        barrier.srcAccessMask = srcAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    }
+    else
+    {
+        // A disponibilidade já foi garantida pela liberação e pelo semáforo entre as submissões
+        barrier.srcAccessMask = 0;
+        barrier.srcQueueFamilyIndex = srcFamily;
+        barrier.dstQueueFamilyIndex = dstFamily;
+        srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    }
+
+    cmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+void releaseImageOwnership(VkCommandBuffer commandBuffer, VkImage image, const VkImageSubresourceRange &range,
+                           VkImageLayout oldLayout, VkImageLayout newLayout,
+                           uint32_t srcFamily, uint32_t dstFamily,
+                           VkPipelineStageFlags srcStage, VkAccessFlags srcAccess)
+{
+    if (srcFamily == dstFamily)
+    {
+        return;
+    }
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = srcFamily;
+    barrier.dstQueueFamilyIndex = dstFamily;
+    barrier.image = image;
+    barrier.subresourceRange = range;
+
+    cmdPipelineBarrier(commandBuffer, srcStage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+void acquireImageOwnership(VkCommandBuffer commandBuffer, VkImage image, const VkImageSubresourceRange &range,
+                           VkImageLayout oldLayout, VkImageLayout newLayout,
+                           uint32_t srcFamily, uint32_t dstFamily,
+                           VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                           VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.image = image;
+    barrier.subresourceRange = range;
+
+    if (srcFamily == dstFamily)
+    {
+        barrier.srcAccessMask = srcAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    }
+    else
+    {
+        barrier.srcAccessMask = 0;
+        barrier.srcQueueFamilyIndex = srcFamily;
+        barrier.dstQueueFamilyIndex = dstFamily;
+        srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    }
+
+    cmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
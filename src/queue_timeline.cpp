@@ -0,0 +1,216 @@
+#include "queue_timeline.hpp"
+
+#include "host_allocator.hpp"
+#include "synchronization.hpp"
+
+#include <stdexcept>
+
+void SubmitBatch::addCommandBuffer(VkCommandBuffer commandBuffer)
+{
+    if (commandBufferCount == MAX_COMMAND_BUFFERS)
+    {
+        throw std::runtime_error("too many command buffers in submit batch!");
+    }
+    commandBuffers[commandBufferCount++] = commandBuffer;
+}
+
+void SubmitBatch::wait(VkSemaphore semaphore, VkPipelineStageFlags stage, uint64_t value)
+{
+    if (waitCount == MAX_SEMAPHORES)
+    {
+        throw std::runtime_error("too many wait semaphores in submit batch!");
+    }
+    waitSemaphores[waitCount] = semaphore;
+    waitStages[waitCount] = stage;
+    waitValues[waitCount] = value;
+    waitCount++;
+}
+
+void SubmitBatch::wait(const QueueTimeline &timeline, uint64_t value, VkPipelineStageFlags stage)
+{
+    wait(timeline.semaphore(), stage, value);
+}
+
+void SubmitBatch::signal(VkSemaphore semaphore, uint64_t value)
+{
+    if (signalCount == MAX_SEMAPHORES)
+    {
+        throw std::runtime_error("too many signal semaphores in submit batch!");
+    }
+    signalSemaphores[signalCount] = semaphore;
+    signalValues[signalCount] = value;
+    signalCount++;
+}
+
+std::mutex &QueueLocks::get(VkQueue queue)
+{
+    for (auto &lock : locks)
+    {
+        if (lock.first == queue)
+        {
+            return *lock.second;
+        }
+    }
+    locks.emplace_back(queue, std::make_unique<std::mutex>());
+    return *locks.back().second;
+}
+
+void QueueTimeline::init(VkDevice device, VkQueue queue, std::mutex &queueMutex)
+{
+    this->device = device;
+    submitQueue = queue;
+    this->queueMutex = &queueMutex;
+    submitted.store(0);
+    completed.store(0);
+
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(device, &semaphoreInfo, hostAllocationCallbacks(), &timelineSemaphore) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create timeline semaphore!");
+    }
+}
+
+void QueueTimeline::destroy()
+{
+    if (timelineSemaphore != VK_NULL_HANDLE)
+    {
+        vkDestroySemaphore(device, timelineSemaphore, hostAllocationCallbacks());
+        timelineSemaphore = VK_NULL_HANDLE;
+    }
+}
+
+VkResult QueueTimeline::submit(SubmitBatch &batch, uint64_t &signalValue)
+{
+    std::lock_guard<std::mutex> lock(*queueMutex);
+
+    uint64_t value = submitted.load() + 1;
+    batch.signalSemaphores[batch.signalCount] = timelineSemaphore;
+    batch.signalValues[batch.signalCount] = value;
+
+    if (synchronization2Enabled())
+    {
+        return submit2(batch, value, signalValue);
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = batch.waitCount;
+    timelineInfo.pWaitSemaphoreValues = batch.waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = batch.signalCount + 1;
+    timelineInfo.pSignalSemaphoreValues = batch.signalValues.data();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = batch.waitCount;
+    submitInfo.pWaitSemaphores = batch.waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = batch.waitStages.data();
+    submitInfo.commandBufferCount = batch.commandBufferCount;
+    submitInfo.pCommandBuffers = batch.commandBuffers.data();
+    submitInfo.signalSemaphoreCount = batch.signalCount + 1;
+    submitInfo.pSignalSemaphores = batch.signalSemaphores.data();
+
+    VkResult result = vkQueueSubmit(submitQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    if (result == VK_SUCCESS)
+    {
+        submitted.store(value);
+        signalValue = value;
+    }
+    return result;
+}
+
+VkResult QueueTimeline::submit2(SubmitBatch &batch, uint64_t value, uint64_t &signalValue)
+{
+    // Os valores das linhas do tempo e os estágios de espera vão em cada VkSemaphoreSubmitInfo
+    std::array<VkSemaphoreSubmitInfo, SubmitBatch::MAX_SEMAPHORES> waitInfos{};
+    for (uint32_t i = 0; i < batch.waitCount; i++)
+    {
+        waitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        waitInfos[i].semaphore = batch.waitSemaphores[i];
+        waitInfos[i].value = batch.waitValues[i];
+        waitInfos[i].stageMask = batch.waitStages[i];
+    }
+    std::array<VkSemaphoreSubmitInfo, SubmitBatch::MAX_SEMAPHORES + 1> signalInfos{};
+    for (uint32_t i = 0; i < batch.signalCount + 1; i++)
+    {
+        signalInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        signalInfos[i].semaphore = batch.signalSemaphores[i];
+        signalInfos[i].value = batch.signalValues[i];
+        signalInfos[i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    }
+    std::array<VkCommandBufferSubmitInfo, SubmitBatch::MAX_COMMAND_BUFFERS> commandBufferInfos{};
+    for (uint32_t i = 0; i < batch.commandBufferCount; i++)
+    {
+        commandBufferInfos[i].sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+        commandBufferInfos[i].commandBuffer = batch.commandBuffers[i];
+    }
+
+    VkSubmitInfo2 submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    submitInfo.waitSemaphoreInfoCount = batch.waitCount;
+    submitInfo.pWaitSemaphoreInfos = waitInfos.data();
+    submitInfo.commandBufferInfoCount = batch.commandBufferCount;
+    submitInfo.pCommandBufferInfos = commandBufferInfos.data();
+    submitInfo.signalSemaphoreInfoCount = batch.signalCount + 1;
+    submitInfo.pSignalSemaphoreInfos = signalInfos.data();
+
+    VkResult result = vkQueueSubmit2(submitQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    if (result == VK_SUCCESS)
+    {
+        submitted.store(value);
+        signalValue = value;
+    }
+    return result;
+}
+
+void QueueTimeline::wait(uint64_t value)
+{
+    if (value <= completed.load())
+    {
+        return;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &timelineSemaphore;
+    waitInfo.pValues = &value;
+
+    if (vkWaitSemaphores(device, &waitInfo, UINT64_MAX) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to wait for timeline semaphore!");
+    }
+
+    // Outra thread pode ter lido um valor maior no meio tempo
+    uint64_t previous = completed.load();
+    while (previous < value && !completed.compare_exchange_weak(previous, value))
+    {
+    }
+}
+
+bool QueueTimeline::isComplete(uint64_t value)
+{
+    uint64_t previous = completed.load();
+    if (value <= previous)
+    {
+        return true;
+    }
+
+    uint64_t current = 0;
+    if (vkGetSemaphoreCounterValue(device, timelineSemaphore, &current) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to read timeline semaphore!");
+    }
+    while (previous < current && !completed.compare_exchange_weak(previous, current))
+    {
+    }
+    return value <= current;
+}
@@ -0,0 +1,573 @@
+#include "render_graph.hpp"
+
+#include "host_allocator.hpp"
+#include "synchronization.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+// Bits de acesso que escrevem na memória; só eles precisam ser tornados disponíveis por uma barreira
+static const VkAccessFlags WRITE_ACCESS_MASK = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                               VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                                               VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT |
+                                               VK_ACCESS_MEMORY_WRITE_BIT;
+
+struct AccessInfo
+{
+    VkPipelineStageFlags stage;
+    VkAccessFlags access;
+    VkImageLayout layout; // Ignorado por buffers
+    bool write;
+    VkImageUsageFlags usage;
+};
+
+static AccessInfo accessInfo(RenderGraph::Access access)
+{
+    switch (access)
+    {
+    case RenderGraph::Access::ColorAttachment:
+        return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT};
+    case RenderGraph::Access::DepthAttachment:
+        return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+    case RenderGraph::Access::FragmentSampled:
+        return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                false, VK_IMAGE_USAGE_SAMPLED_BIT};
+    case RenderGraph::Access::ComputeSampled:
+        return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                false, VK_IMAGE_USAGE_SAMPLED_BIT};
+    case RenderGraph::Access::ComputeStorageRead:
+        return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, false,
+                VK_IMAGE_USAGE_STORAGE_BIT};
+    case RenderGraph::Access::ComputeStorageWrite:
+        return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                VK_IMAGE_LAYOUT_GENERAL, true, VK_IMAGE_USAGE_STORAGE_BIT};
+    case RenderGraph::Access::GraphicsStorageRead:
+        return {VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                VK_IMAGE_LAYOUT_GENERAL, false, VK_IMAGE_USAGE_STORAGE_BIT};
+    case RenderGraph::Access::IndirectRead:
+        return {VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false, 0};
+    case RenderGraph::Access::TransferSrc:
+        return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, false,
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT};
+    case RenderGraph::Access::TransferDst:
+        return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true,
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT};
+    }
+    throw std::runtime_error("unknown render graph access!");
+}
+
+static VkImageAspectFlags aspectForFormat(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_D16_UNORM:
+    case VK_FORMAT_X8_D24_UNORM_PACK32:
+    case VK_FORMAT_D32_SFLOAT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+    case VK_FORMAT_D16_UNORM_S8_UINT:
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    default:
+        return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::use(Resource resource, Access access)
+{
+    graph.passes[pass].uses.push_back({resource, access});
+    return *this;
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::sideEffect()
+{
+    graph.passes[pass].sideEffect = true;
+    return *this;
+}
+
+void RenderGraph::init(VkDevice device, GpuAllocator &allocator, DeletionQueue &deletionQueue, QueueTimeline &timeline)
+{
+    this->device = device;
+    this->allocator = &allocator;
+    this->deletionQueue = &deletionQueue;
+    this->timeline = &timeline;
+}
+
+void RenderGraph::destroy()
+{
+    for (PhysicalImage &physical : physicalImages)
+    {
+        vkDestroyImageView(device, physical.view, hostAllocationCallbacks());
+        vkDestroyImage(device, physical.image, hostAllocationCallbacks());
+    }
+    for (MemorySlot &slot : slots)
+    {
+        allocator->free(slot.allocation);
+    }
+    physicalImages.clear();
+    slots.clear();
+    reset();
+}
+
+void RenderGraph::reset()
+{
+    resources.clear();
+    passes.clear();
+}
+
+RenderGraph::Resource RenderGraph::importImage(const std::string &name, VkImage image, VkImageView view,
+                                               VkImageAspectFlags aspect, const ImageState &initial,
+                                               const ImageState &final)
+{
+    ResourceEntry entry;
+    entry.name = name;
+    entry.imported = true;
+    entry.image = image;
+    entry.view = view;
+    entry.aspect = aspect;
+    entry.initial = initial;
+    entry.final = final;
+    entry.hasFinal = true;
+    resources.push_back(entry);
+    return static_cast<Resource>(resources.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::importBuffer(const std::string &name, VkBuffer buffer)
+{
+    ResourceEntry entry;
+    entry.name = name;
+    entry.isImage = false;
+    entry.imported = true;
+    entry.buffer = buffer;
+    resources.push_back(entry);
+    return static_cast<Resource>(resources.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::createImage(const std::string &name, const ImageDesc &desc)
+{
+    ResourceEntry entry;
+    entry.name = name;
+    entry.desc = desc;
+    entry.aspect = aspectForFormat(desc.format);
+    resources.push_back(entry);
+    return static_cast<Resource>(resources.size() - 1);
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(const std::string &name, ExecuteCallback execute)
+{
+    Pass pass;
+    pass.name = name;
+    pass.execute = std::move(execute);
+    passes.push_back(std::move(pass));
+    return PassBuilder(*this, static_cast<uint32_t>(passes.size() - 1));
+}
+
+void RenderGraph::compile()
+{
+    // De trás para frente: um passe vive se tiver efeito colateral ou usar um recurso que algum passe vivo posterior (ou
+    // o mundo fora do grafo, para os importados) ainda usa. Acessos de anexo e armazenamento também leem, então
+    // mantêm vivos os escritores anteriores
+    std::vector<bool> needed(resources.size(), false);
+    for (size_t i = 0; i < resources.size(); i++)
+    {
+        needed[i] = resources[i].imported;
+    }
+    for (size_t i = passes.size(); i-- > 0;)
+    {
+        Pass &pass = passes[i];
+        pass.live = pass.sideEffect;
+        for (const Use &use : pass.uses)
+        {
+            if (accessInfo(use.access).write && needed[use.resource])
+            {
+                pass.live = true;
+            }
+        }
+        if (pass.live)
+        {
+            for (const Use &use : pass.uses)
+            {
+                needed[use.resource] = true;
+            }
+        }
+    }
+
+    // Tempos de vida das transitórias, em índices de passes vivos, e as usagens que os acessos exigem
+    for (uint32_t i = 0; i < passes.size(); i++)
+    {
+        if (!passes[i].live)
+        {
+            continue;
+        }
+        for (const Use &use : passes[i].uses)
+        {
+            ResourceEntry &resource = resources[use.resource];
+            if (resource.imported)
+            {
+                continue;
+            }
+            resource.firstPass = std::min(resource.firstPass, i);
+            resource.lastPass = std::max(resource.lastPass, i);
+            resource.desc.usage |= accessInfo(use.access).usage;
+        }
+    }
+
+    std::vector<uint32_t> transients;
+    for (uint32_t i = 0; i < resources.size(); i++)
+    {
+        if (!resources[i].imported && resources[i].firstPass != UINT32_MAX)
+        {
+            transients.push_back(i);
+        }
+    }
+
+    // As imagens físicas só são recriadas quando a descrição das transitórias muda (resolução, formato, passes)
+    bool reuse = transients.size() == physicalImages.size();
+    for (size_t i = 0; reuse && i < transients.size(); i++)
+    {
+        const ResourceEntry &resource = resources[transients[i]];
+        const PhysicalImage &physical = physicalImages[i];
+        reuse = resource.desc.format == physical.desc.format && resource.desc.extent.width == physical.desc.extent.width &&
+                resource.desc.extent.height == physical.desc.extent.height &&
+                resource.desc.usage == physical.desc.usage && resource.firstPass == physical.firstPass &&
+                resource.lastPass == physical.lastPass;
+    }
+    if (!reuse)
+    {
+        releaseTransients();
+        allocateTransients(transients);
+    }
+    for (size_t i = 0; i < transients.size(); i++)
+    {
+        resources[transients[i]].physical = static_cast<uint32_t>(i);
+    }
+}
+
+void RenderGraph::allocateTransients(const std::vector<uint32_t> &transients)
+{
+    unaliasedBytes = 0;
+    for (uint32_t index : transients)
+    {
+        const ResourceEntry &resource = resources[index];
+        PhysicalImage physical;
+        physical.desc = resource.desc;
+        physical.firstPass = resource.firstPass;
+        physical.lastPass = resource.lastPass;
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = resource.desc.format;
+        imageInfo.extent = {resource.desc.extent.width, resource.desc.extent.height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = resource.desc.usage;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        if (vkCreateImage(device, &imageInfo, hostAllocationCallbacks(), &physical.image) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create render graph image " + resource.name + "!");
+        }
+        vkGetImageMemoryRequirements(device, physical.image, &physical.requirements);
+        unaliasedBytes += physical.requirements.size;
+        physicalImages.push_back(physical);
+    }
+
+    // Maiores primeiro: cada imagem entra na primeira faixa cujos ocupantes não se sobrepõem a ela no tempo
+    std::vector<uint32_t> order(physicalImages.size());
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+                     { return physicalImages[a].requirements.size > physicalImages[b].requirements.size; });
+    for (uint32_t i : order)
+    {
+        PhysicalImage &physical = physicalImages[i];
+        auto fits = [&](const MemorySlot &slot)
+        {
+            if ((slot.typeBits & physical.requirements.memoryTypeBits) == 0)
+            {
+                return false;
+            }
+            for (uint32_t other : slot.images)
+            {
+                const PhysicalImage &occupant = physicalImages[other];
+                if (physical.firstPass <= occupant.lastPass && occupant.firstPass <= physical.lastPass)
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+        auto slot = std::find_if(slots.begin(), slots.end(), fits);
+        if (slot == slots.end())
+        {
+            slot = slots.insert(slots.end(), MemorySlot{});
+        }
+        slot->size = std::max(slot->size, physical.requirements.size);
+        slot->alignment = std::max(slot->alignment, physical.requirements.alignment);
+        slot->typeBits &= physical.requirements.memoryTypeBits;
+        slot->images.push_back(i);
+        physical.slot = static_cast<uint32_t>(slot - slots.begin());
+    }
+
+    for (MemorySlot &slot : slots)
+    {
+        // O ocupante anterior do primeiro é o último do quadro anterior, que ainda pode estar em execução
+        std::sort(slot.images.begin(), slot.images.end(), [this](uint32_t a, uint32_t b)
+                  { return physicalImages[a].firstPass < physicalImages[b].firstPass; });
+        for (size_t i = 0; i < slot.images.size(); i++)
+        {
+            physicalImages[slot.images[i]].previousInSlot = slot.images[(i + slot.images.size() - 1) % slot.images.size()];
+        }
+
+        VkMemoryRequirements requirements{};
+        requirements.size = slot.size;
+        requirements.alignment = slot.alignment;
+        requirements.memoryTypeBits = slot.typeBits;
+        slot.allocation = allocator->allocate(requirements, MemoryUsage::GpuOnly, ResourceKind::Optimal);
+        for (uint32_t i : slot.images)
+        {
+            if (vkBindImageMemory(device, physicalImages[i].image, slot.allocation.memory, slot.allocation.offset) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to bind render graph image memory!");
+            }
+        }
+    }
+
+    for (PhysicalImage &physical : physicalImages)
+    {
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = physical.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = physical.desc.format;
+        viewInfo.subresourceRange.aspectMask = aspectForFormat(physical.desc.format);
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(device, &viewInfo, hostAllocationCallbacks(), &physical.view) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create render graph image view!");
+        }
+    }
+}
+
+void RenderGraph::releaseTransients()
+{
+    if (physicalImages.empty())
+    {
+        return;
+    }
+    // Quadros em voo ainda podem usar as imagens antigas
+    deletionQueue->defer(*timeline, timeline->lastSubmitted(),
+                         [device = device, allocator = allocator, images = std::move(physicalImages),
+                          memory = std::move(slots)]() mutable
+                         {
+                             for (PhysicalImage &physical : images)
+                             {
+                                 vkDestroyImageView(device, physical.view, hostAllocationCallbacks());
+                                 vkDestroyImage(device, physical.image, hostAllocationCallbacks());
+                             }
+                             for (MemorySlot &slot : memory)
+                             {
+                                 allocator->free(slot.allocation);
+                             }
+                         });
+    physicalImages.clear();
+    slots.clear();
+}
+
+void RenderGraph::transition(ResourceEntry &resource, VkImageLayout layout, VkPipelineStageFlags stage,
+                             VkAccessFlags access, bool write, std::vector<VkImageMemoryBarrier> &imageBarriers,
+                             VkMemoryBarrier &memoryBarrier, VkPipelineStageFlags &srcStages,
+                             VkPipelineStageFlags &dstStages)
+{
+    SyncState &state = resource.state;
+    bool layoutChange = resource.isImage && state.layout != layout;
+
+    VkPipelineStageFlags waitStages;
+    VkAccessFlags waitAccess = state.writeAccess;
+    if (!write && !layoutChange)
+    {
+        // Leitura depois de leitura: só espera se a última escrita ainda não estiver visível para este acesso
+        if (state.writeStages == 0 ||
+            ((state.visibleStages & stage) == stage && (state.visibleAccess & access) == access))
+        {
+            state.readStages |= stage;
+            return;
+        }
+        waitStages = state.writeStages;
+        state.visibleStages |= stage;
+        state.visibleAccess |= access;
+        state.readStages |= stage;
+    }
+    else
+    {
+        // Escritas e transições esperam a última escrita e todas as leituras feitas desde ela
+        waitStages = state.writeStages | state.readStages;
+        if (waitStages == 0 && !layoutChange)
+        {
+            state.writeStages = stage;
+            state.writeAccess = access & WRITE_ACCESS_MASK;
+            return;
+        }
+        // Uma transição também é uma escrita: leitores de outros estágios precisam esperá-la
+        state.writeStages = stage;
+        state.writeAccess = write ? access & WRITE_ACCESS_MASK : 0;
+        state.readStages = write ? 0 : stage;
+        state.visibleStages = write ? 0 : stage;
+        state.visibleAccess = write ? 0 : access;
+    }
+
+    srcStages |= waitStages != 0 ? waitStages : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    dstStages |= stage;
+    if (resource.isImage)
+    {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = waitAccess;
+        barrier.dstAccessMask = access;
+        barrier.oldLayout = state.layout;
+        barrier.newLayout = layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image(static_cast<Resource>(&resource - resources.data()));
+        barrier.subresourceRange.aspectMask = resource.aspect;
+        barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+        barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+        imageBarriers.push_back(barrier);
+        state.layout = layout;
+    }
+    else
+    {
+        // Dependências de buffers vão todas em uma barreira de memória global
+        memoryBarrier.srcAccessMask |= waitAccess;
+        memoryBarrier.dstAccessMask |= access;
+    }
+}
+
+void RenderGraph::execute(VkCommandBuffer commandBuffer)
+{
+    for (ResourceEntry &resource : resources)
+    {
+        resource.state = SyncState{};
+        if (resource.imported && resource.isImage)
+        {
+            resource.state.layout = resource.initial.layout;
+            resource.state.writeStages = resource.initial.stage;
+            resource.state.writeAccess = resource.initial.access;
+        }
+    }
+    std::vector<bool> touched(resources.size(), false);
+
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    auto flushBarriers = [&](VkMemoryBarrier &memoryBarrier, VkPipelineStageFlags srcStages, VkPipelineStageFlags dstStages)
+    {
+        bool hasMemoryBarrier = memoryBarrier.srcAccessMask != 0 || memoryBarrier.dstAccessMask != 0;
+        if (imageBarriers.empty() && !hasMemoryBarrier && srcStages == 0)
+        {
+            return;
+        }
+        cmdPipelineBarrier(commandBuffer, srcStages, dstStages != 0 ? dstStages : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT),
+                           0, hasMemoryBarrier ? 1 : 0, &memoryBarrier, 0, nullptr,
+                           static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+        imageBarriers.clear();
+    };
+
+    for (Pass &pass : passes)
+    {
+        if (!pass.live)
+        {
+            continue;
+        }
+
+        VkMemoryBarrier memoryBarrier{};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+        for (const Use &use : pass.uses)
+        {
+            ResourceEntry &resource = resources[use.resource];
+            AccessInfo info = accessInfo(use.access);
+            if (!resource.imported && !touched[use.resource])
+            {
+                // Primeiro uso de uma transitória: espera o ocupante anterior da memória e descarta o conteúdo
+                const PhysicalImage &previous = physicalImages[physicalImages[resource.physical].previousInSlot];
+                srcStages |= previous.lastUse.stage;
+                dstStages |= info.stage;
+                memoryBarrier.srcAccessMask |= previous.lastUse.access;
+                memoryBarrier.dstAccessMask |= info.access;
+            }
+            touched[use.resource] = true;
+            transition(resource, info.layout, info.stage, info.access, info.write, imageBarriers, memoryBarrier,
+                       srcStages, dstStages);
+            if (!resource.imported)
+            {
+                PhysicalImage &physical = physicalImages[resource.physical];
+                physical.lastUse.layout = resource.state.layout;
+                physical.lastUse.stage = resource.state.writeStages | resource.state.readStages;
+                physical.lastUse.access = resource.state.writeAccess;
+            }
+        }
+        flushBarriers(memoryBarrier, srcStages, dstStages);
+        pass.execute(commandBuffer);
+    }
+
+    // Deixa as imagens importadas no estado esperado depois do grafo (por exemplo PRESENT_SRC)
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    VkPipelineStageFlags srcStages = 0;
+    VkPipelineStageFlags dstStages = 0;
+    for (ResourceEntry &resource : resources)
+    {
+        if (resource.hasFinal)
+        {
+            transition(resource, resource.final.layout, resource.final.stage, resource.final.access, false,
+                       imageBarriers, memoryBarrier, srcStages, dstStages);
+        }
+    }
+    flushBarriers(memoryBarrier, srcStages, dstStages);
+}
+
+VkImage RenderGraph::image(Resource resource) const
+{
+    const ResourceEntry &entry = resources[resource];
+    return entry.imported ? entry.image : physicalImages[entry.physical].image;
+}
+
+VkImageView RenderGraph::imageView(Resource resource) const
+{
+    const ResourceEntry &entry = resources[resource];
+    return entry.imported ? entry.view : physicalImages[entry.physical].view;
+}
+
+VkBuffer RenderGraph::buffer(Resource resource) const
+{
+    return resources[resource].buffer;
+}
+
+std::string RenderGraph::describe() const
+{
+    size_t culled = std::count_if(passes.begin(), passes.end(), [](const Pass &pass) { return !pass.live; });
+    VkDeviceSize aliasedBytes = 0;
+    for (const MemorySlot &slot : slots)
+    {
+        aliasedBytes += slot.size;
+    }
+
+    std::ostringstream out;
+    out << "render graph: " << passes.size() - culled << " passes (" << culled << " culled), " << physicalImages.size()
+        << " transient images in " << slots.size() << " memory slots, " << std::fixed << std::setprecision(1)
+        << aliasedBytes / (1024.0 * 1024.0) << " MiB (" << unaliasedBytes / (1024.0 * 1024.0)
+        << " MiB without aliasing)";
+    return out.str();
+}
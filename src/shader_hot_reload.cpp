@@ -0,0 +1,287 @@
+#include "shader_hot_reload.hpp"
+
+#include "host_allocator.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// Número mágico do início de todo módulo SPIR-V
+static const uint32_t SPIRV_MAGIC = 0x07230203;
+
+static std::filesystem::file_time_type lastWriteTime(const std::string &path)
+{
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    return error ? std::filesystem::file_time_type::min() : time;
+}
+
+// Lê um módulo SPIR-V, rejeitando arquivos truncados (um editor ou compilador ainda escrevendo) ou que não sejam SPIR-V
+static std::vector<char> readSpirv(const std::string &path)
+{
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("failed to open " + path);
+    }
+
+    std::vector<char> code(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(code.data(), code.size());
+
+    uint32_t magic = 0;
+    if (!file || code.size() < sizeof(magic) || code.size() % sizeof(uint32_t) != 0)
+    {
+        throw std::runtime_error(path + " is not a complete SPIR-V module");
+    }
+    std::memcpy(&magic, code.data(), sizeof(magic));
+    if (magic != SPIRV_MAGIC)
+    {
+        throw std::runtime_error(path + " is not a SPIR-V module");
+    }
+    return code;
+}
+
+static const char *stageName(VkShaderStageFlagBits stage)
+{
+    switch (stage)
+    {
+    case VK_SHADER_STAGE_VERTEX_BIT:
+        return "vert";
+    case VK_SHADER_STAGE_FRAGMENT_BIT:
+        return "frag";
+    case VK_SHADER_STAGE_COMPUTE_BIT:
+        return "comp";
+    default:
+        return nullptr;
+    }
+}
+
+ShaderHotReload::~ShaderHotReload()
+{
+    stop();
+}
+
+void ShaderHotReload::start(VkDevice device, const std::string &compilerPath, std::chrono::milliseconds pollInterval)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running)
+    {
+        return;
+    }
+
+    this->device = device;
+    this->compilerPath = compilerPath;
+    this->pollInterval = pollInterval;
+    running = true;
+    worker = std::thread(&ShaderHotReload::workerLoop, this);
+}
+
+void ShaderHotReload::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running)
+        {
+            return;
+        }
+        running = false;
+    }
+    wake.notify_one();
+    worker.join();
+
+    // Pipelines prontos que nunca chegaram a ser usados
+    for (const Ready &pending : ready)
+    {
+        vkDestroyPipeline(device, pending.pipeline, hostAllocationCallbacks());
+    }
+    ready.clear();
+    watches.clear();
+}
+
+void ShaderHotReload::watch(const std::string &name, std::vector<ShaderFile> files, PipelineBuilder build,
+                            PipelineSwap swap)
+{
+    auto entry = std::make_unique<Watch>();
+    entry->name = name;
+    for (const ShaderFile &file : files)
+    {
+        entry->sourceTimes.push_back(file.sourcePath.empty() ? FileTime::min() : lastWriteTime(file.sourcePath));
+        entry->spirvTimes.push_back(lastWriteTime(file.spirvPath));
+    }
+    entry->files = std::move(files);
+    entry->build = std::move(build);
+    entry->swap = std::move(swap);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    watches.push_back(std::move(entry));
+}
+
+uint32_t ShaderHotReload::applyPending()
+{
+    std::vector<Ready> applied;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ready.empty())
+        {
+            return 0;
+        }
+        applied.swap(ready);
+    }
+
+    uint32_t count = 0;
+    for (const Ready &pending : applied)
+    {
+        if (pending.watch->swap(pending.pipeline))
+        {
+            std::cout << "shader reload: " << pending.watch->name << " pipeline replaced" << std::endl;
+            count++;
+        }
+        else
+        {
+            std::cout << "shader reload: " << pending.watch->name << " pipeline discarded (built for an outdated state)"
+                      << std::endl;
+        }
+    }
+    return count;
+}
+
+void ShaderHotReload::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running)
+    {
+        wake.wait_for(lock, pollInterval, [this] { return !running; });
+        if (!running)
+        {
+            break;
+        }
+
+        // Compilações e criação de pipelines podem levar centenas de milissegundos: nada disso segura o mutex
+        std::vector<Watch *> current;
+        for (const auto &entry : watches)
+        {
+            current.push_back(entry.get());
+        }
+        lock.unlock();
+        for (Watch *entry : current)
+        {
+            poll(*entry);
+        }
+        lock.lock();
+    }
+}
+
+void ShaderHotReload::poll(Watch &watch)
+{
+    // Fontes alterados são compilados primeiro; o SPIR-V gerado é detectado logo abaixo como qualquer outra mudança
+    bool compiled = true;
+    for (size_t i = 0; i < watch.files.size(); i++)
+    {
+        const ShaderFile &file = watch.files[i];
+        if (file.sourcePath.empty() || compilerPath.empty())
+        {
+            continue;
+        }
+        FileTime sourceTime = lastWriteTime(file.sourcePath);
+        if (sourceTime != watch.sourceTimes[i])
+        {
+            watch.sourceTimes[i] = sourceTime;
+            compiled = compile(file) && compiled;
+        }
+    }
+    if (!compiled)
+    {
+        return;
+    }
+
+    bool changed = false;
+    for (size_t i = 0; i < watch.files.size(); i++)
+    {
+        FileTime spirvTime = lastWriteTime(watch.files[i].spirvPath);
+        if (spirvTime != watch.spirvTimes[i])
+        {
+            watch.spirvTimes[i] = spirvTime;
+            changed = true;
+        }
+    }
+    if (!changed)
+    {
+        return;
+    }
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    try
+    {
+        std::vector<std::vector<char>> spirv;
+        for (const ShaderFile &file : watch.files)
+        {
+            spirv.push_back(readSpirv(file.spirvPath));
+        }
+        auto start = std::chrono::steady_clock::now();
+        pipeline = watch.build(spirv);
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "shader reload: " << watch.name << " pipeline rebuilt in " << milliseconds << " ms" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "shader reload: " << watch.name << ": " << e.what() << " (keeping the current pipeline)" << std::endl;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // Um pipeline pronto que ainda não foi aplicado é substituído pelo mais recente
+    for (Ready &pending : ready)
+    {
+        if (pending.watch == &watch)
+        {
+            vkDestroyPipeline(device, pending.pipeline, hostAllocationCallbacks());
+            pending.pipeline = pipeline;
+            return;
+        }
+    }
+    ready.push_back({&watch, pipeline});
+}
+
+bool ShaderHotReload::compile(const ShaderFile &file) const
+{
+    const char *stage = stageName(file.stage);
+    if (stage == nullptr)
+    {
+        std::cerr << "shader reload: unsupported shader stage for " << file.sourcePath << std::endl;
+        return false;
+    }
+
+    // HLSL passa pelo mesmo compilador; o estágio é explícito porque a extensão não o identifica
+    std::string command = "\"" + compilerPath + "\" -fshader-stage=" + stage;
+    if (std::filesystem::path(file.sourcePath).extension() == ".hlsl")
+    {
+        command += " -x hlsl -fentry-point=main";
+    }
+
+    // Compila para um arquivo temporário e renomeia, para que o SPIR-V nunca seja lido pela metade
+    const std::string tempPath = file.spirvPath + ".tmp";
+    command += " \"" + file.sourcePath + "\" -o \"" + tempPath + "\"";
+#ifdef _WIN32
+    // cmd /c remove a primeira e a última aspas da linha quando ela tem mais de um par; o par externo preserva os demais
+    command = "\"" + command + "\"";
+#endif
+
+    // As mensagens de erro do compilador vão direto para stderr
+    if (std::system(command.c_str()) != 0)
+    {
+        std::cerr << "shader reload: failed to compile " << file.sourcePath << std::endl;
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, file.spirvPath, error);
+    if (error)
+    {
+        std::cerr << "shader reload: failed to replace " << file.spirvPath << ": " << error.message() << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,422 @@
+#include "staging_ring.hpp"
+
+#include "host_allocator.hpp"
+#include "queue_ownership.hpp"
+#include "synchronization.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+void StagingRing::init(VkDevice device, GpuAllocator &allocator, VkDeviceSize capacity, uint32_t frameCount,
+                       QueueTimeline &transferTimeline, uint32_t transferFamily, uint32_t graphicsFamily)
+{
+    if (frameCount == 0 || frameCount > MAX_FRAMES)
+    {
+        throw std::runtime_error("invalid staging ring frame count!");
+    }
+
+    this->device = device;
+    this->allocator = &allocator;
+    this->transferTimeline = &transferTimeline;
+    this->transferFamily = transferFamily;
+    this->graphicsFamily = graphicsFamily;
+    this->frameCount = frameCount;
+    ringSize = capacity;
+    head = 0;
+    tail = 0;
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = capacity;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    allocator.createBuffer(bufferInfo, MemoryUsage::CpuToGpu, buffer, allocation);
+
+    if (allocation.mapped == nullptr)
+    {
+        throw std::runtime_error("staging ring memory is not host visible!");
+    }
+
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        FrameData &frame = frames[i];
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        // O pool inteiro é resetado a cada flush, então os buffers de comando são de vida curta
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = transferFamily;
+        if (vkCreateCommandPool(device, &poolInfo, hostAllocationCallbacks(), &frame.commandPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create staging command pool!");
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = frame.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(device, &allocInfo, &frame.commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate staging command buffer!");
+        }
+
+        frame.value = 0;
+        frame.head = 0;
+    }
+}
+
+void StagingRing::destroy()
+{
+    for (auto &frame : frames)
+    {
+        if (frame.commandPool != VK_NULL_HANDLE)
+        {
+            vkDestroyCommandPool(device, frame.commandPool, hostAllocationCallbacks());
+        }
+        frame = FrameData{};
+    }
+
+    if (buffer != VK_NULL_HANDLE)
+    {
+        allocator->destroyBuffer(buffer, allocation);
+        buffer = VK_NULL_HANDLE;
+    }
+
+    pendingBuffers.clear();
+    pendingImages.clear();
+    drainedBuffers.clear();
+    drainedImages.clear();
+    drainedValue = 0;
+    drainedStage = 0;
+    openReservations.clear();
+}
+
+bool StagingRing::tryAllocate(VkDeviceSize size, VkDeviceSize alignment, StagingRegion &region)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return allocateLocked(size, alignment, region);
+}
+
+bool StagingRing::allocateLocked(VkDeviceSize size, VkDeviceSize alignment, StagingRegion &region)
+{
+    if (size == 0 || size > ringSize)
+    {
+        return false;
+    }
+
+    // O alinhamento não precisa ser potência de dois (formatos de 3 bytes por texel, por exemplo)
+    alignment = std::max<VkDeviceSize>(alignment, 1);
+    uint64_t wrapBase = head - head % ringSize;
+    VkDeviceSize offset = (head % ringSize + alignment - 1) / alignment * alignment;
+    if (offset + size > ringSize)
+    {
+        // Não cabe até o fim do buffer: recomeça do início, descartando o restante da volta atual
+        wrapBase += ringSize;
+        offset = 0;
+    }
+
+    uint64_t start = wrapBase + offset;
+    if (start + size - tail > ringSize)
+    {
+        return false;
+    }
+
+    head = start + size;
+    region.data = static_cast<char *>(allocation.mapped) + offset;
+    region.offset = offset;
+    region.size = size;
+    region.position = start;
+    return true;
+}
+
+StagingRegion StagingRing::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    StagingRegion region;
+    if (!tryAllocate(size, alignment, region))
+    {
+        throw std::runtime_error("staging ring is full!");
+    }
+    return region;
+}
+
+bool StagingRing::tryReserve(VkDeviceSize size, VkDeviceSize alignment, StagingRegion &region)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!allocateLocked(size, alignment, region))
+    {
+        return false;
+    }
+    openReservations.push_back(region.position);
+    return true;
+}
+
+void StagingRing::commitImage(const StagingRegion &region, VkImage image, const std::vector<StagingImageCopy> &copies,
+                              VkImageLayout finalLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &copy : copies)
+    {
+        queueImageCopy(region, image, copy.copy, copy.range, finalLayout, dstStage, dstAccess);
+    }
+    closeReservation(region);
+}
+
+void StagingRing::cancel(const StagingRegion &region)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    closeReservation(region);
+}
+
+void StagingRing::closeReservation(const StagingRegion &region)
+{
+    auto open = std::find(openReservations.begin(), openReservations.end(), region.position);
+    if (open != openReservations.end())
+    {
+        openReservations.erase(open);
+    }
+}
+
+void StagingRing::copyToBuffer(const StagingRegion &region, VkBuffer buffer, VkDeviceSize dstOffset,
+                               VkPipelineStageFlags dstStage, VkAccessFlags dstAccess, bool concurrent)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    PendingBufferCopy pending{};
+    pending.buffer = buffer;
+    pending.copy.srcOffset = region.offset;
+    pending.copy.dstOffset = dstOffset;
+    pending.copy.size = region.size;
+    pending.dstStage = dstStage;
+    pending.dstAccess = dstAccess;
+    pending.concurrent = concurrent;
+    pendingBuffers.push_back(pending);
+}
+
+void StagingRing::copyToImage(const StagingRegion &region, VkImage image, const VkBufferImageCopy &copy,
+                              const VkImageSubresourceRange &range, VkImageLayout finalLayout,
+                              VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    queueImageCopy(region, image, copy, range, finalLayout, dstStage, dstAccess);
+}
+
+void StagingRing::queueImageCopy(const StagingRegion &region, VkImage image, const VkBufferImageCopy &copy,
+                                 const VkImageSubresourceRange &range, VkImageLayout finalLayout,
+                                 VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    PendingImageCopy pending{};
+    pending.image = image;
+    pending.copy = copy;
+    pending.copy.bufferOffset += region.offset;
+    pending.range = range;
+    pending.finalLayout = finalLayout;
+    pending.dstStage = dstStage;
+    pending.dstAccess = dstAccess;
+    pendingImages.push_back(pending);
+}
+
+void StagingRing::beginFrame()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // As cópias terminam em ordem, então tudo o que veio antes de um flush concluído também já foi consumido
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        if (frames[i].value != 0 && transferTimeline->isComplete(frames[i].value))
+        {
+            tail = std::max(tail, frames[i].head);
+        }
+    }
+}
+
+StagingFlush StagingRing::flush(uint32_t frameIndex)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // As cópias de drain já terminaram, mas as aquisições e a espera (visibilidade na fila de gráficos) ficam com este quadro
+    FrameData &frame = frames[frameIndex];
+    frame.bufferAcquires = std::move(drainedBuffers);
+    frame.imageAcquires = std::move(drainedImages);
+    drainedBuffers.clear();
+    drainedImages.clear();
+    StagingFlush result{drainedValue, drainedStage};
+    drainedValue = 0;
+    drainedStage = 0;
+
+    if (pendingBuffers.empty() && pendingImages.empty())
+    {
+        return result;
+    }
+
+    // O quadro de gráficos que esperou o flush anterior já terminou, então esta espera normalmente não bloqueia
+    transferTimeline->wait(frame.value);
+    result.waitStage |= submitPendingLocked(frame, frame.bufferAcquires, frame.imageAcquires);
+    result.value = frame.value;
+    return result;
+}
+
+void StagingRing::drain(uint32_t frameIndex)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pendingBuffers.empty() && pendingImages.empty())
+    {
+        return;
+    }
+
+    FrameData &frame = frames[frameIndex];
+    transferTimeline->wait(frame.value);
+    drainedStage |= submitPendingLocked(frame, drainedBuffers, drainedImages);
+    drainedValue = frame.value;
+
+    // Nada mais está em uso além das reservas abertas (frame.head já para na primeira delas)
+    transferTimeline->wait(frame.value);
+    tail = std::max(tail, frame.head);
+}
+
+VkPipelineStageFlags StagingRing::submitPendingLocked(FrameData &frame, std::vector<PendingBufferCopy> &bufferAcquires,
+                                                     std::vector<PendingImageCopy> &imageAcquires)
+{
+    vkResetCommandPool(device, frame.commandPool, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(frame.commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to begin recording staging command buffer!");
+    }
+
+    // Agrupa as cópias por destino para emitir um único comando de cópia por recurso
+    // (a ordenação estável preserva a ordem de escrita entre cópias para o mesmo destino)
+    std::stable_sort(pendingBuffers.begin(), pendingBuffers.end(),
+                     [](const PendingBufferCopy &a, const PendingBufferCopy &b) { return a.buffer < b.buffer; });
+    std::stable_sort(pendingImages.begin(), pendingImages.end(),
+                     [](const PendingImageCopy &a, const PendingImageCopy &b) { return a.image < b.image; });
+
+    std::vector<VkBufferCopy> bufferRegions;
+    for (size_t first = 0; first < pendingBuffers.size();)
+    {
+        size_t last = first;
+        bufferRegions.clear();
+        while (last < pendingBuffers.size() && pendingBuffers[last].buffer == pendingBuffers[first].buffer)
+        {
+            bufferRegions.push_back(pendingBuffers[last].copy);
+            last++;
+        }
+        vkCmdCopyBuffer(frame.commandBuffer, buffer, pendingBuffers[first].buffer,
+                        static_cast<uint32_t>(bufferRegions.size()), bufferRegions.data());
+        first = last;
+    }
+
+    // Imagens: todas passam para TRANSFER_DST em uma única barreira antes das cópias
+    if (!pendingImages.empty())
+    {
+        std::vector<VkImageMemoryBarrier> toTransfer;
+        for (const auto &pending : pendingImages)
+        {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = pending.image;
+            barrier.subresourceRange = pending.range;
+            toTransfer.push_back(barrier);
+        }
+        cmdPipelineBarrier(frame.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                           0, nullptr, 0, nullptr, static_cast<uint32_t>(toTransfer.size()), toTransfer.data());
+
+        std::vector<VkBufferImageCopy> imageRegions;
+        for (size_t first = 0; first < pendingImages.size();)
+        {
+            size_t last = first;
+            imageRegions.clear();
+            while (last < pendingImages.size() && pendingImages[last].image == pendingImages[first].image)
+            {
+                imageRegions.push_back(pendingImages[last].copy);
+                last++;
+            }
+            vkCmdCopyBufferToImage(frame.commandBuffer, buffer, pendingImages[first].image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                   static_cast<uint32_t>(imageRegions.size()), imageRegions.data());
+            first = last;
+        }
+    }
+
+    // Libera os destinos para a família de gráficos; a aquisição é gravada pelo quadro em recordAcquireBarriers
+    VkPipelineStageFlags waitStage = 0;
+    for (const auto &pending : pendingBuffers)
+    {
+        waitStage |= pending.dstStage;
+        if (pending.concurrent)
+        {
+            continue;
+        }
+        releaseBufferOwnership(frame.commandBuffer, pending.buffer, pending.copy.dstOffset, pending.copy.size,
+                               transferFamily, graphicsFamily, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    }
+    for (const auto &pending : pendingImages)
+    {
+        releaseImageOwnership(frame.commandBuffer, pending.image, pending.range,
+                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, pending.finalLayout,
+                              transferFamily, graphicsFamily, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        waitStage |= pending.dstStage;
+    }
+
+    if (vkEndCommandBuffer(frame.commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to record staging command buffer!");
+    }
+
+    SubmitBatch batch;
+    batch.addCommandBuffer(frame.commandBuffer);
+    if (transferTimeline->submit(batch, frame.value) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit staging copies!");
+    }
+
+    // O espaço usado até aqui volta ao anel quando a linha do tempo alcançar frame.value; uma reserva aberta ainda está
+    // sendo escrita (ou suas cópias não foram enfileiradas), então a recuperação para no início dela
+    frame.head = head;
+    for (uint64_t position : openReservations)
+    {
+        frame.head = std::min(frame.head, position);
+    }
+    bufferAcquires.insert(bufferAcquires.end(), pendingBuffers.begin(), pendingBuffers.end());
+    imageAcquires.insert(imageAcquires.end(), pendingImages.begin(), pendingImages.end());
+    pendingBuffers.clear();
+    pendingImages.clear();
+    return waitStage;
+}
+
+void StagingRing::recordAcquireBarriers(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    FrameData &frame = frames[frameIndex];
+    for (const auto &pending : frame.bufferAcquires)
+    {
+        // A espera pela linha do tempo de transferência já torna as escritas visíveis
+        if (pending.concurrent)
+        {
+            continue;
+        }
+        acquireBufferOwnership(commandBuffer, pending.buffer, pending.copy.dstOffset, pending.copy.size,
+                               transferFamily, graphicsFamily,
+                               VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                               pending.dstStage, pending.dstAccess);
+    }
+    for (const auto &pending : frame.imageAcquires)
+    {
+        acquireImageOwnership(commandBuffer, pending.image, pending.range,
+                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, pending.finalLayout,
+                              transferFamily, graphicsFamily,
+                              VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                              pending.dstStage, pending.dstAccess);
+    }
+    frame.bufferAcquires.clear();
+    frame.imageAcquires.clear();
+}
@@ -0,0 +1,45 @@
+#include "startup_timer.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+StartupTimer::Stage::~Stage()
+{
+    auto end = Clock::now();
+    Record record;
+    record.name = std::move(name);
+    record.startMilliseconds = std::chrono::duration<double, std::milli>(begin - timer.start).count();
+    record.durationMilliseconds = std::chrono::duration<double, std::milli>(end - begin).count();
+    record.worker = std::this_thread::get_id() != timer.mainThread;
+
+    std::lock_guard<std::mutex> lock(timer.mutex);
+    timer.records.push_back(std::move(record));
+}
+
+std::vector<StartupTimer::Record> StartupTimer::stages() const
+{
+    std::vector<Record> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted = records;
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Record &a, const Record &b) { return a.startMilliseconds < b.startMilliseconds; });
+    return sorted;
+}
+
+double StartupTimer::elapsedMilliseconds() const
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void StartupTimer::report(std::ostream &out) const
+{
+    out << std::fixed << std::setprecision(1) << "startup: " << elapsedMilliseconds() << " ms\n";
+    for (const Record &record : stages())
+    {
+        out << "  " << std::left << std::setw(28) << record.name << std::right << std::setw(8) << record.startMilliseconds
+            << " +" << std::setw(7) << record.durationMilliseconds << " ms" << (record.worker ? "  (worker)" : "") << "\n";
+    }
+    out << std::defaultfloat << std::flush;
+}
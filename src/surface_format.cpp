@@ -0,0 +1,170 @@
+#include "surface_format.hpp"
+
+#include <array>
+
+namespace
+{
+// Candidatos de cada nível, do preferido ao menos preferido
+const std::array<VkSurfaceFormatKHR, 4> SDR8_FORMATS = {{
+    {VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+    {VK_FORMAT_R8G8B8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+    {VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+    {VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+}};
+const std::array<VkSurfaceFormatKHR, 2> SDR10_FORMATS = {{
+    {VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+    {VK_FORMAT_A2R10G10B10_UNORM_PACK32, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+}};
+const std::array<VkSurfaceFormatKHR, 2> HDR10_FORMATS = {{
+    {VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_COLOR_SPACE_HDR10_ST2084_EXT},
+    {VK_FORMAT_A2R10G10B10_UNORM_PACK32, VK_COLOR_SPACE_HDR10_ST2084_EXT},
+}};
+const std::array<VkSurfaceFormatKHR, 1> SCRGB_FORMATS = {{
+    {VK_FORMAT_R16G16B16A16_SFLOAT, VK_COLOR_SPACE_EXTENDED_SRGB_LINEAR_EXT},
+}};
+
+template <size_t N>
+std::optional<VkSurfaceFormatKHR> findFormat(const std::array<VkSurfaceFormatKHR, N> &candidates,
+                                             const std::vector<VkSurfaceFormatKHR> &availableFormats,
+                                             const std::function<bool(VkFormat)> &accept)
+{
+    for (const auto &candidate : candidates)
+    {
+        for (const auto &available : availableFormats)
+        {
+            if (available.format == candidate.format && available.colorSpace == candidate.colorSpace &&
+                accept(available.format))
+            {
+                return available;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+const char *formatName(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_B8G8R8A8_SRGB:
+        return "B8G8R8A8_SRGB";
+    case VK_FORMAT_R8G8B8A8_SRGB:
+        return "R8G8B8A8_SRGB";
+    case VK_FORMAT_B8G8R8A8_UNORM:
+        return "B8G8R8A8_UNORM";
+    case VK_FORMAT_R8G8B8A8_UNORM:
+        return "R8G8B8A8_UNORM";
+    case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+        return "A2B10G10R10_UNORM";
+    case VK_FORMAT_A2R10G10B10_UNORM_PACK32:
+        return "A2R10G10B10_UNORM";
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+        return "R16G16B16A16_SFLOAT";
+    default:
+        return nullptr;
+    }
+}
+
+const char *colorSpaceName(VkColorSpaceKHR colorSpace)
+{
+    switch (colorSpace)
+    {
+    case VK_COLOR_SPACE_SRGB_NONLINEAR_KHR:
+        return "sRGB";
+    case VK_COLOR_SPACE_HDR10_ST2084_EXT:
+        return "HDR10 ST2084";
+    case VK_COLOR_SPACE_EXTENDED_SRGB_LINEAR_EXT:
+        return "scRGB linear";
+    default:
+        return nullptr;
+    }
+}
+} // namespace
+
+const char *surfaceFormatPolicyName(SurfaceFormatPolicy policy)
+{
+    switch (policy)
+    {
+    case SurfaceFormatPolicy::Auto:
+        return "auto";
+    case SurfaceFormatPolicy::Sdr8:
+        return "sdr8";
+    case SurfaceFormatPolicy::Sdr10:
+        return "sdr10";
+    case SurfaceFormatPolicy::Hdr10:
+        return "hdr10";
+    case SurfaceFormatPolicy::ScRgb:
+        return "scrgb";
+    }
+    return "unknown";
+}
+
+bool parseSurfaceFormatPolicy(const std::string &name, SurfaceFormatPolicy &policy)
+{
+    for (SurfaceFormatPolicy candidate : {SurfaceFormatPolicy::Auto, SurfaceFormatPolicy::Sdr8, SurfaceFormatPolicy::Sdr10,
+                                          SurfaceFormatPolicy::Hdr10, SurfaceFormatPolicy::ScRgb})
+    {
+        if (name == surfaceFormatPolicyName(candidate))
+        {
+            policy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool surfaceFormatPolicyWantsExtendedColorSpaces(SurfaceFormatPolicy policy)
+{
+    return policy == SurfaceFormatPolicy::Hdr10 || policy == SurfaceFormatPolicy::ScRgb;
+}
+
+std::optional<VkSurfaceFormatKHR> chooseSurfaceFormat(SurfaceFormatPolicy policy,
+                                                      const std::vector<VkSurfaceFormatKHR> &availableFormats,
+                                                      const std::function<bool(VkFormat)> &accept)
+{
+    std::optional<VkSurfaceFormatKHR> chosen;
+    switch (policy)
+    {
+    case SurfaceFormatPolicy::ScRgb:
+        chosen = findFormat(SCRGB_FORMATS, availableFormats, accept);
+        [[fallthrough]];
+    case SurfaceFormatPolicy::Hdr10:
+        chosen = chosen ? chosen : findFormat(HDR10_FORMATS, availableFormats, accept);
+        [[fallthrough]];
+    case SurfaceFormatPolicy::Sdr10:
+        chosen = chosen ? chosen : findFormat(SDR10_FORMATS, availableFormats, accept);
+        break;
+    case SurfaceFormatPolicy::Auto:
+    case SurfaceFormatPolicy::Sdr8:
+        // HDR só quando pedido: a saída muda de aparência com o modo do monitor e o formato pode sumir com ele. O sRGB de
+        // 10 bits também, pois algumas GPUs móveis não comprimem esses formatos
+        break;
+    }
+    return chosen ? chosen : findFormat(SDR8_FORMATS, availableFormats, accept);
+}
+
+OutputEncoding outputEncodingFor(const VkSurfaceFormatKHR &surfaceFormat)
+{
+    switch (surfaceFormat.colorSpace)
+    {
+    case VK_COLOR_SPACE_HDR10_ST2084_EXT:
+        return OutputEncoding::Pq;
+    case VK_COLOR_SPACE_EXTENDED_SRGB_LINEAR_EXT:
+        return OutputEncoding::ScRgb;
+    case VK_COLOR_SPACE_SRGB_NONLINEAR_KHR:
+        return surfaceFormat.format == VK_FORMAT_B8G8R8A8_SRGB || surfaceFormat.format == VK_FORMAT_R8G8B8A8_SRGB
+                   ? OutputEncoding::None
+                   : OutputEncoding::Srgb;
+    default:
+        // Espaços de cores desconhecidos recebem a cor como está
+        return OutputEncoding::None;
+    }
+}
+
+std::string surfaceFormatName(const VkSurfaceFormatKHR &surfaceFormat)
+{
+    const char *format = formatName(surfaceFormat.format);
+    const char *colorSpace = colorSpaceName(surfaceFormat.colorSpace);
+    return (format != nullptr ? std::string(format) : "format " + std::to_string(surfaceFormat.format)) + " / " +
+           (colorSpace != nullptr ? std::string(colorSpace) : "color space " + std::to_string(surfaceFormat.colorSpace));
+}
@@ -0,0 +1,91 @@
+#include "synchronization.hpp"
+
+#include <atomic>
+#include <vector>
+
+static std::atomic<bool> synchronization2{false};
+
+void setSynchronization2Enabled(bool enabled)
+{
+    synchronization2.store(enabled);
+}
+
+bool synchronization2Enabled()
+{
+    return synchronization2.load();
+}
+
+void cmdPipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage,
+                        VkDependencyFlags dependencyFlags,
+                        uint32_t memoryBarrierCount, const VkMemoryBarrier *memoryBarriers,
+                        uint32_t bufferBarrierCount, const VkBufferMemoryBarrier *bufferBarriers,
+                        uint32_t imageBarrierCount, const VkImageMemoryBarrier *imageBarriers)
+{
+    if (!synchronization2.load())
+    {
+        vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, dependencyFlags, memoryBarrierCount, memoryBarriers,
+                             bufferBarrierCount, bufferBarriers, imageBarrierCount, imageBarriers);
+        return;
+    }
+
+    // TOP_OF_PIPE como origem e BOTTOM_OF_PIPE como destino não esperam nem bloqueiam nada: em synchronization2 são NONE
+    VkPipelineStageFlags2 srcStage2 = srcStage == VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT ? VK_PIPELINE_STAGE_2_NONE : srcStage;
+    VkPipelineStageFlags2 dstStage2 = dstStage == VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT ? VK_PIPELINE_STAGE_2_NONE : dstStage;
+
+    std::vector<VkMemoryBarrier2> memoryBarriers2(memoryBarrierCount);
+    for (uint32_t i = 0; i < memoryBarrierCount; i++)
+    {
+        VkMemoryBarrier2 &barrier = memoryBarriers2[i];
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = srcStage2;
+        barrier.srcAccessMask = memoryBarriers[i].srcAccessMask;
+        barrier.dstStageMask = dstStage2;
+        barrier.dstAccessMask = memoryBarriers[i].dstAccessMask;
+    }
+
+    std::vector<VkBufferMemoryBarrier2> bufferBarriers2(bufferBarrierCount);
+    for (uint32_t i = 0; i < bufferBarrierCount; i++)
+    {
+        const VkBufferMemoryBarrier &source = bufferBarriers[i];
+        VkBufferMemoryBarrier2 &barrier = bufferBarriers2[i];
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        barrier.srcStageMask = srcStage2;
+        barrier.srcAccessMask = source.srcAccessMask;
+        barrier.dstStageMask = dstStage2;
+        barrier.dstAccessMask = source.dstAccessMask;
+        barrier.srcQueueFamilyIndex = source.srcQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = source.dstQueueFamilyIndex;
+        barrier.buffer = source.buffer;
+        barrier.offset = source.offset;
+        barrier.size = source.size;
+    }
+
+    std::vector<VkImageMemoryBarrier2> imageBarriers2(imageBarrierCount);
+    for (uint32_t i = 0; i < imageBarrierCount; i++)
+    {
+        const VkImageMemoryBarrier &source = imageBarriers[i];
+        VkImageMemoryBarrier2 &barrier = imageBarriers2[i];
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = srcStage2;
+        barrier.srcAccessMask = source.srcAccessMask;
+        barrier.dstStageMask = dstStage2;
+        barrier.dstAccessMask = source.dstAccessMask;
+        barrier.oldLayout = source.oldLayout;
+        barrier.newLayout = source.newLayout;
+        barrier.srcQueueFamilyIndex = source.srcQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = source.dstQueueFamilyIndex;
+        barrier.image = source.image;
+        barrier.subresourceRange = source.subresourceRange;
+    }
+
+    VkDependencyInfo dependencyInfo{};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependencyInfo.dependencyFlags = dependencyFlags;
+    dependencyInfo.memoryBarrierCount = memoryBarrierCount;
+    dependencyInfo.pMemoryBarriers = memoryBarriers2.data();
+    dependencyInfo.bufferMemoryBarrierCount = bufferBarrierCount;
+    dependencyInfo.pBufferMemoryBarriers = bufferBarriers2.data();
+    dependencyInfo.imageMemoryBarrierCount = imageBarrierCount;
+    dependencyInfo.pImageMemoryBarriers = imageBarriers2.data();
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+}
@@ -0,0 +1,464 @@
+#include "texture_streamer.hpp"
+
+#include "host_allocator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    // Sem destroy ainda poderia haver cargas em andamento, que usam os membros destruídos depois deste corpo
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    if (jobs != nullptr)
+    {
+        jobs->wait(loaders);
+    }
+}
+
+void TextureStreamer::init(VkDevice device, GpuAllocator &allocator, StagingRing &stagingRing, BindlessHeap &heap,
+                           const AssetPack &pack, VkSampler sampler, uint32_t fallbackTexture, uint32_t frameCount,
+                           uint32_t maxTextures, const Settings &settings, JobSystem &jobs)
+{
+    this->device = device;
+    this->allocator = &allocator;
+    this->stagingRing = &stagingRing;
+    this->heap = &heap;
+    this->pack = &pack;
+    this->sampler = sampler;
+    this->fallbackTexture = fallbackTexture;
+    this->maxTextures = maxTextures;
+    this->settings = settings;
+    this->jobs = &jobs;
+
+    // Tabelas escritas pela CPU a cada quadro; cada quadro em voo tem a sua, então nenhuma é alterada enquanto a GPU a lê
+    tables.resize(frameCount);
+    for (Table &table : tables)
+    {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = maxTextures * sizeof(uint32_t);
+        bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        allocator.createBuffer(bufferInfo, MemoryUsage::CpuToGpu, table.buffer, table.allocation);
+
+        auto *entries = static_cast<uint32_t *>(table.allocation.mapped);
+        std::fill(entries, entries + maxTextures, fallbackTexture);
+        table.heapIndex = heap.addStorageBuffer(table.buffer);
+    }
+
+    running = true;
+}
+
+void TextureStreamer::destroy()
+{
+    // Os trabalhos terminam depois da carga em andamento
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    jobs->wait(loaders);
+
+    for (Completed &result : completed)
+    {
+        destroyImage(result.image, result.allocation, result.view, result.heapIndex);
+    }
+    completed.clear();
+    for (Texture &texture : textures)
+    {
+        if (texture.streamed && texture.image != VK_NULL_HANDLE)
+        {
+            destroyImage(texture.image, texture.allocation, texture.view, texture.heapIndex);
+        }
+    }
+    textures.clear();
+    queue.clear();
+
+    for (Table &table : tables)
+    {
+        heap->removeStorageBuffer(table.heapIndex);
+        allocator->destroyBuffer(table.buffer, table.allocation);
+    }
+    tables.clear();
+}
+
+uint32_t TextureStreamer::addResidentTexture(uint32_t heapIndex)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (textures.size() == maxTextures)
+    {
+        throw std::runtime_error("texture streamer is full!");
+    }
+
+    Texture texture{};
+    texture.heapIndex = heapIndex;
+    textures.push_back(texture);
+    return static_cast<uint32_t>(textures.size() - 1);
+}
+
+uint32_t TextureStreamer::addStreamedTexture(uint32_t packTexture)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (textures.size() == maxTextures)
+    {
+        throw std::runtime_error("texture streamer is full!");
+    }
+
+    Texture texture{};
+    texture.streamed = true;
+    texture.packTexture = packTexture;
+    texture.record = pack->texture(packTexture);
+    texture.minResidentBase = texture.record.mipLevels - 1;
+    for (uint32_t level = 0; level < texture.record.mipLevels; level++)
+    {
+        if (std::max(texture.record.width >> level, texture.record.height >> level) <= MIN_RESIDENT_SIZE)
+        {
+            texture.minResidentBase = level;
+            break;
+        }
+    }
+    // Uma carga precisa caber em uma reserva do anel; mips maiores que metade dele nunca são pedidos
+    while (texture.finestBase < texture.minResidentBase &&
+           uploadSize(texture.record, packTexture, texture.finestBase) > stagingRing->capacity() / 2)
+    {
+        texture.finestBase++;
+    }
+    texture.targetBase = texture.minResidentBase;
+    texture.residentBase = texture.record.mipLevels;
+    textures.push_back(texture);
+    return static_cast<uint32_t>(textures.size() - 1);
+}
+
+void TextureStreamer::request(uint32_t texture, float screenSize)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    textures[texture].screenSize = std::max(textures[texture].screenSize, screenSize);
+}
+
+VkDeviceSize TextureStreamer::uploadSize(const AssetTextureRecord &record, uint32_t packTexture, uint32_t base) const
+{
+    VkDeviceSize size = 0;
+    for (uint32_t level = base; level < record.mipLevels; level++)
+    {
+        size = alignUp(size, ASSET_PACK_ALIGNMENT) + pack->mip(packTexture, level).dataSize;
+    }
+    return size;
+}
+
+VkDeviceSize TextureStreamer::residentSize(const Texture &texture, uint32_t base) const
+{
+    VkDeviceSize size = 0;
+    for (uint32_t level = base; level < texture.record.mipLevels; level++)
+    {
+        size += pack->mip(texture.packTexture, level).dataSize;
+    }
+    return size;
+}
+
+void TextureStreamer::update(uint32_t frameIndex, QueueTimeline &graphicsTimeline, DeletionQueue &deletionQueue)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (loadError)
+    {
+        std::rethrow_exception(std::exchange(loadError, nullptr));
+    }
+    // As cópias dos quadros anteriores liberam espaço no anel a cada quadro
+    ringFull = false;
+
+    // Troca as imagens das cargas concluídas; as antigas ainda podem ser lidas pelos quadros em voo
+    for (Completed &result : completed)
+    {
+        Texture &texture = textures[result.texture];
+        if (texture.image != VK_NULL_HANDLE)
+        {
+            counters.residentBytes -= texture.allocation.size;
+            deletionQueue.defer(graphicsTimeline, graphicsTimeline.lastSubmitted(),
+                                [this, image = texture.image, allocation = texture.allocation, view = texture.view,
+                                 heapIndex = texture.heapIndex]() mutable
+                                { destroyImage(image, allocation, view, heapIndex); });
+        }
+        (result.base < texture.residentBase ? counters.loads : counters.evictions)++;
+        texture.image = result.image;
+        texture.allocation = result.allocation;
+        texture.view = result.view;
+        texture.heapIndex = result.heapIndex;
+        texture.residentBase = result.base;
+        counters.residentBytes += result.allocation.size;
+    }
+    completed.clear();
+
+    // Orçamento: a parte livre do heap (descontado o que outros recursos e processos já usam) ou o valor fixado
+    VkDeviceSize budget = settings.budgetBytes;
+    if (budget == 0)
+    {
+        GpuMemoryBudget heapBudget = allocator->deviceLocalBudget();
+        VkDeviceSize otherUsage = heapBudget.usage > counters.residentBytes ? heapBudget.usage - counters.residentBytes : 0;
+        budget = heapBudget.budget > otherUsage
+                     ? static_cast<VkDeviceSize>((heapBudget.budget - otherUsage) * settings.budgetFraction)
+                     : 0;
+    }
+    counters.budgetBytes = budget;
+
+    // As caudas de mips são sempre carregadas; o restante do orçamento vai para as texturas maiores na tela
+    std::vector<uint32_t> order;
+    VkDeviceSize remaining = budget;
+    for (uint32_t i = 0; i < textures.size(); i++)
+    {
+        Texture &texture = textures[i];
+        if (!texture.streamed)
+        {
+            continue;
+        }
+        texture.priority = texture.screenSize;
+        texture.screenSize = 0.0f;
+        VkDeviceSize tail = residentSize(texture, texture.minResidentBase);
+        remaining = remaining > tail ? remaining - tail : 0;
+        order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [this](uint32_t a, uint32_t b) { return textures[a].priority > textures[b].priority; });
+
+    bool overBudget = counters.residentBytes > budget;
+    for (uint32_t i : order)
+    {
+        Texture &texture = textures[i];
+
+        // Mip cujo tamanho mais se aproxima do tamanho na tela, sem ficar menor que ele
+        uint32_t desired = texture.minResidentBase;
+        if (texture.priority > 0.0f)
+        {
+            float ratio = std::max(texture.record.width, texture.record.height) / texture.priority;
+            uint32_t level = ratio > 1.0f ? static_cast<uint32_t>(std::floor(std::log2(ratio))) : 0;
+            desired = std::clamp(level, texture.finestBase, texture.minResidentBase);
+        }
+
+        uint32_t base = texture.minResidentBase;
+        while (base > desired)
+        {
+            VkDeviceSize extra = pack->mip(texture.packTexture, base - 1).dataSize;
+            if (extra > remaining)
+            {
+                break;
+            }
+            remaining -= extra;
+            base--;
+        }
+
+        // Mips já carregados só são descartados quando o orçamento estoura, para não oscilar com a câmera
+        if (!overBudget && texture.residentBase < base)
+        {
+            base = texture.residentBase;
+        }
+        texture.targetBase = base;
+
+        if (texture.targetBase != texture.residentBase && !texture.queued && !texture.loading)
+        {
+            texture.queued = true;
+            queue.push_back(i);
+        }
+    }
+
+    // Um trabalho por carga simultânea, até o tamanho da fila; os que já estão rodando continuam atendendo a fila
+    while (activeLoaders < settings.loadJobs && activeLoaders < queue.size())
+    {
+        activeLoaders++;
+        jobs->run([this] { loadQueued(); }, &loaders, JobPriority::Background);
+    }
+
+    // Tabela deste quadro: texturas sem mips residentes apontam para a textura substituta
+    auto *entries = static_cast<uint32_t *>(tables[frameIndex].allocation.mapped);
+    for (uint32_t i = 0; i < textures.size(); i++)
+    {
+        const Texture &texture = textures[i];
+        bool resident = !texture.streamed || texture.residentBase < texture.record.mipLevels;
+        entries[i] = resident ? texture.heapIndex : fallbackTexture;
+    }
+}
+
+void TextureStreamer::loadQueued()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running && !ringFull && !queue.empty())
+    {
+        auto next = std::max_element(queue.begin(), queue.end(), [this](uint32_t a, uint32_t b)
+                                     { return textures[a].priority < textures[b].priority; });
+        uint32_t id = *next;
+        queue.erase(next);
+
+        Texture &texture = textures[id];
+        texture.queued = false;
+        // A meta pode ter mudado desde que a textura entrou na fila
+        if (texture.targetBase == texture.residentBase)
+        {
+            continue;
+        }
+        texture.loading = true;
+        uint32_t base = texture.targetBase;
+        AssetTextureRecord record = texture.record;
+        uint32_t packTexture = texture.packTexture;
+
+        lock.unlock();
+        Completed result{};
+        result.texture = id;
+        LoadResult loadResult = LoadResult::Failed;
+        std::exception_ptr error;
+        try
+        {
+            loadResult = load(record, packTexture, base, result);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        Texture &loaded = textures[id];
+        loaded.loading = false;
+        if (error)
+        {
+            // Relançada por update, na thread de renderização
+            loadError = loadError ? loadError : error;
+            break;
+        }
+        switch (loadResult)
+        {
+        case LoadResult::Loaded:
+            completed.push_back(result);
+            break;
+        case LoadResult::RetryNextFrame:
+            // O anel só libera espaço quando as cópias de quadros anteriores terminam
+            loaded.queued = true;
+            queue.push_back(id);
+            ringFull = true;
+            break;
+        case LoadResult::Failed:
+            // Degrada em vez de falhar: a textura fica com o que já tem e não tenta mais esta resolução
+            loaded.finestBase = std::min(base + 1, loaded.minResidentBase);
+            counters.failures++;
+            break;
+        }
+    }
+    activeLoaders--;
+}
+
+TextureStreamer::LoadResult TextureStreamer::load(const AssetTextureRecord &record, uint32_t packTexture,
+                                                  uint32_t base, Completed &result)
+{
+    // Uma única reserva para todos os mips, aberta enquanto esta thread escreve: o flush do quadro não a recupera antes de
+    // as cópias serem enfileiradas
+    StagingRegion region;
+    if (!stagingRing->tryReserve(uploadSize(record, packTexture, base), ASSET_PACK_ALIGNMENT, region))
+    {
+        return LoadResult::RetryNextFrame;
+    }
+
+    uint32_t levelCount = record.mipLevels - base;
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = static_cast<VkFormat>(record.format);
+    imageInfo.extent = {std::max(record.width >> base, 1u), std::max(record.height >> base, 1u), 1};
+    imageInfo.mipLevels = levelCount;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    try
+    {
+        allocator->createImage(imageInfo, MemoryUsage::GpuOnly, result.image, result.allocation);
+    }
+    catch (const std::runtime_error &)
+    {
+        // O espaço reservado no anel volta com os próximos flushes
+        stagingRing->cancel(region);
+        return LoadResult::Failed;
+    }
+
+    // A leitura da memória mapeada é o que dispara a E/S do arquivo, nesta thread
+    std::vector<StagingImageCopy> copies;
+    VkDeviceSize offset = 0;
+    for (uint32_t level = base; level < record.mipLevels; level++)
+    {
+        const AssetMipRecord &mip = pack->mip(packTexture, level);
+        offset = alignUp(offset, ASSET_PACK_ALIGNMENT);
+        std::memcpy(static_cast<char *>(region.data) + offset, pack->data(mip.dataOffset), static_cast<size_t>(mip.dataSize));
+
+        StagingImageCopy copy{};
+        copy.range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copy.range.baseMipLevel = level - base;
+        copy.range.levelCount = 1;
+        copy.range.layerCount = 1;
+        copy.copy.bufferOffset = offset;
+        copy.copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copy.copy.imageSubresource.mipLevel = level - base;
+        copy.copy.imageSubresource.layerCount = 1;
+        copy.copy.imageExtent = {mip.width, mip.height, 1};
+        copies.push_back(copy);
+        offset += mip.dataSize;
+    }
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = result.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = imageInfo.format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = levelCount;
+    viewInfo.subresourceRange.layerCount = 1;
+    if (vkCreateImageView(device, &viewInfo, hostAllocationCallbacks(), &result.view) != VK_SUCCESS)
+    {
+        // Nenhuma cópia foi enfileirada para a imagem, então ela pode ser destruída já
+        stagingRing->cancel(region);
+        allocator->destroyImage(result.image, result.allocation);
+        throw std::runtime_error("failed to create streamed texture image view!");
+    }
+    stagingRing->commitImage(region, result.image, copies, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+    result.heapIndex = heap->addTexture(result.view, sampler);
+    result.base = base;
+    return LoadResult::Loaded;
+}
+
+void TextureStreamer::destroyImage(VkImage image, GpuAllocation &allocation, VkImageView view, uint32_t heapIndex)
+{
+    heap->removeTexture(heapIndex);
+    vkDestroyImageView(device, view, hostAllocationCallbacks());
+    allocator->destroyImage(image, allocation);
+}
+
+TextureStreamer::Stats TextureStreamer::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = counters;
+    result.pending = static_cast<uint32_t>(queue.size());
+    for (const Texture &texture : textures)
+    {
+        result.pending += texture.loading ? 1 : 0;
+    }
+    return result;
+}
+
+std::string TextureStreamer::describe() const
+{
+    Stats current = stats();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << "streaming: " << current.residentBytes / (1024.0 * 1024.0)
+        << " MiB resident of " << current.budgetBytes / (1024.0 * 1024.0) << " MiB budget, " << current.loads
+        << " loads, " << current.evictions << " evictions, " << current.failures << " failed";
+    return out.str();
+}